@@ -101,6 +101,18 @@ void sq_setnativedebughook(HSQUIRRELVM v,SQDEBUGHOOK hook)
     v->_debughook = hook?true:false;
 }
 
+void sq_setsamplehook(HSQUIRRELVM v,SQSAMPLEHOOK hook,SQUserPointer up)
+{
+    _ss(v)->_samplehook = hook;
+    _ss(v)->_sampleup = up;
+    _ss(v)->_samplepending = false;
+}
+
+void sq_requestsample(HSQUIRRELVM v)
+{
+    _ss(v)->_samplepending.store(true, std::memory_order_relaxed);
+}
+
 void sq_setdebughook(HSQUIRRELVM v)
 {
     SQObject o = stack_get(v,-1);
@@ -500,6 +512,22 @@ SQRESULT sq_getclosurename(HSQUIRRELVM v,SQInteger idx)
     return SQ_OK;
 }
 
+SQRESULT sq_getclosuresource(HSQUIRRELVM v,SQInteger idx)
+{
+    SQObjectPtr &o = stack_get(v,idx);
+    if(!sq_isnativeclosure(o) &&
+        !sq_isclosure(o))
+        return sq_throwerror(v,_SC("the target is not a closure"));
+    if(sq_isnativeclosure(o))
+    {
+        v->PushNull();
+    }
+    else { //closure
+        v->Push(_closure(o)->_function->_sourcename);
+    }
+    return SQ_OK;
+}
+
 SQRESULT sq_setclosureroot(HSQUIRRELVM v,SQInteger idx)
 {
     SQObjectPtr &c = stack_get(v,idx);
@@ -797,6 +825,20 @@ SQRESULT sq_setinstanceup(HSQUIRRELVM v, SQInteger idx, SQUserPointer p)
     return SQ_OK;
 }
 
+SQRESULT sq_setclassaccessors(HSQUIRRELVM v,SQInteger idx)
+{
+    sq_aux_paramscheck(v, 3);
+    SQObjectPtr &o = stack_get(v,idx);
+    if(type(o) != OT_CLASS) return sq_throwerror(v,_SC("the object is not a class"));
+    SQObjectPtr &getters = stack_get(v,-2);
+    SQObjectPtr &setters = stack_get(v,-1);
+    if((!sq_istable(getters) && !sq_isnull(getters)) || (!sq_istable(setters) && !sq_isnull(setters)))
+        return sq_throwerror(v,_SC("the accessors must be tables or null"));
+    _class(o)->SetAccessors(getters,setters);
+    v->Pop(2);
+    return SQ_OK;
+}
+
 SQRESULT sq_setclassudsize(HSQUIRRELVM v, SQInteger idx, SQInteger udsize)
 {
     SQObjectPtr &o = stack_get(v,idx);
@@ -1285,6 +1327,65 @@ SQRESULT sq_resurrectunreachable(HSQUIRRELVM v)
 #endif
 }
 
+SQRESULT sq_walkheap(HSQUIRRELVM v,SQHEAPWALKHOOK hook,SQUserPointer up)
+{
+#ifndef NO_GARBAGE_COLLECTOR
+    SQSharedState *ss = _ss(v);
+    SQHeapObjectInfo info;
+    for(SQCollectable *c = ss->_gc_chain; c; c = c->_next) {
+        memset(&info, 0, sizeof(info));
+        info.type = c->GetType();
+        info.count = 1;
+        info.object = c;
+        switch(info.type) {
+        case OT_TABLE: info.size = ((SQTable *)c)->MemSize(); break;
+        case OT_ARRAY: info.size = sizeof(SQArray) + (((SQArray *)c)->_values.capacity() * sizeof(SQObjectPtr)); break;
+        case OT_CLOSURE: {
+            SQFunctionProto *f = ((SQClosure *)c)->_function;
+            info.size = _CALC_CLOSURE_SIZE(f);
+            if(sq_type(f->_sourcename) == OT_STRING) info.source = _stringval(f->_sourcename);
+            } break;
+        case OT_NATIVECLOSURE: info.size = _CALC_NATVIVECLOSURE_SIZE(((SQNativeClosure *)c)->_noutervalues); break;
+        case OT_FUNCPROTO: {
+            SQFunctionProto *f = (SQFunctionProto *)c;
+            info.size = _FUNC_SIZE(f->_ninstructions,f->_nliterals,f->_nparameters,f->_nfunctions,
+                                   f->_noutervalues,f->_nlineinfos,f->_nlocalvarinfos,f->_ndefaultparams);
+            if(sq_type(f->_sourcename) == OT_STRING) info.source = _stringval(f->_sourcename);
+            } break;
+        case OT_CLASS: {
+            SQClass *k = (SQClass *)c;
+            info.size = sizeof(SQClass) + ((k->_defaultvalues.capacity() + k->_methods.capacity()) * sizeof(SQClassMember));
+            info.typetag = k->_typetag;
+            } break;
+        case OT_INSTANCE: {
+            SQInstance *i = (SQInstance *)c;
+            info.size = i->_memsize;
+            info.owner = i->_class;
+            info.typetag = i->_class->_typetag;
+            } break;
+        case OT_GENERATOR: info.size = sizeof(SQGenerator) + (((SQGenerator *)c)->_stack.capacity() * sizeof(SQObjectPtr)); break;
+        case OT_USERDATA: info.size = sq_aligning(sizeof(SQUserData)) + ((SQUserData *)c)->_size; break;
+        case OT_OUTER: info.size = sizeof(SQOuter); break;
+        case OT_THREAD: {
+            SQVM *t = (SQVM *)c;
+            info.size = sizeof(SQVM) + (t->_stack.capacity() * sizeof(SQObjectPtr)) + (t->_alloccallsstacksize * sizeof(SQVM::CallInfo));
+            } break;
+        default: break;
+        }
+        hook(&info, up);
+    }
+    /* strings are not collectable, report them all at once */
+    memset(&info, 0, sizeof(info));
+    info.type = OT_STRING;
+    info.count = ss->_stringtable->Count();
+    info.size = ss->_stringtable->MemSize();
+    hook(&info, up);
+    return SQ_OK;
+#else
+    return sq_throwerror(v,_SC("sq_walkheap requires a garbage collector build"));
+#endif
+}
+
 SQInteger sq_collectgarbage(HSQUIRRELVM v)
 {
 #ifndef NO_GARBAGE_COLLECTOR
@@ -24,6 +24,8 @@ SQClass::SQClass(SQSharedState *ss,SQClass *base)
         _defaultvalues.copy(base->_defaultvalues);
         _methods.copy(base->_methods);
         _COPY_VECTOR(_metamethods,base->_metamethods,MT_LAST);
+        _getters = base->_getters;
+        _setters = base->_setters;
         __ObjAddRef(_base);
     }
     _members = base?base->_members->Clone() : SQTable::Create(ss,0);
@@ -31,10 +33,13 @@ SQClass::SQClass(SQSharedState *ss,SQClass *base)
 
     INIT_CHAIN();
     ADD_TO_CHAIN(&_sharedstate->_gc_chain, this);
+    Invalidate();
 }
 
 void SQClass::Finalize() {
     _attributes.Null();
+    _getters.Null();
+    _setters.Null();
     _NULL_SQOBJECT_VECTOR(_defaultvalues,_defaultvalues.size());
     _methods.resize(0);
     _NULL_SQOBJECT_VECTOR(_metamethods,MT_LAST);
@@ -44,6 +49,12 @@ void SQClass::Finalize() {
     }
 }
 
+//gives the class a new id so the inline caches resolve its members again
+void SQClass::Invalidate()
+{
+    _cacheid = ++_sharedstate->_classcacheid;
+}
+
 SQClass::~SQClass()
 {
     REMOVE_FROM_CHAIN(&_sharedstate->_gc_chain, this);
@@ -56,6 +67,7 @@ bool SQClass::NewSlot(SQSharedState *ss,const SQObjectPtr &key,const SQObjectPtr
     bool belongs_to_static_table = type(val) == OT_CLOSURE || type(val) == OT_NATIVECLOSURE || bstatic;
     if(_locked && !belongs_to_static_table)
         return false; //the class already has an instance so cannot be modified
+    Invalidate();
     if(_members->Get(key,temp) && _isfield(temp)) //overrides the default value
     {
         _defaultvalues[_member_idx(temp)].val = val;
@@ -66,6 +78,9 @@ bool SQClass::NewSlot(SQSharedState *ss,const SQObjectPtr &key,const SQObjectPtr
         if((type(val) == OT_CLOSURE || type(val) == OT_NATIVECLOSURE) &&
             (mmidx = ss->GetMetaMethodIdxByName(key)) != -1) {
             _metamethods[mmidx] = val;
+            //a new _get or _set replaces the accessors
+            if(mmidx == MT_GET) _getters.Null();
+            else if(mmidx == MT_SET) _setters.Null();
         }
         else {
             SQObjectPtr theval = val;
@@ -20,6 +20,8 @@ typedef sqvector<SQClassMember> SQClassMemberVec;
 
 #define _ismethod(o) (_integer(o)&MEMBER_TYPE_METHOD)
 #define _isfield(o) (_integer(o)&MEMBER_TYPE_FIELD)
+#define MEMBER_TYPE_ACCESSOR 0x04000000 /* only used by the inline caches, never stored in _members */
+
 #define _make_method_idx(i) ((SQInteger)(MEMBER_TYPE_METHOD|i))
 #define _make_field_idx(i) ((SQInteger)(MEMBER_TYPE_FIELD|i))
 #define _member_type(o) (_integer(o)&0xFF000000)
@@ -57,6 +59,12 @@ public:
         }
         return false;
     }
+    void SetAccessors(const SQObjectPtr &getters,const SQObjectPtr &setters) {
+        _getters = getters;
+        _setters = setters;
+        Invalidate();
+    }
+    void Invalidate();
     bool SetAttributes(const SQObjectPtr &key,const SQObjectPtr &val);
     bool GetAttributes(const SQObjectPtr &key,SQObjectPtr &outval);
     void Lock() { _locked = true; if(_base) _base->Lock(); }
@@ -77,6 +85,9 @@ public:
     SQClassMemberVec _methods;
     SQObjectPtr _metamethods[MT_LAST];
     SQObjectPtr _attributes;
+    SQObjectPtr _getters; //table of native accessors called before _get
+    SQObjectPtr _setters; //table of native accessors called before _set
+    SQUnsignedInteger _cacheid;
     SQUserPointer _typetag;
     SQRELEASEHOOK _hook;
     bool _locked;
@@ -48,6 +48,14 @@ struct SQLocalVarInfo
 
 struct SQLineInfo { SQInteger _line;SQInteger _op; };
 
+//member of a class resolved by a get or set instruction
+struct SQInlineCache
+{
+    SQObjectPtr _key;
+    SQUnsignedInteger _classid; //SQClass::_cacheid when the member was resolved
+    SQInteger _member; //member index or MEMBER_TYPE_ACCESSOR
+};
+
 typedef sqvector<SQOuterVar> SQOuterVarVec;
 typedef sqvector<SQLocalVarInfo> SQLocalVarInfoVec;
 typedef sqvector<SQLineInfo> SQLineInfoVec;
@@ -106,18 +114,26 @@ public:
         _DESTRUCT_VECTOR(SQOuterVar,_noutervalues,_outervalues);
         //_DESTRUCT_VECTOR(SQLineInfo,_nlineinfos,_lineinfos); //not required are 2 integers
         _DESTRUCT_VECTOR(SQLocalVarInfo,_nlocalvarinfos,_localvarinfos);
+        ReleaseInlineCaches();
         SQInteger size = _FUNC_SIZE(_ninstructions,_nliterals,_nparameters,_nfunctions,_noutervalues,_nlineinfos,_nlocalvarinfos,_ndefaultparams);
         this->~SQFunctionProto();
         sq_vm_free(this,size);
     }
 
+    //the caches are only allocated for functions that access the members of instances
+    SQInlineCache &GetInlineCache(const SQInstruction *i) {
+        if(!_inlinecaches) CreateInlineCaches();
+        return _inlinecaches[i - _instructions];
+    }
+    void CreateInlineCaches();
+    void ReleaseInlineCaches();
     const SQChar* GetLocal(SQVM *v,SQUnsignedInteger stackbase,SQUnsignedInteger nseq,SQUnsignedInteger nop);
     SQInteger GetLine(SQInstruction *curr);
     bool Save(SQVM *v,SQUserPointer up,SQWRITEFUNC write);
     static bool Load(SQVM *v,SQUserPointer up,SQREADFUNC read,SQObjectPtr &ret);
 #ifndef NO_GARBAGE_COLLECTOR
     void Mark(SQCollectable **chain);
-    void Finalize(){ _NULL_SQOBJECT_VECTOR(_literals,_nliterals); }
+    void Finalize(){ _NULL_SQOBJECT_VECTOR(_literals,_nliterals); ReleaseInlineCaches(); }
     SQObjectType GetType() {return OT_FUNCPROTO;}
 #endif
     SQObjectPtr _sourcename;
@@ -125,6 +141,8 @@ public:
     SQInteger _stacksize;
     bool _bgenerator;
     SQInteger _varparams;
+    SQInteger _memtag; /* memory tag that was current when the function was created */
+    SQInlineCache *_inlinecaches; /* one for each instruction, allocated on first use */
 
     SQInteger _nlocalvarinfos;
     SQLocalVarInfo *_localvarinfos;
@@ -3,9 +3,339 @@
 */
 #include "sqpcheader.h"
 #ifndef SQ_EXCLUDE_DEFAULT_MEMFUNCTIONS
-void *sq_vm_malloc(SQUnsignedInteger size){ return malloc(size); }
+#include <new>
+#include <mutex>
+#include <atomic>
 
-void *sq_vm_realloc(void *p, SQUnsignedInteger SQ_UNUSED_ARG(oldsize), SQUnsignedInteger size){ return realloc(p, size); }
+/*
+    segregated size-class pool for the small blocks that the vm allocates all the time (tables,
+    closures, strings, instances). the vm always passes the size of a block when it is freed or
+    reallocated so blocks don't need a header. larger blocks go straight to malloc.
+    each thread keeps its own freelists and exchanges blocks with a shared depot in batches: a
+    thread takes a batch when its list is empty and gives one back when it holds more than two.
+    the chunks are kept until the process exits and a block always stays in the same size class.
+    when tagging is enabled every block gets a small header with the tag that was current when
+    it was allocated, so the host can attribute the live bytes to scripts.
+*/
+
+#define SQ_MEMPOOL_MAX_SIZE     512
+#define SQ_MEMPOOL_CHUNK_SIZE   (64*1024)
+#define SQ_MEMPOOL_BATCH        64
+#define SQ_MEMTAG_HEADER        16
+
+static const SQUnsignedInteger _class_size[SQ_MEMPOOL_CLASSES] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512
+};
+
+struct SQMemBlock { SQMemBlock *_next; };
+
+struct SQMemList {
+    SQMemBlock *_head;
+    SQUnsignedInteger _count;
+};
+
+struct SQMemCounters {
+    SQInteger _live;
+    SQInteger _peak;
+    SQInteger _blocks[SQ_MEMPOOL_CLASSES];
+    SQInteger _large;
+    SQInteger _tags[SQ_MEMTAG_MAX];
+};
+
+struct SQMemDepot {
+    std::mutex _lock;
+    SQMemList _free[SQ_MEMPOOL_CLASSES];
+    SQMemBlock *_chunks;
+    SQUnsignedInteger _reserved;
+    SQMemCounters _stats; /* counters of the threads that already exited */
+};
+
+static std::atomic<bool> _pool_enabled(false);
+static std::atomic<bool> _pool_used(false);
+static std::atomic<bool> _tag_enabled(false);
+
+static SQMemDepot &_depot()
+{
+    static SQMemDepot *d = new SQMemDepot(); /* never destroyed, threads may exit after static destructors */
+    return *d;
+}
+
+static inline SQInteger _size_class(SQUnsignedInteger size)
+{
+    if(size <= 128) return size ? (SQInteger)((size - 1) >> 4) : 0;
+    if(size <= 256) return 8 + (SQInteger)((size - 129) >> 5);
+    return 12 + (SQInteger)((size - 257) >> 6);
+}
+
+struct SQMemCache {
+    SQMemList _free[SQ_MEMPOOL_CLASSES];
+    SQMemCounters _stats;
+    SQInteger _tag; /* tag of the blocks allocated by this thread */
+    SQMemCache() : _tag(0) { memset(_free, 0, sizeof(_free)); memset(&_stats, 0, sizeof(_stats)); }
+    ~SQMemCache()
+    {
+        /* give everything back so other threads can reuse the blocks */
+        SQMemDepot &d = _depot();
+        std::lock_guard<std::mutex> guard(d._lock);
+        for(SQInteger i = 0; i < SQ_MEMPOOL_CLASSES; i++) {
+            while(_free[i]._head) {
+                SQMemBlock *b = _free[i]._head;
+                _free[i]._head = b->_next;
+                b->_next = d._free[i]._head;
+                d._free[i]._head = b;
+                d._free[i]._count++;
+            }
+            d._stats._blocks[i] += _stats._blocks[i];
+        }
+        for(SQInteger i = 0; i < SQ_MEMTAG_MAX; i++) d._stats._tags[i] += _stats._tags[i];
+        d._stats._live += _stats._live;
+        d._stats._large += _stats._large;
+        if(_stats._peak > d._stats._peak) d._stats._peak = _stats._peak;
+    }
+    void drain(SQInteger c)
+    {
+        SQMemDepot &d = _depot();
+        std::lock_guard<std::mutex> guard(d._lock);
+        /* give a batch back so that other threads and later bursts can reuse the blocks */
+        for(SQInteger n = 0; n < SQ_MEMPOOL_BATCH && _free[c]._head; n++) {
+            SQMemBlock *b = _free[c]._head;
+            _free[c]._head = b->_next;
+            _free[c]._count--;
+            b->_next = d._free[c]._head;
+            d._free[c]._head = b;
+            d._free[c]._count++;
+        }
+    }
+    void refill(SQInteger c)
+    {
+        SQMemDepot &d = _depot();
+        std::lock_guard<std::mutex> guard(d._lock);
+        /* take a batch of blocks released by other threads */
+        for(SQInteger n = 0; n < SQ_MEMPOOL_BATCH && d._free[c]._head; n++) {
+            SQMemBlock *b = d._free[c]._head;
+            d._free[c]._head = b->_next;
+            d._free[c]._count--;
+            b->_next = _free[c]._head;
+            _free[c]._head = b;
+            _free[c]._count++;
+        }
+        if(_free[c]._head) return;
+        /* carve a new chunk, the first block links the chunks together */
+        SQMemBlock *chunk = (SQMemBlock *)malloc(SQ_MEMPOOL_CHUNK_SIZE);
+        if(!chunk) return;
+        chunk->_next = d._chunks;
+        d._chunks = chunk;
+        d._reserved += SQ_MEMPOOL_CHUNK_SIZE;
+        const SQUnsignedInteger size = _class_size[c];
+        char *p = (char *)chunk + 16, *end = (char *)chunk + SQ_MEMPOOL_CHUNK_SIZE;
+        for(; p + size <= end; p += size) {
+            SQMemBlock *b = (SQMemBlock *)p;
+            b->_next = _free[c]._head;
+            _free[c]._head = b;
+            _free[c]._count++;
+        }
+    }
+};
+
+static SQMemCache &_cache()
+{
+    static thread_local SQMemCache c;
+    return c;
+}
+
+static inline void _track(SQInteger delta)
+{
+    /* live bytes are also counted without the pool so the host can follow the growth */
+    SQMemCache &c = _cache();
+    c._stats._live += delta;
+    if(c._stats._live > c._stats._peak) c._stats._peak = c._stats._live;
+}
+
+static inline void *_pool_alloc(SQUnsignedInteger size)
+{
+    SQMemCache &c = _cache();
+    if(size > SQ_MEMPOOL_MAX_SIZE) {
+        void *p = malloc(size);
+        if(p) { c._stats._large++; c._stats._live += size; }
+        if(c._stats._live > c._stats._peak) c._stats._peak = c._stats._live;
+        return p;
+    }
+    const SQInteger cls = _size_class(size);
+    if(!c._free[cls]._head) {
+        c.refill(cls);
+        if(!c._free[cls]._head) return NULL;
+    }
+    SQMemBlock *b = c._free[cls]._head;
+    c._free[cls]._head = b->_next;
+    c._free[cls]._count--;
+    c._stats._blocks[cls]++;
+    c._stats._live += _class_size[cls];
+    if(c._stats._live > c._stats._peak) c._stats._peak = c._stats._live;
+    return b;
+}
+
+static inline void _pool_free(void *p, SQUnsignedInteger size)
+{
+    if(!p) return;
+    SQMemCache &c = _cache();
+    if(size > SQ_MEMPOOL_MAX_SIZE) {
+        c._stats._large--;
+        c._stats._live -= size;
+        free(p);
+        return;
+    }
+    const SQInteger cls = _size_class(size);
+    SQMemBlock *b = (SQMemBlock *)p;
+    b->_next = c._free[cls]._head;
+    c._free[cls]._head = b;
+    c._free[cls]._count++;
+    c._stats._blocks[cls]--;
+    c._stats._live -= _class_size[cls];
+    /* don't let a single thread hoard the blocks */
+    if(c._free[cls]._count > 2 * SQ_MEMPOOL_BATCH) c.drain(cls);
+}
+
+static inline void *_pool_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size)
+{
+    if(!p) return _pool_alloc(size);
+    if(oldsize > SQ_MEMPOOL_MAX_SIZE && size > SQ_MEMPOOL_MAX_SIZE) {
+        void *np = realloc(p, size);
+        if(np) {
+            SQMemCache &c = _cache();
+            c._stats._live += (SQInteger)size - (SQInteger)oldsize;
+            if(c._stats._live > c._stats._peak) c._stats._peak = c._stats._live;
+        }
+        return np;
+    }
+    /* the block already fits in the same class */
+    if(oldsize <= SQ_MEMPOOL_MAX_SIZE && size <= SQ_MEMPOOL_MAX_SIZE && _size_class(oldsize) == _size_class(size)) return p;
+    void *np = _pool_alloc(size);
+    if(!np) return NULL;
+    memcpy(np, p, oldsize < size ? oldsize : size);
+    _pool_free(p, oldsize);
+    return np;
+}
+
+static inline void *_raw_malloc(SQUnsignedInteger size)
+{
+    if(_pool_enabled.load(std::memory_order_relaxed)) return _pool_alloc(size);
+    void *p = malloc(size);
+    if(p) _track(size);
+    return p;
+}
+
+static inline void *_raw_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size)
+{
+    if(_pool_enabled.load(std::memory_order_relaxed)) return _pool_realloc(p, oldsize, size);
+    void *np = realloc(p, size);
+    if(np) _track((SQInteger)size - (SQInteger)oldsize);
+    return np;
+}
+
+static inline void _raw_free(void *p, SQUnsignedInteger size)
+{
+    if(_pool_enabled.load(std::memory_order_relaxed)) _pool_free(p, size);
+    else { free(p); _track(-(SQInteger)size); }
+}
+
+void *sq_vm_malloc(SQUnsignedInteger size)
+{
+    if(!_pool_used.load(std::memory_order_relaxed)) _pool_used.store(true, std::memory_order_relaxed);
+    if(!_tag_enabled.load(std::memory_order_relaxed)) return _raw_malloc(size);
+    /* the header remembers the tag so the bytes are given back to the same tag */
+    SQMemCache &c = _cache();
+    char *b = (char *)_raw_malloc(size + SQ_MEMTAG_HEADER);
+    if(!b) return NULL;
+    *(SQInteger *)b = c._tag;
+    c._stats._tags[c._tag] += size;
+    return b + SQ_MEMTAG_HEADER;
+}
+
+void *sq_vm_realloc(void *p, SQUnsignedInteger oldsize, SQUnsignedInteger size)
+{
+    if(!_pool_used.load(std::memory_order_relaxed)) _pool_used.store(true, std::memory_order_relaxed);
+    if(!_tag_enabled.load(std::memory_order_relaxed)) return _raw_realloc(p, oldsize, size);
+    if(!p) return sq_vm_malloc(size);
+    char *b = (char *)p - SQ_MEMTAG_HEADER;
+    const SQInteger tag = *(SQInteger *)b;
+    b = (char *)_raw_realloc(b, oldsize + SQ_MEMTAG_HEADER, size + SQ_MEMTAG_HEADER);
+    if(!b) return NULL;
+    _cache()._stats._tags[tag] += (SQInteger)size - (SQInteger)oldsize;
+    return b + SQ_MEMTAG_HEADER;
+}
+
+void sq_vm_free(void *p, SQUnsignedInteger size)
+{
+    if(!_tag_enabled.load(std::memory_order_relaxed)) { _raw_free(p, size); return; }
+    if(!p) return;
+    char *b = (char *)p - SQ_MEMTAG_HEADER;
+    _cache()._stats._tags[*(SQInteger *)b] -= size;
+    _raw_free(b, size + SQ_MEMTAG_HEADER);
+}
+
+SQBool sq_setmempool(SQBool enable)
+{
+    const bool on = enable != SQFalse;
+    if(_pool_enabled.load() == on) return SQTrue;
+    /* blocks can't move between allocators once the vm used one of them */
+    if(_pool_used.load()) return SQFalse;
+    _pool_enabled.store(on);
+    return SQTrue;
+}
+
+SQBool sq_getmempool()
+{
+    return _pool_enabled.load() ? SQTrue : SQFalse;
+}
+
+SQBool sq_setmemtagging(SQBool enable)
+{
+    const bool on = enable != SQFalse;
+    if(_tag_enabled.load() == on) return SQTrue;
+    /* blocks allocated without a header can't be told apart from the ones with a header */
+    if(_pool_used.load()) return SQFalse;
+    _tag_enabled.store(on);
+    return SQTrue;
+}
+
+SQBool sq_getmemtagging()
+{
+    return _tag_enabled.load() ? SQTrue : SQFalse;
+}
+
+SQInteger sq_setmemtag(SQInteger tag)
+{
+    if(!_tag_enabled.load(std::memory_order_relaxed)) return 0;
+    SQMemCache &c = _cache();
+    const SQInteger prev = c._tag;
+    c._tag = (tag < 0 || tag >= SQ_MEMTAG_MAX) ? SQ_MEMTAG_MAX - 1 : tag;
+    return prev;
+}
+
+SQInteger sq_getmemtag()
+{
+    if(!_tag_enabled.load(std::memory_order_relaxed)) return 0;
+    return _cache()._tag;
+}
 
-void sq_vm_free(void *p, SQUnsignedInteger SQ_UNUSED_ARG(size)){ free(p); }
+void sq_getmempoolstats(SQMemPoolStats *stats)
+{
+    memset(stats, 0, sizeof(SQMemPoolStats));
+    SQMemCache &c = _cache();
+    SQMemDepot &d = _depot();
+    std::lock_guard<std::mutex> guard(d._lock);
+    /* the depot holds the counters of exited threads, the vm thread holds the rest */
+    stats->live = (SQUnsignedInteger)(d._stats._live + c._stats._live);
+    stats->peak = (SQUnsignedInteger)(d._stats._peak > c._stats._peak ? d._stats._peak : c._stats._peak);
+    stats->reserved = d._reserved;
+    stats->large = (SQUnsignedInteger)(d._stats._large + c._stats._large);
+    for(SQInteger i = 0; i < SQ_MEMPOOL_CLASSES; i++) {
+        stats->size[i] = _class_size[i];
+        stats->blocks[i] = (SQUnsignedInteger)(d._stats._blocks[i] + c._stats._blocks[i]);
+        stats->cached[i] = d._free[i]._count + c._free[i]._count;
+    }
+    for(SQInteger i = 0; i < SQ_MEMTAG_MAX; i++) {
+        stats->tags[i] = (SQUnsignedInteger)(d._stats._tags[i] + c._stats._tags[i]);
+    }
+}
 #endif
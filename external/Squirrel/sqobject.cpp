@@ -397,9 +397,29 @@ SQFunctionProto::SQFunctionProto(SQSharedState *ss)
 {
     _stacksize=0;
     _bgenerator=false;
+    _memtag=sq_getmemtag();
+    _inlinecaches=NULL;
     INIT_CHAIN();ADD_TO_CHAIN(&_ss(this)->_gc_chain,this);
 }
 
+void SQFunctionProto::CreateInlineCaches()
+{
+    _inlinecaches = (SQInlineCache *)sq_vm_malloc(_ninstructions*sizeof(SQInlineCache));
+    for(SQInteger i = 0; i < _ninstructions; i++) {
+        new (&_inlinecaches[i]) SQInlineCache();
+        _inlinecaches[i]._classid = 0;
+        _inlinecaches[i]._member = 0;
+    }
+}
+
+void SQFunctionProto::ReleaseInlineCaches()
+{
+    if(!_inlinecaches) return;
+    _DESTRUCT_VECTOR(SQInlineCache,_ninstructions,_inlinecaches);
+    sq_vm_free(_inlinecaches,_ninstructions*sizeof(SQInlineCache));
+    _inlinecaches = NULL;
+}
+
 SQFunctionProto::~SQFunctionProto()
 {
     REMOVE_FROM_CHAIN(&_ss(this)->_gc_chain,this);
@@ -596,6 +616,8 @@ void SQClass::Mark(SQCollectable **chain)
         _members->Mark(chain);
         if(_base) _base->Mark(chain);
         SQSharedState::MarkObject(_attributes, chain);
+        SQSharedState::MarkObject(_getters, chain);
+        SQSharedState::MarkObject(_setters, chain);
         for(SQUnsignedInteger i =0; i< _defaultvalues.size(); i++) {
             SQSharedState::MarkObject(_defaultvalues[i].val, chain);
             SQSharedState::MarkObject(_defaultvalues[i].attrs, chain);
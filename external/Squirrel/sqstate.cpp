@@ -21,6 +21,10 @@ SQSharedState::SQSharedState()
     _notifyallexceptions = false;
     _foreignptr = NULL;
     _releasehook = NULL;
+    _samplehook = NULL;
+    _sampleup = NULL;
+    _samplepending = false;
+    _classcacheid = 0;
 }
 
 #define newsysstring(s) {   \
@@ -622,6 +626,17 @@ void SQStringTable::Resize(SQInteger size)
     SQ_FREE(oldtable,oldsize*sizeof(SQString*));
 }
 
+SQUnsignedInteger SQStringTable::MemSize() const
+{
+    SQUnsignedInteger size = sizeof(SQString*)*_numofslots;
+    for (SQUnsignedInteger i=0; i<_numofslots; i++){
+        for (SQString *s = _strings[i]; s; s = s->_next){
+            size += sq_rsl(s->_len)+sizeof(SQString);
+        }
+    }
+    return size;
+}
+
 void SQStringTable::Remove(SQString *bs)
 {
     SQString *s;
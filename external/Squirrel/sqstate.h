@@ -4,6 +4,7 @@
 
 #include "squtils.h"
 #include "sqobject.h"
+#include <atomic>
 struct SQString;
 struct SQTable;
 //max number of character for a printed number
@@ -15,6 +16,8 @@ struct SQStringTable
     ~SQStringTable();
     SQString *Add(const SQChar *,SQInteger len);
     void Remove(SQString *);
+    SQUnsignedInteger Count() const { return _slotused; }
+    SQUnsignedInteger MemSize() const;
 private:
     void Resize(SQInteger size);
     void AllocNodes(SQInteger size);
@@ -111,6 +114,10 @@ public:
     bool _notifyallexceptions;
     SQUserPointer _foreignptr;
     SQRELEASEHOOK _releasehook;
+    SQSAMPLEHOOK _samplehook;
+    SQUserPointer _sampleup;
+    std::atomic<bool> _samplepending; /* set from any thread, checked at calls and backward jumps */
+    SQUnsignedInteger _classcacheid; /* last id given to a class layout for the inline caches */
 private:
     SQChar *_scratchpad;
     SQInteger _scratchpadsize;
@@ -99,6 +99,7 @@ public:
     SQInteger Next(bool getweakrefs,const SQObjectPtr &refpos, SQObjectPtr &outkey, SQObjectPtr &outval);
 
     SQInteger CountUsed(){ return _usednodes;}
+    SQInteger MemSize(){ return sizeof(SQTable) + (_numofnodes * sizeof(_HashNode));}
     void Clear();
     void Release()
     {
@@ -424,6 +424,10 @@ bool SQVM::StartCall(SQClosure *closure,SQInteger target,SQInteger args,SQIntege
     ci->_literals = func->_literals;
     ci->_ip       = func->_instructions;
     ci->_target   = (SQInt32)target;
+    sq_setmemtag(func->_memtag);
+    if (_ss(this)->_samplepending.load(std::memory_order_relaxed)) {
+        TakeSample();
+    }
 
     if (_debughook) {
         CallDebugHook(_SC('c'));
@@ -443,6 +447,14 @@ bool SQVM::StartCall(SQClosure *closure,SQInteger target,SQInteger args,SQIntege
     return true;
 }
 
+void SQVM::TakeSample()
+{
+    SQSharedState *ss = _ss(this);
+    /* only one of the vm threads answers each request */
+    if (!ss->_samplepending.exchange(false)) return;
+    if (ss->_samplehook) ss->_samplehook(this, ss->_sampleup);
+}
+
 bool SQVM::Return(SQInteger _arg0, SQInteger _arg1, SQObjectPtr &retval)
 {
     SQBool    _isroot      = ci->_root;
@@ -472,6 +484,9 @@ bool SQVM::Return(SQInteger _arg0, SQInteger _arg1, SQObjectPtr &retval)
         //*dest = (_arg0 != 0xFF) ? _stack._vals[_stackbase+_arg1] : _null_;
     }
     LeaveFrame();
+    if (!_isroot && ci && sq_type(ci->_closure) == OT_CLOSURE) {
+        sq_setmemtag(_closure(ci->_closure)->_function->_memtag);
+    }
     return _isroot ? true : false;
 }
 
@@ -673,6 +688,7 @@ bool SQVM::Execute(SQObjectPtr &closure, SQInteger nargs, SQInteger stackbase,SQ
     if ((_nnativecalls + 1) > MAX_NATIVE_CALLS) { Raise_Error(_SC("Native stack overflow")); return false; }
     _nnativecalls++;
     AutoDec ad(&_nnativecalls);
+    AutoMemTag amt;
     SQInteger traps = 0;
     CallInfo *prevci = ci;
 
@@ -808,7 +824,7 @@ exception_restore:
             case _OP_PREPCALLK: {
                     SQObjectPtr &key = _i_.op == _OP_PREPCALLK?(ci->_literals)[arg1]:STK(arg1);
                     SQObjectPtr &o = STK(arg2);
-                    if (!Get(o, key, temp_reg,0,arg2)) {
+                    if (!CachedGet(&_i_, o, key, temp_reg, arg2)) {
                         SQ_THROW();
                     }
                     STK(arg3) = o;
@@ -816,7 +832,7 @@ exception_restore:
                 }
                 continue;
             case _OP_GETK:
-                if (!Get(STK(arg2), ci->_literals[arg1], temp_reg, 0,arg2)) { SQ_THROW();}
+                if (!CachedGet(&_i_, STK(arg2), ci->_literals[arg1], temp_reg, arg2)) { SQ_THROW();}
                 _Swap(TARGET,temp_reg);//TARGET = temp_reg;
                 continue;
             case _OP_MOVE: TARGET = STK(arg1); continue;
@@ -826,11 +842,11 @@ exception_restore:
                 continue;
             case _OP_DELETE: _GUARD(DeleteSlot(STK(arg1), STK(arg2), TARGET)); continue;
             case _OP_SET:
-                if (!Set(STK(arg1), STK(arg2), STK(arg3),arg1)) { SQ_THROW(); }
+                if (!CachedSet(&_i_, STK(arg1), STK(arg2), STK(arg3), arg1)) { SQ_THROW(); }
                 if (arg0 != 0xFF) TARGET = STK(arg3);
                 continue;
             case _OP_GET:
-                if (!Get(STK(arg1), STK(arg2), temp_reg, 0,arg1)) { SQ_THROW(); }
+                if (!CachedGet(&_i_, STK(arg1), STK(arg2), temp_reg, arg1)) { SQ_THROW(); }
                 _Swap(TARGET,temp_reg);//TARGET = temp_reg;
                 continue;
             case _OP_EQ:{
@@ -872,7 +888,10 @@ exception_restore:
                 continue;
             case _OP_LOADBOOL: TARGET = arg1?true:false; continue;
             case _OP_DMOVE: STK(arg0) = STK(arg1); STK(arg2) = STK(arg3); continue;
-            case _OP_JMP: ci->_ip += (sarg1); continue;
+            case _OP_JMP:
+                ci->_ip += (sarg1);
+                if (sarg1 < 0 && _ss(this)->_samplepending.load(std::memory_order_relaxed)) TakeSample();
+                continue;
             //case _OP_JNZ: if(!IsFalse(STK(arg0))) ci->_ip+=(sarg1); continue;
             case _OP_JCMP:
                 _GUARD(CMP_OP((CmpOP)arg3,STK(arg2),STK(arg0),temp_reg));
@@ -1078,6 +1097,7 @@ exception_trap:
                 _stack._vals[_stackbase + et._extarget] = currerror;
                 _etraps.pop_back(); traps--; ci->_etraps--;
                 while(last_top >= _top) _stack._vals[last_top--].Null();
+                sq_setmemtag(_closure(ci->_closure)->_function->_memtag);
                 goto exception_restore;
             }
             else if (_debughook) {
@@ -1294,6 +1314,10 @@ SQInteger SQVM::FallBackGet(const SQObjectPtr &self,const SQObjectPtr &key,SQObj
         }
         //go through
     case OT_INSTANCE: {
+        if(type(self) == OT_INSTANCE) {
+            SQInteger res = GetAccessor(self,key,dest);
+            if(res != FALLBACK_NO_MATCH) return res;
+        }
         SQObjectPtr closure;
         if(_delegable(self)->GetMetaMethod(this, MT_GET, closure)) {
             Push(self);Push(key);
@@ -1318,6 +1342,91 @@ SQInteger SQVM::FallBackGet(const SQObjectPtr &self,const SQObjectPtr &key,SQObj
     return FALLBACK_NO_MATCH;
 }
 
+SQInteger SQVM::GetAccessor(const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest)
+{
+    SQClass *c = _instance(self)->_class;
+    SQObjectPtr closure;
+    if(type(c->_getters) != OT_TABLE || !_table(c->_getters)->Get(key,closure)) return FALLBACK_NO_MATCH;
+    Push(self);
+    _nmetamethodscall++;
+    AutoDec ad(&_nmetamethodscall);
+    bool ok = Call(closure, 1, _top - 1, dest, SQFalse);
+    Pop(1);
+    return ok ? FALLBACK_OK : FALLBACK_ERROR;
+}
+
+SQInteger SQVM::SetAccessor(const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val)
+{
+    SQClass *c = _instance(self)->_class;
+    SQObjectPtr closure;
+    SQObjectPtr t;
+    if(type(c->_setters) != OT_TABLE || !_table(c->_setters)->Get(key,closure)) return FALLBACK_NO_MATCH;
+    Push(self);Push(val);
+    _nmetamethodscall++;
+    AutoDec ad(&_nmetamethodscall);
+    bool ok = Call(closure, 2, _top - 2, t, SQFalse);
+    Pop(2);
+    return ok ? FALLBACK_OK : FALLBACK_ERROR;
+}
+
+//same as Get() but remembers where the member of an instance was found for the next time
+//the instruction runs with an instance of the same class
+bool SQVM::CachedGet(const SQInstruction *i,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest,SQInteger selfidx)
+{
+    if(type(self) == OT_INSTANCE && type(key) == OT_STRING) {
+        SQInstance *inst = _instance(self);
+        SQClass *c = inst->_class;
+        SQInlineCache &ic = _closure(ci->_closure)->_function->GetInlineCache(i);
+        if(ic._classid != c->_cacheid || _rawval(ic._key) != _rawval(key)) {
+            SQObjectPtr temp;
+            if(c->_members->Get(key,temp)) ic._member = _integer(temp);
+            else if(type(c->_getters) == OT_TABLE && _table(c->_getters)->Get(key,temp)) ic._member = MEMBER_TYPE_ACCESSOR;
+            else return Get(self,key,dest,0,selfidx);
+            ic._key = key;
+            ic._classid = c->_cacheid;
+        }
+        if(ic._member & MEMBER_TYPE_FIELD) {
+            dest = _realval(inst->_values[ic._member & 0x00FFFFFF]);
+            return true;
+        }
+        if(ic._member & MEMBER_TYPE_METHOD) {
+            dest = c->_methods[ic._member & 0x00FFFFFF].val;
+            return true;
+        }
+        switch(GetAccessor(self,key,dest)) {
+            case FALLBACK_OK: return true;
+            case FALLBACK_ERROR: return false;
+        }
+    }
+    return Get(self,key,dest,0,selfidx);
+}
+
+bool SQVM::CachedSet(const SQInstruction *i,const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val,SQInteger selfidx)
+{
+    if(type(self) == OT_INSTANCE && type(key) == OT_STRING) {
+        SQInstance *inst = _instance(self);
+        SQClass *c = inst->_class;
+        SQInlineCache &ic = _closure(ci->_closure)->_function->GetInlineCache(i);
+        if(ic._classid != c->_cacheid || _rawval(ic._key) != _rawval(key)) {
+            SQObjectPtr temp;
+            if(c->_members->Get(key,temp) && _isfield(temp)) ic._member = _integer(temp);
+            else if(type(c->_setters) == OT_TABLE && _table(c->_setters)->Get(key,temp)) ic._member = MEMBER_TYPE_ACCESSOR;
+            else return Set(self,key,val,selfidx);
+            ic._key = key;
+            ic._classid = c->_cacheid;
+        }
+        if(ic._member & MEMBER_TYPE_FIELD) {
+            inst->_values[ic._member & 0x00FFFFFF] = val;
+            return true;
+        }
+        switch(SetAccessor(self,key,val)) {
+            case FALLBACK_OK: return true;
+            case FALLBACK_ERROR: return false;
+        }
+    }
+    return Set(self,key,val,selfidx);
+}
+
 bool SQVM::Set(const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val,SQInteger selfidx)
 {
     switch(type(self)){
@@ -1363,6 +1472,10 @@ SQInteger SQVM::FallBackSet(const SQObjectPtr &self,const SQObjectPtr &key,const
         //keps on going
     case OT_INSTANCE:
     case OT_USERDATA:{
+        if(type(self) == OT_INSTANCE) {
+            SQInteger res = SetAccessor(self,key,val);
+            if(res != FALLBACK_NO_MATCH) return res;
+        }
         SQObjectPtr closure;
         SQObjectPtr t;
         if(_delegable(self)->GetMetaMethod(this, MT_SET, closure)) {
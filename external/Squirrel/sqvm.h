@@ -65,12 +65,17 @@ public:
     SQRESULT Suspend();
 
     void CallDebugHook(SQInteger type,SQInteger forcedline=0);
+    void TakeSample();
     void CallErrorHandler(SQObjectPtr &e);
     bool Get(const SQObjectPtr &self, const SQObjectPtr &key, SQObjectPtr &dest, SQUnsignedInteger getflags, SQInteger selfidx);
     SQInteger FallBackGet(const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest);
+    SQInteger GetAccessor(const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest);
+    bool CachedGet(const SQInstruction *i,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest,SQInteger selfidx);
     bool InvokeDefaultDelegate(const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest);
     bool Set(const SQObjectPtr &self, const SQObjectPtr &key, const SQObjectPtr &val, SQInteger selfidx);
     SQInteger FallBackSet(const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val);
+    SQInteger SetAccessor(const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val);
+    bool CachedSet(const SQInstruction *i,const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val,SQInteger selfidx);
     bool NewSlot(const SQObjectPtr &self, const SQObjectPtr &key, const SQObjectPtr &val,bool bstatic);
     bool NewSlotA(const SQObjectPtr &self,const SQObjectPtr &key,const SQObjectPtr &val,const SQObjectPtr &attrs,bool bstatic,bool raw);
     bool DeleteSlot(const SQObjectPtr &self, const SQObjectPtr &key, SQObjectPtr &res);
@@ -183,6 +188,12 @@ struct AutoDec{
     SQInteger *_n;
 };
 
+struct AutoMemTag{
+    AutoMemTag() { _tag = sq_getmemtag(); }
+    ~AutoMemTag() { sq_setmemtag(_tag); }
+    SQInteger _tag;
+};
+
 inline SQObjectPtr &stack_get(HSQUIRRELVM v,SQInteger idx){return ((idx>=0)?(v->GetAt(idx+v->_stackbase-1)):(v->GetUp(idx)));}
 
 #define _ss(_vm_) (_vm_)->_sharedstate
@@ -677,6 +677,11 @@ protected:
         sq_newclosure(vm, &sqVarGet, 1);
         sq_newslot(vm, -3, false);
 
+        // let the virtual machine call the accessors directly instead of going through _get and _set
+        sq_pushobject(vm, getTable);
+        sq_pushobject(vm, setTable);
+        sq_setclassaccessors(vm, -3);
+
         // add weakref (apparently not provided by default)
         sq_pushstring(vm, _SC("weakref"), -1);
         sq_newclosure(vm, &Class::ClassWeakref, 0);
@@ -1293,6 +1298,11 @@ protected:
         sq_newclosure(vm, sqVarGet, 1);
         sq_newslot(vm, -3, false);
 
+        // let the virtual machine call the accessors directly instead of going through _get and _set
+        sq_pushobject(vm, getTable);
+        sq_pushobject(vm, setTable);
+        sq_setclassaccessors(vm, -3);
+
         // add weakref (apparently not provided by default)
         sq_pushstring(vm, _SC("weakref"), -1);
         sq_newclosure(vm, &Class<C, A>::ClassWeakref, 0);
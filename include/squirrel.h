@@ -178,6 +178,7 @@ typedef SQInteger (*SQFUNCTION)(HSQUIRRELVM);
 typedef SQInteger (*SQRELEASEHOOK)(SQUserPointer,SQInteger size);
 typedef void (*SQCOMPILERERROR)(HSQUIRRELVM,const SQChar * /*desc*/,const SQChar * /*source*/,SQInteger /*line*/,SQInteger /*column*/);
 typedef void (*SQPRINTFUNCTION)(HSQUIRRELVM,const SQChar * ,...);
+typedef void (*SQSAMPLEHOOK)(HSQUIRRELVM /*v*/, SQUserPointer /*up*/);
 typedef void (*SQDEBUGHOOK)(HSQUIRRELVM /*v*/, SQInteger /*type*/, const SQChar * /*sourcename*/, SQInteger /*line*/, const SQChar * /*funcname*/);
 typedef SQInteger (*SQWRITEFUNC)(SQUserPointer,SQUserPointer,SQInteger);
 typedef SQInteger (*SQREADFUNC)(SQUserPointer,SQUserPointer,SQInteger);
@@ -198,6 +199,32 @@ typedef struct tagSQFunctionInfo {
     SQInteger line;
 }SQFunctionInfo;
 
+#define SQ_MEMPOOL_CLASSES 16
+#define SQ_MEMTAG_MAX 64
+
+typedef struct tagSQMemPoolStats {
+    SQUnsignedInteger live; /* bytes currently allocated by the vm */
+    SQUnsignedInteger peak; /* highest number of bytes allocated at once */
+    SQUnsignedInteger reserved; /* bytes reserved by the pool chunks */
+    SQUnsignedInteger large; /* blocks too large for the pool */
+    SQUnsignedInteger size[SQ_MEMPOOL_CLASSES]; /* block size of each class */
+    SQUnsignedInteger blocks[SQ_MEMPOOL_CLASSES]; /* blocks in use per class */
+    SQUnsignedInteger cached[SQ_MEMPOOL_CLASSES]; /* free blocks kept per class */
+    SQUnsignedInteger tags[SQ_MEMTAG_MAX]; /* bytes allocated under each tag, when tagging is enabled */
+}SQMemPoolStats;
+
+typedef struct tagSQHeapObjectInfo {
+    SQObjectType type; /* type of the objects */
+    SQUnsignedInteger count; /* number of objects described, strings are reported together */
+    SQUnsignedInteger size; /* bytes allocated by the objects */
+    SQUserPointer object; /* the object itself */
+    SQUserPointer owner; /* class of an instance */
+    SQUserPointer typetag; /* type tag of a class or of the class of an instance */
+    const SQChar *source; /* source file of a closure */
+}SQHeapObjectInfo;
+
+typedef void (*SQHEAPWALKHOOK)(const SQHeapObjectInfo *info,SQUserPointer up);
+
 #ifndef SQMOD_PLUGIN_API
 
 /*vm*/
@@ -280,10 +307,12 @@ SQUIRREL_API SQChar *sq_getscratchpad(HSQUIRRELVM v,SQInteger minsize);
 SQUIRREL_API SQRESULT sq_getfunctioninfo(HSQUIRRELVM v,SQInteger level,SQFunctionInfo *fi);
 SQUIRREL_API SQRESULT sq_getclosureinfo(HSQUIRRELVM v,SQInteger idx,SQUnsignedInteger *nparams,SQUnsignedInteger *nfreevars);
 SQUIRREL_API SQRESULT sq_getclosurename(HSQUIRRELVM v,SQInteger idx);
+SQUIRREL_API SQRESULT sq_getclosuresource(HSQUIRRELVM v,SQInteger idx);
 SQUIRREL_API SQRESULT sq_setnativeclosurename(HSQUIRRELVM v,SQInteger idx,const SQChar *name);
 SQUIRREL_API SQRESULT sq_setinstanceup(HSQUIRRELVM v, SQInteger idx, SQUserPointer p);
 SQUIRREL_API SQRESULT sq_getinstanceup(HSQUIRRELVM v, SQInteger idx, SQUserPointer *p,SQUserPointer typetag);
 SQUIRREL_API SQRESULT sq_setclassudsize(HSQUIRRELVM v, SQInteger idx, SQInteger udsize);
+SQUIRREL_API SQRESULT sq_setclassaccessors(HSQUIRRELVM v,SQInteger idx);
 SQUIRREL_API SQRESULT sq_newclass(HSQUIRRELVM v,SQBool hasbase);
 SQUIRREL_API SQRESULT sq_createinstance(HSQUIRRELVM v,SQInteger idx);
 SQUIRREL_API SQRESULT sq_setattributes(HSQUIRRELVM v,SQInteger idx);
@@ -354,6 +383,7 @@ SQUIRREL_API SQUnsignedInteger sq_getvmrefcount(HSQUIRRELVM v, const HSQOBJECT *
 /*GC*/
 SQUIRREL_API SQInteger sq_collectgarbage(HSQUIRRELVM v);
 SQUIRREL_API SQRESULT sq_resurrectunreachable(HSQUIRRELVM v);
+SQUIRREL_API SQRESULT sq_walkheap(HSQUIRRELVM v,SQHEAPWALKHOOK hook,SQUserPointer up);
 
 /*serialization*/
 SQUIRREL_API SQRESULT sq_writeclosure(HSQUIRRELVM vm,SQWRITEFUNC writef,SQUserPointer up);
@@ -363,11 +393,20 @@ SQUIRREL_API SQRESULT sq_readclosure(HSQUIRRELVM vm,SQREADFUNC readf,SQUserPoint
 SQUIRREL_API void *sq_malloc(SQUnsignedInteger size);
 SQUIRREL_API void *sq_realloc(void* p,SQUnsignedInteger oldsize,SQUnsignedInteger newsize);
 SQUIRREL_API void sq_free(void *p,SQUnsignedInteger size);
+SQUIRREL_API SQBool sq_setmempool(SQBool enable);
+SQUIRREL_API SQBool sq_getmempool();
+SQUIRREL_API void sq_getmempoolstats(SQMemPoolStats *stats);
+SQUIRREL_API SQBool sq_setmemtagging(SQBool enable);
+SQUIRREL_API SQBool sq_getmemtagging();
+SQUIRREL_API SQInteger sq_setmemtag(SQInteger tag);
+SQUIRREL_API SQInteger sq_getmemtag();
 
 /*debug*/
 SQUIRREL_API SQRESULT sq_stackinfos(HSQUIRRELVM v,SQInteger level,SQStackInfos *si);
 SQUIRREL_API void sq_setdebughook(HSQUIRRELVM v);
 SQUIRREL_API void sq_setnativedebughook(HSQUIRRELVM v,SQDEBUGHOOK hook);
+SQUIRREL_API void sq_setsamplehook(HSQUIRRELVM v,SQSAMPLEHOOK hook,SQUserPointer up);
+SQUIRREL_API void sq_requestsample(HSQUIRRELVM v);
 
 #endif // SQMOD_PLUGIN_API
 
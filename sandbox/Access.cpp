@@ -0,0 +1,118 @@
+// ------------------------------------------------------------------------------------------------
+#include <sqrat.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+using namespace Sqrat;
+
+/* ------------------------------------------------------------------------------------------------
+ * Stand-in for the player entity. It is bound the same way as CPlayer, but reads and writes plain
+ * fields instead of calling into the server, so only the cost of reaching the members is measured.
+*/
+struct AccessPlayer
+{
+    // --------------------------------------------------------------------------------------------
+    float mHealth = 100.0f;
+    int   mScore = 0;
+
+    // --------------------------------------------------------------------------------------------
+    int GetID() const { return 7; }
+    float GetHealth() const { return mHealth; }
+    void SetHealth(float health) { mHealth = health; }
+    int GetScore() const { return mScore; }
+    void SetScore(int score) { mScore = score; }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * The script that performs the measured operations. Each function runs one million iterations.
+*/
+static const SQChar g_AccessScript[] = _SC(
+    "const N = 1000000;\n"
+    "class Point { x = 0; y = 0; function Length() { return x + y; } }\n"
+    "function prop_get() { local p = ::player, s = 0; for (local i = 0; i < N; ++i) s += p.ID; return s; }\n"
+    "function prop_set() { local p = ::player; for (local i = 0; i < N; ++i) p.Score = i; return p.Score; }\n"
+    "function prop_mix() { local p = ::player, s = 0; for (local i = 0; i < N; ++i) { p.Health = p.Health + 1; s += p.Score; } return s; }\n"
+    "function method() { local p = ::player, s = 0; for (local i = 0; i < N; ++i) s += p.GetID(); return s; }\n"
+    "function field() { local q = Point(), s = 0; for (local i = 0; i < N; ++i) { q.x = i; s += q.y + q.Length(); } return s; }\n"
+    "function table() { local t = {a = 1, b = 2}, s = 0; for (local i = 0; i < N; ++i) s += t.a + t.b; return s; }\n"
+);
+
+// ------------------------------------------------------------------------------------------------
+static void AccessPrint(HSQUIRRELVM /*vm*/, const SQChar * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    std::vprintf(fmt, args);
+    va_end(args);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Call a script function from the root table and report how long it took.
+*/
+static bool AccessRun(HSQUIRRELVM vm, const SQChar * name)
+{
+    sq_pushroottable(vm);
+    sq_pushstring(vm, name, -1);
+    sq_get(vm, -2);
+    sq_pushroottable(vm);
+    // Time the call
+    const auto start = std::chrono::steady_clock::now();
+    const SQRESULT res = sq_call(vm, 1, SQFalse, SQTrue);
+    const auto end = std::chrono::steady_clock::now();
+    // Pop the function and the root table
+    sq_pop(vm, 2);
+    // Did the script fail?
+    if (SQ_FAILED(res))
+    {
+        std::printf("  %-10s failed\n", name);
+        return false;
+    }
+    std::printf("  %-10s %8.1f ms\n", name, std::chrono::duration< double, std::milli >(end - start).count());
+    return true;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Measure member access on bound class instances, script class instances and tables.
+*/
+int AccessBenchmark()
+{
+    HSQUIRRELVM vm = sq_open(1024);
+    sq_setprintfunc(vm, AccessPrint, AccessPrint);
+    DefaultVM::Set(vm);
+    // Bind the stand-in like the entity classes are bound
+    Class< AccessPlayer, NoConstructor< AccessPlayer > > cls(vm, _SC("CPlayer"));
+    cls.Prop(_SC("ID"), &AccessPlayer::GetID);
+    cls.Prop(_SC("Health"), &AccessPlayer::GetHealth, &AccessPlayer::SetHealth);
+    cls.Prop(_SC("Score"), &AccessPlayer::GetScore, &AccessPlayer::SetScore);
+    cls.Func(_SC("GetID"), &AccessPlayer::GetID);
+    RootTable(vm).Bind(_SC("CPlayer"), cls);
+    // The instance used by the script
+    static AccessPlayer player;
+    RootTable(vm).SetValue(_SC("player"), &player);
+    // Compile and run the script
+    sq_pushroottable(vm);
+    if (SQ_FAILED(sq_compilebuffer(vm, g_AccessScript, std::strlen(g_AccessScript), _SC("access"), SQTrue)))
+    {
+        std::puts("Unable to compile the access benchmark");
+        sq_close(vm);
+        return 1;
+    }
+    sq_push(vm, -2);
+    sq_call(vm, 1, SQFalse, SQTrue);
+    sq_pop(vm, 2);
+    // Run the measured functions
+    std::puts("Member access, 1000000 iterations each:");
+    bool success = true;
+    for (const SQChar * name : { _SC("prop_get"), _SC("prop_set"), _SC("prop_mix"),
+                                _SC("method"), _SC("field"), _SC("table") })
+    {
+        success = AccessRun(vm, name) && success;
+    }
+    sq_close(vm);
+    return success ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// ------------------------------------------------------------------------------------------------
+#include <squirrel.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/* ------------------------------------------------------------------------------------------------
+ * The script that performs the measured operations. It creates the small objects that scripts
+ * usually churn through: tables, arrays, strings and class instances.
+*/
+static const SQChar g_AllocScript[] = _SC(
+    "const N = 200000;\n"
+    "class Point { x = 0; y = 0; constructor(a, b) { x = a; y = b; } }\n"
+    "function objects() {\n"
+    "  local s = 0;\n"
+    "  for (local i = 0; i < N; ++i) {\n"
+    "    local t = {a = i, b = [i, i + 1, i + 2]}, p = Point(i, i);\n"
+    "    s += t.b.len() + p.x + (\"n\" + i).len();\n"
+    "  }\n"
+    "  return s;\n"
+    "}\n"
+);
+
+/* ------------------------------------------------------------------------------------------------
+ * Small generator so that every run allocates the same sizes in the same order.
+*/
+static inline unsigned AllocNext(unsigned & state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Allocate and release blocks of mixed small sizes while keeping a number of them alive.
+*/
+static double AllocBlocks(unsigned count)
+{
+    std::vector< void * > ptrs(4096, nullptr);
+    std::vector< SQUnsignedInteger > sizes(ptrs.size(), 0);
+    unsigned state = 2463534242u;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+    {
+        // Replace a random block with a new one of a random size up to 512 bytes
+        const unsigned r = AllocNext(state);
+        const std::size_t slot = r % ptrs.size();
+        if (ptrs[slot])
+        {
+            sq_free(ptrs[slot], sizes[slot]);
+        }
+        sizes[slot] = 8 + ((r >> 12) % 505);
+        ptrs[slot] = sq_malloc(sizes[slot]);
+        // Touch the memory so that the allocation can't be skipped
+        *static_cast< char * >(ptrs[slot]) = static_cast< char >(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    // Release the remaining blocks
+    for (std::size_t i = 0; i < ptrs.size(); ++i)
+    {
+        if (ptrs[i])
+        {
+            sq_free(ptrs[i], sizes[i]);
+        }
+    }
+    return std::chrono::duration< double, std::milli >(end - start).count();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Run the script and report how long it took, or a negative value on failure.
+*/
+static double AllocScript()
+{
+    HSQUIRRELVM vm = sq_open(1024);
+    sq_pushroottable(vm);
+    // Compile and run the script
+    if (SQ_FAILED(sq_compilebuffer(vm, g_AllocScript, std::strlen(g_AllocScript), _SC("alloc"), SQTrue)))
+    {
+        sq_close(vm);
+        return -1.0;
+    }
+    sq_push(vm, -2);
+    sq_call(vm, 1, SQFalse, SQTrue);
+    sq_pop(vm, 1);
+    // Retrieve the measured function
+    sq_pushstring(vm, _SC("objects"), -1);
+    sq_get(vm, -2);
+    sq_pushroottable(vm);
+    // Time the call
+    const auto start = std::chrono::steady_clock::now();
+    const SQRESULT res = sq_call(vm, 1, SQFalse, SQTrue);
+    const auto end = std::chrono::steady_clock::now();
+    sq_close(vm);
+    // Did the script fail?
+    return SQ_FAILED(res) ? -1.0 : std::chrono::duration< double, std::milli >(end - start).count();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Measure the virtual machine allocator. The allocator can't be changed once memory was allocated,
+ * so each allocator is measured by a separate run of the program.
+*/
+int AllocBenchmark(bool pool)
+{
+    // Select the allocator before anything is allocated
+    if (!sq_setmempool(pool ? SQTrue : SQFalse))
+    {
+        std::puts("Unable to select the allocator");
+        return 1;
+    }
+    std::printf("Allocator: %s\n", pool ? "pool" : "malloc");
+    std::printf("  blocks     %8.1f ms\n", AllocBlocks(10000000));
+    // Run the script
+    const double ms = AllocScript();
+    if (ms < 0.0)
+    {
+        std::puts("  objects    failed");
+        return 1;
+    }
+    std::printf("  objects    %8.1f ms\n", ms);
+    return 0;
+}
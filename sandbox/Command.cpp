@@ -0,0 +1,140 @@
+// ------------------------------------------------------------------------------------------------
+#include <sqrat.h>
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+using namespace Sqrat;
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+extern void Register_Command(HSQUIRRELVM vm);
+extern void TerminateCommands();
+} // Namespace:: SqMod
+
+/* ------------------------------------------------------------------------------------------------
+ * Number of commands executed by each measured function.
+*/
+static const int g_CommandCount = 200000;
+
+/* ------------------------------------------------------------------------------------------------
+ * The script that performs the measured operations. Every command except `none` receives four
+ * arguments of the same type, so the difference to `none` is the cost of parsing four arguments.
+*/
+static const SQChar g_CommandScript[] = _SC(
+    "const N = 200000;\n"
+    "failures <- 0;\n"
+    "local mgr = SqCmd.Manager(), invoker = {};\n"
+    "mgr.BindFail(this, function(type, msg, data) { ::failures++; });\n"
+    "foreach (name, spec in {none = \"\", int = \"i|i|i|i\", float = \"f|f|f|f\", bool = \"b|b|b|b\", string = \"s|s|s|s\"}) {\n"
+    "  mgr.Create(name, spec).BindExec(this, function(invoker, args) { return 1; });\n"
+    "}\n"
+    "function run(cmd) { for (local i = 0; i < N; ++i) mgr.Run(invoker, cmd); return ::failures; }\n"
+    "function none() { return run(\"none\"); }\n"
+    "function int() { return run(\"int 12 345 -6789 10\"); }\n"
+    "function float() { return run(\"float 1.5 -2.25 300.125 0.5\"); }\n"
+    "function bool() { return run(\"bool true false true false\"); }\n"
+    "function string() { return run(\"string alpha beta gamma delta\"); }\n"
+);
+
+// ------------------------------------------------------------------------------------------------
+static void CommandPrint(HSQUIRRELVM /*vm*/, const SQChar * fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    std::vprintf(fmt, args);
+    va_end(args);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Call a script function from the root table and return how many nanoseconds each command took,
+ * or a negative value if the script or any of the commands failed.
+*/
+static double CommandRun(HSQUIRRELVM vm, const SQChar * name)
+{
+    sq_pushroottable(vm);
+    sq_pushstring(vm, name, -1);
+    sq_get(vm, -2);
+    sq_pushroottable(vm);
+    // Time the call
+    const auto start = std::chrono::steady_clock::now();
+    const SQRESULT res = sq_call(vm, 1, SQTrue, SQTrue);
+    const auto end = std::chrono::steady_clock::now();
+    // Retrieve the number of failed commands
+    SQInteger failures = -1;
+    if (SQ_SUCCEEDED(res))
+    {
+        sq_getinteger(vm, -1, &failures);
+        sq_pop(vm, 1);
+    }
+    // Pop the function and the root table
+    sq_pop(vm, 2);
+    // Did the script or any command fail?
+    if (failures != 0)
+    {
+        return -1.0;
+    }
+    return std::chrono::duration< double, std::nano >(end - start).count() / g_CommandCount;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Release the command managers before closing the virtual machine, like the module does.
+*/
+static void CommandClose(HSQUIRRELVM vm)
+{
+    SqMod::TerminateCommands();
+    sq_close(vm);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Measure the cost of parsing the command arguments of each type.
+*/
+int CommandBenchmark()
+{
+    HSQUIRRELVM vm = sq_open(1024);
+    sq_setprintfunc(vm, CommandPrint, CommandPrint);
+    DefaultVM::Set(vm);
+    SqMod::Register_Command(vm);
+    // Compile and run the script
+    sq_pushroottable(vm);
+    if (SQ_FAILED(sq_compilebuffer(vm, g_CommandScript, std::strlen(g_CommandScript), _SC("command"), SQTrue)))
+    {
+        std::puts("Unable to compile the command benchmark");
+        CommandClose(vm);
+        return 1;
+    }
+    sq_push(vm, -2);
+    sq_call(vm, 1, SQFalse, SQTrue);
+    sq_pop(vm, 2);
+    // The cost of running a command without arguments
+    const double base = CommandRun(vm, _SC("none"));
+    if (base < 0.0)
+    {
+        std::puts("  none       failed");
+        CommandClose(vm);
+        return 1;
+    }
+    std::printf("Command arguments, %d commands each:\n", g_CommandCount);
+    std::printf("  none       %8.1f ns per command\n", base);
+    // Measure the commands with arguments
+    bool success = true;
+    for (const SQChar * name : { _SC("int"), _SC("float"), _SC("bool"), _SC("string") })
+    {
+        const double ns = CommandRun(vm, name);
+        if (ns < 0.0)
+        {
+            std::printf("  %-10s failed\n", name);
+            success = false;
+        }
+        else
+        {
+            std::printf("  %-10s %8.1f ns per command, %6.1f ns per argument\n", name, ns, (ns - base) / 4.0);
+        }
+    }
+    CommandClose(vm);
+    return success ? 0 : 1;
+}
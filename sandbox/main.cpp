@@ -1,9 +1,32 @@
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+
+// ------------------------------------------------------------------------------------------------
+extern int AccessBenchmark();
+extern int AllocBenchmark(bool pool);
+extern int CommandBenchmark();
 
 // ------------------------------------------------------------------------------------------------
 int main(int argc, char **argv)
 {
-
-    return 0;
+    // Which benchmark should be executed?
+    if (argc > 1 && std::strcmp(argv[1], "access") == 0)
+    {
+        return AccessBenchmark();
+    }
+    else if (argc > 1 && std::strcmp(argv[1], "command") == 0)
+    {
+        return CommandBenchmark();
+    }
+    else if (argc > 2 && std::strcmp(argv[1], "alloc") == 0)
+    {
+        if (std::strcmp(argv[2], "pool") == 0 || std::strcmp(argv[2], "malloc") == 0)
+        {
+            return AllocBenchmark(std::strcmp(argv[2], "pool") == 0);
+        }
+    }
+    // Let the user know what can be executed
+    std::puts("Usage: sbox access | sbox command | sbox alloc pool | sbox alloc malloc");
+    return EXIT_FAILURE;
 }
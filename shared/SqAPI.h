@@ -118,6 +118,7 @@ extern "C" {
     typedef SQRESULT (*SqLibAPI_setinstanceup)(HSQUIRRELVM v, SQInteger idx, SQUserPointer p);
     typedef SQRESULT (*SqLibAPI_getinstanceup)(HSQUIRRELVM v, SQInteger idx, SQUserPointer *p,SQUserPointer typetag);
     typedef SQRESULT (*SqLibAPI_setclassudsize)(HSQUIRRELVM v, SQInteger idx, SQInteger udsize);
+    typedef SQRESULT (*SqLibAPI_setclassaccessors)(HSQUIRRELVM v,SQInteger idx);
     typedef SQRESULT (*SqLibAPI_newclass)(HSQUIRRELVM v,SQBool hasbase);
     typedef SQRESULT (*SqLibAPI_createinstance)(HSQUIRRELVM v,SQInteger idx);
     typedef SQRESULT (*SqLibAPI_setattributes)(HSQUIRRELVM v,SQInteger idx);
@@ -307,6 +308,7 @@ extern "C" {
         SqLibAPI_setinstanceup                      setinstanceup;
         SqLibAPI_getinstanceup                      getinstanceup;
         SqLibAPI_setclassudsize                     setclassudsize;
+        SqLibAPI_setclassaccessors                  setclassaccessors;
         SqLibAPI_newclass                           newclass;
         SqLibAPI_createinstance                     createinstance;
         SqLibAPI_setattributes                      setattributes;
@@ -492,6 +494,7 @@ extern "C" {
     extern SqLibAPI_setinstanceup                   SqLib_setinstanceup;
     extern SqLibAPI_getinstanceup                   SqLib_getinstanceup;
     extern SqLibAPI_setclassudsize                  SqLib_setclassudsize;
+    extern SqLibAPI_setclassaccessors               SqLib_setclassaccessors;
     extern SqLibAPI_newclass                        SqLib_newclass;
     extern SqLibAPI_createinstance                  SqLib_createinstance;
     extern SqLibAPI_setattributes                   SqLib_setattributes;
@@ -673,6 +676,7 @@ extern "C" {
     #define sq_setinstanceup                        SqLib_setinstanceup
     #define sq_getinstanceup                        SqLib_getinstanceup
     #define sq_setclassudsize                       SqLib_setclassudsize
+    #define sq_setclassaccessors                    SqLib_setclassaccessors
     #define sq_newclass                             SqLib_newclass
     #define sq_createinstance                       SqLib_createinstance
     #define sq_setattributes                        SqLib_setattributes
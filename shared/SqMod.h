@@ -60,6 +60,7 @@ extern "C" {
     #define SQMOD_TERMINATE_CMD     0xDEADC0DE
     #define SQMOD_CLOSING_CMD       0xBAAAAAAD
     #define SQMOD_RELEASED_CMD      0xDEADBEAF
+    #define SQMOD_PROFILER_CMD      0xDABBAD01
     #define SQMOD_API_VER           1
 
     //primitive functions
@@ -296,6 +296,7 @@ SqLibAPI_setnativeclosurename               SqLib_setnativeclosurename
 SqLibAPI_setinstanceup                      SqLib_setinstanceup                         = NULL;
 SqLibAPI_getinstanceup                      SqLib_getinstanceup                         = NULL;
 SqLibAPI_setclassudsize                     SqLib_setclassudsize                        = NULL;
+SqLibAPI_setclassaccessors                  SqLib_setclassaccessors                     = NULL;
 SqLibAPI_newclass                           SqLib_newclass                              = NULL;
 SqLibAPI_createinstance                     SqLib_createinstance                        = NULL;
 SqLibAPI_setattributes                      SqLib_setattributes                         = NULL;
@@ -488,6 +489,7 @@ uint8_t sqlib_api_expand(HSQLIBAPI sqlibapi)
     SqLib_setinstanceup                         = sqlibapi->setinstanceup;
     SqLib_getinstanceup                         = sqlibapi->getinstanceup;
     SqLib_setclassudsize                        = sqlibapi->setclassudsize;
+    SqLib_setclassaccessors                     = sqlibapi->setclassaccessors;
     SqLib_newclass                              = sqlibapi->newclass;
     SqLib_createinstance                        = sqlibapi->createinstance;
     SqLib_setattributes                         = sqlibapi->setattributes;
@@ -679,6 +681,7 @@ void sqlib_api_collapse()
     SqLib_setinstanceup                         = NULL;
     SqLib_getinstanceup                         = NULL;
     SqLib_setclassudsize                        = NULL;
+    SqLib_setclassaccessors                     = NULL;
     SqLib_newclass                              = NULL;
     SqLib_createinstance                        = NULL;
     SqLib_setattributes                         = NULL;
@@ -2,13 +2,47 @@
 #include "Base/ScriptSrc.hpp"
 
 // ------------------------------------------------------------------------------------------------
+#include <cctype>
 #include <cstdio>
+#include <cstring>
 #include <algorithm>
 #include <stdexcept>
+#include <unordered_map>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+static ScriptSrc::Names s_TagPaths; // The path of the script that owns each memory tag.
+
+/* ------------------------------------------------------------------------------------------------
+ * Helper class to restore the previous memory tag regardless of the situation.
+*/
+class MemoryTagGuard
+{
+public:
+
+    // --------------------------------------------------------------------------------------------
+    SQInteger mPrev; // The memory tag that was current before.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit MemoryTagGuard(SQInteger tag)
+        : mPrev(sq_setmemtag(tag))
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~MemoryTagGuard()
+    {
+        sq_setmemtag(mPrev);
+    }
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Helper class to ensure the file handle is closed regardless of the situation.
 */
@@ -79,6 +113,262 @@ public:
     }
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * Identifier and version of the bytecode cache files.
+*/
+#define SQMOD_BCC_MAGIC     0x43425153 // "SQBC"
+#define SQMOD_BCC_VERSION   1
+
+/* ------------------------------------------------------------------------------------------------
+ * Header written before the bytecode in a cache file.
+*/
+struct CacheHeader
+{
+    Uint32  mMagic; // Identifies a cache file.
+    Uint32  mVersion; // The version of the cache format.
+    Uint64  mKey; // Hash of the source contents and the compiler options.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Mix a block of memory into a FNV-1a hash.
+*/
+static inline Uint64 HashBytes(Uint64 hash, const void * data, size_t size)
+{
+    for (const unsigned char * ptr = static_cast< const unsigned char * >(data), * end = ptr + size; ptr != end; ++ptr)
+    {
+        hash = (hash ^ *ptr) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Position within a block of bytecode that is being read by the virtual machine.
+*/
+struct CodeCursor
+{
+    const String *  mCode; // The bytecode that is being read.
+    size_t          mPos; // The current read position.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Used by the virtual machine to read bytecode from memory.
+*/
+static SQInteger CodeReader(SQUserPointer cursor, SQUserPointer buf, SQInteger size)
+{
+    CodeCursor & cur = *static_cast< CodeCursor * >(cursor);
+    // Is there enough data left?
+    if (cur.mCode->size() - cur.mPos < static_cast< size_t >(size))
+    {
+        return -1; // Any partial read is an error
+    }
+    // Copy the requested amount of data
+    std::memcpy(buf, cur.mCode->data() + cur.mPos, static_cast< size_t >(size));
+    // Advance the read position
+    cur.mPos += static_cast< size_t >(size);
+    // Return the amount of data that was read
+    return size;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Used by the virtual machine to write bytecode to memory.
+*/
+static SQInteger CodeWriter(SQUserPointer code, SQUserPointer buf, SQInteger size)
+{
+    static_cast< String * >(code)->append(static_cast< CSStr >(buf), static_cast< size_t >(size));
+    // Return the amount of data that was written
+    return size;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Read the whole contents of a file without throwing errors.
+*/
+static bool ReadContents(CSStr path, String & data)
+{
+    std::FILE * fp = std::fopen(path, "rb");
+    // Was the file opened?
+    if (!fp)
+    {
+        return false;
+    }
+    // Go to the end of the file
+    std::fseek(fp, 0, SEEK_END);
+    // Calculate buffer size from beginning to current position
+    const LongI length = std::ftell(fp);
+    // Go back to the beginning
+    std::fseek(fp, 0, SEEK_SET);
+    // Read the file contents
+    bool ok = (length >= 0);
+    if (ok)
+    {
+        data.resize(static_cast< size_t >(length), 0);
+        ok = data.empty() || (std::fread(&data[0], 1, data.size(), fp) == data.size());
+    }
+    // Close the file
+    std::fclose(fp);
+    // Return whether the contents were read
+    return ok;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Compute an order independent hash of a value that can be stored in the constants table.
+*/
+static Uint64 HashConstant(HSQUIRRELVM vm, SQInteger idx)
+{
+    const SQObjectType type = sq_gettype(vm, idx);
+    // Start with the type of the value
+    Uint64 hash = HashBytes(14695981039346656037ULL, &type, sizeof(type));
+    // Mix the value itself
+    switch (type)
+    {
+        case OT_INTEGER:
+        {
+            SQInteger val = 0;
+            sq_getinteger(vm, idx, &val);
+            hash = HashBytes(hash, &val, sizeof(val));
+        } break;
+        case OT_FLOAT:
+        {
+            SQFloat val = 0;
+            sq_getfloat(vm, idx, &val);
+            hash = HashBytes(hash, &val, sizeof(val));
+        } break;
+        case OT_BOOL:
+        {
+            SQBool val = SQFalse;
+            sq_getbool(vm, idx, &val);
+            hash = HashBytes(hash, &val, sizeof(val));
+        } break;
+        case OT_STRING:
+        {
+            CSStr val = nullptr;
+            sq_getstring(vm, idx, &val);
+            hash = HashBytes(hash, val, static_cast< size_t >(sq_getsize(vm, idx)) * sizeof(SQChar));
+        } break;
+        case OT_TABLE:
+        {
+            const SQInteger tbl = (idx < 0) ? (sq_gettop(vm) + idx + 1) : idx;
+            // Combine the entries with addition so that the iteration order doesn't matter
+            sq_pushnull(vm);
+            while (SQ_SUCCEEDED(sq_next(vm, tbl)))
+            {
+                hash += HashConstant(vm, -2) * 31 + HashConstant(vm, -1);
+                sq_pop(vm, 2);
+            }
+            sq_pop(vm, 1);
+        } break;
+        default: break;
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Hash the constants table of a virtual machine and optionally remember the hash of each entry.
+*/
+static Uint64 HashConstants(HSQUIRRELVM vm, std::unordered_map< String, Uint64 > * entries)
+{
+    Uint64 hash = 0;
+    // Push the constants table on the stack
+    sq_pushconsttable(vm);
+    // Process every entry in the table
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        const Uint64 entry = HashConstant(vm, -2) * 31 + HashConstant(vm, -1);
+        // Remember the entry if necessary
+        CSStr name = nullptr;
+        if (entries && SQ_SUCCEEDED(sq_getstring(vm, -2, &name)))
+        {
+            (*entries)[name] = entry;
+        }
+        hash += entry;
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator and the table
+    sq_pop(vm, 2);
+    // Return the resulted hash
+    return hash;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Copy a value that can be stored in the constants table from one virtual machine to another.
+*/
+static bool CopyConstant(HSQUIRRELVM from, SQInteger idx, HSQUIRRELVM to)
+{
+    switch (sq_gettype(from, idx))
+    {
+        case OT_INTEGER:
+        {
+            SQInteger val = 0;
+            sq_getinteger(from, idx, &val);
+            sq_pushinteger(to, val);
+        } return true;
+        case OT_FLOAT:
+        {
+            SQFloat val = 0;
+            sq_getfloat(from, idx, &val);
+            sq_pushfloat(to, val);
+        } return true;
+        case OT_BOOL:
+        {
+            SQBool val = SQFalse;
+            sq_getbool(from, idx, &val);
+            sq_pushbool(to, val);
+        } return true;
+        case OT_STRING:
+        {
+            CSStr val = nullptr;
+            sq_getstring(from, idx, &val);
+            sq_pushstring(to, val, sq_getsize(from, idx));
+        } return true;
+        case OT_TABLE:
+        {
+            const SQInteger tbl = (idx < 0) ? (sq_gettop(from) + idx + 1) : idx;
+            // Create the destination table
+            sq_newtable(to);
+            // Copy every entry that can be copied
+            sq_pushnull(from);
+            while (SQ_SUCCEEDED(sq_next(from, tbl)))
+            {
+                if (CopyConstant(from, -2, to))
+                {
+                    if (CopyConstant(from, -1, to))
+                    {
+                        sq_newslot(to, -3, SQFalse);
+                    }
+                    else
+                    {
+                        sq_pop(to, 1);
+                    }
+                }
+                sq_pop(from, 2);
+            }
+            sq_pop(from, 1);
+        } return true;
+        default: return false;
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * See whether an identifier appears as a whole word in the specified source code.
+*/
+static bool HasIdentifier(const String & code, const String & name)
+{
+    const auto is_ident = [](CharT c) {
+        return (c == '_' || std::isalnum(static_cast< unsigned char >(c)));
+    };
+    // Look at every occurrence of the name
+    for (size_t pos = code.find(name); pos != String::npos; pos = code.find(name, pos + 1))
+    {
+        const size_t end = pos + name.size();
+        // Is this occurrence a separate word?
+        if ((pos == 0 || !is_ident(code[pos - 1])) && (end >= code.size() || !is_ident(code[end])))
+        {
+            return true;
+        }
+    }
+    // The identifier was not found
+    return false;
+}
 
 // ------------------------------------------------------------------------------------------------
 void ScriptSrc::Process()
@@ -140,14 +430,312 @@ void ScriptSrc::Process()
     mInfo = true;
 }
 
+// ------------------------------------------------------------------------------------------------
+HSQUIRRELVM ScriptSrc::CreateScratch(HSQUIRRELVM vm)
+{
+    HSQUIRRELVM scratch = sq_open(1024);
+    // Was the virtual machine created?
+    if (!scratch)
+    {
+        return nullptr;
+    }
+    // Scripts are compiled against the constants known at the time (enums registered by the module)
+    sq_pushconsttable(vm);
+    sq_pushconsttable(scratch);
+    // Copy every entry that can be copied
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        if (CopyConstant(vm, -2, scratch))
+        {
+            if (CopyConstant(vm, -1, scratch))
+            {
+                sq_newslot(scratch, -3, SQFalse);
+            }
+            else
+            {
+                sq_pop(scratch, 1);
+            }
+        }
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator and the tables
+    sq_pop(vm, 2);
+    sq_pop(scratch, 1);
+    // Return the scratch virtual machine
+    return scratch;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Precompile(HSQUIRRELVM vm, const String & cache)
+{
+    // Discard any previous results
+    mCode.clear();
+    mCached = false;
+    mDeclared.clear();
+    // Should we index the lines of code for debugging purposes?
+    if (mInfo && mData.empty())
+    {
+        try
+        {
+            Process();
+        }
+        catch (const std::exception &)
+        {
+            return false; // Let the regular compilation report the error
+        }
+    }
+    // Obtain the contents of the script
+    String temp;
+    const String * data = &mData;
+    if (mData.empty())
+    {
+        if (!ReadContents(mPath.c_str(), temp))
+        {
+            return false; // Let the regular compilation report the error
+        }
+        data = &temp;
+    }
+    // Is this script empty or already compiled?
+    if (data->size() < 2 || *reinterpret_cast< const Uint16 * >(data->data()) == SQ_BYTECODE_STREAM_TAG)
+    {
+        return false;
+    }
+    // Constants are inlined by the compiler so they're part of the generated bytecode
+    std::unordered_map< String, Uint64 > consts;
+    const Uint64 consts_hash = HashConstants(vm, &consts);
+    // The options that change the generated bytecode
+    const Uint32 options[] = {
+        SQMOD_BCC_VERSION, SQUIRREL_VERSION_NUMBER,
+        sizeof(SQInteger), sizeof(SQFloat), sizeof(SQChar), sizeof(SQUserPointer)
+    };
+    // Generate the key that the cached bytecode must match
+    Uint64 key = HashBytes(14695981039346656037ULL, options, sizeof(options));
+    key = HashBytes(key, &consts_hash, sizeof(consts_hash));
+    key = HashBytes(key, mPath.data(), mPath.size());
+    key = HashBytes(key, data->data(), data->size());
+    // Generate the path of the cache file from the script path and the known constants
+    String file;
+    if (!cache.empty())
+    {
+        CharT name[32];
+        std::snprintf(name, sizeof(name), "%016llx.cnut", static_cast< unsigned long long >(
+                        HashBytes(HashBytes(14695981039346656037ULL, &consts_hash, sizeof(consts_hash)),
+                                    mPath.data(), mPath.size())));
+        file.assign(cache);
+        // Make sure the directory and the name are separated
+        if (file.back() != '/' && file.back() != '\\')
+        {
+            file.push_back('/');
+        }
+        file.append(name);
+        // Attempt to load the cached bytecode
+        String contents;
+        CacheHeader hdr;
+        if (ReadContents(file.c_str(), contents) && contents.size() > sizeof(hdr))
+        {
+            std::memcpy(&hdr, contents.data(), sizeof(hdr));
+            // Does the cached bytecode belong to this version of the script?
+            if (hdr.mMagic == SQMOD_BCC_MAGIC && hdr.mVersion == SQMOD_BCC_VERSION && hdr.mKey == key)
+            {
+                mCode.assign(contents, sizeof(hdr), String::npos);
+                mCached = true;
+                // The bytecode is ready to be loaded
+                return true;
+            }
+        }
+    }
+    // Skip the UTF-8 byte order mark, like the file loader does
+    size_t skip = 0;
+    if (data->size() >= 3 && data->compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+        skip = 3;
+    }
+    // Compile the contents and serialize the resulted closure
+    if (SQ_FAILED(sq_compilebuffer(vm, data->data() + skip, static_cast< SQInteger >(data->size() - skip),
+                                    mPath.c_str(), SQFalse)) || SQ_FAILED(sq_writeclosure(vm, CodeWriter, &mCode)))
+    {
+        mCode.clear();
+        // Let the regular compilation report the error
+        return false;
+    }
+    // Pop the compiled closure
+    sq_pop(vm, 1);
+    // Did the script declare any constants?
+    if (HashConstants(vm, nullptr) != consts_hash)
+    {
+        std::unordered_map< String, Uint64 > after;
+        HashConstants(vm, &after);
+        // Remember which constants were declared or modified
+        for (const auto & c : after)
+        {
+            auto itr = consts.find(c.first);
+            if (itr == consts.end() || itr->second != c.second)
+            {
+                mDeclared.push_back(c.first);
+            }
+        }
+        // Loading the bytecode would not declare them so this must be compiled in the script VM
+        mCode.clear();
+        return false;
+    }
+    // Write the bytecode to a temporary file first so that others never see a partial file
+    const String temp_file(file + ".tmp");
+    std::FILE * fp = file.empty() ? nullptr : std::fopen(temp_file.c_str(), "wb");
+    if (fp)
+    {
+        const CacheHeader hdr{SQMOD_BCC_MAGIC, SQMOD_BCC_VERSION, key};
+        // Write the header and the bytecode
+        bool ok = (std::fwrite(&hdr, sizeof(hdr), 1, fp) == 1) &&
+                    (std::fwrite(mCode.data(), 1, mCode.size(), fp) == mCode.size());
+        // Close the file
+        ok = (std::fclose(fp) == 0) && ok;
+        // Replace the previous cache file
+        std::remove(file.c_str());
+        if (!ok || std::rename(temp_file.c_str(), file.c_str()) != 0)
+        {
+            std::remove(temp_file.c_str());
+        }
+    }
+    // The bytecode is ready to be loaded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Compile(const String & cache)
+{
+    // Grab the virtual machine of the script
+    HSQUIRRELVM vm = mExec.GetVM();
+    // The functions remember the tag that was current when they were created
+    MemoryTagGuard mtg(mTag);
+    // Should we attempt to compile through the cache?
+    if (mCode.empty() && !cache.empty())
+    {
+        HSQUIRRELVM scratch = CreateScratch(vm);
+        // Was the scratch virtual machine created?
+        if (scratch)
+        {
+            Precompile(scratch, cache);
+            sq_close(scratch);
+        }
+    }
+    // Was the script compiled in advance?
+    if (!mCode.empty())
+    {
+        // Attempt to load the compiled closure
+        CodeCursor cur{&mCode, 0};
+        const bool loaded = SQ_SUCCEEDED(sq_readclosure(vm, CodeReader, &cur));
+        // The bytecode is no longer needed
+        String().swap(mCode);
+        // Was the closure loaded?
+        if (loaded)
+        {
+            // Take ownership of the closure on the stack
+            static_cast< Object & >(mExec) = Object(-1, vm);
+            sq_pop(vm, 1);
+            // Let the caller know where the bytecode came from
+            return mCached;
+        }
+    }
+    // Should we index the lines of code for debugging purposes?
+    if (mInfo && mData.empty())
+    {
+        Process();
+    }
+    // Remember the constants before compiling
+    std::unordered_map< String, Uint64 > consts;
+    const Uint64 consts_hash = HashConstants(vm, &consts);
+    // Compile the script from source
+    mExec.CompileFile(mPath);
+    // Remember which constants were declared or modified
+    mDeclared.clear();
+    if (HashConstants(vm, nullptr) != consts_hash)
+    {
+        std::unordered_map< String, Uint64 > after;
+        HashConstants(vm, &after);
+        // Find the entries that are new or different
+        for (const auto & c : after)
+        {
+            auto itr = consts.find(c.first);
+            if (itr == consts.end() || itr->second != c.second)
+            {
+                mDeclared.push_back(c.first);
+            }
+        }
+    }
+    // Nothing was loaded from the cache
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool ScriptSrc::Uses(const Names & names) const
+{
+    // Obtain the contents of the script
+    String temp;
+    const String * data = &mData;
+    if (mData.empty())
+    {
+        if (!ReadContents(mPath.c_str(), temp))
+        {
+            return true; // Assume the worst
+        }
+        data = &temp;
+    }
+    // Look for any of the specified identifiers
+    for (const auto & n : names)
+    {
+        if (HasIdentifier(*data, n))
+        {
+            return true;
+        }
+    }
+    // None of the identifiers are used
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger ScriptSrc::AcquireTag(const String & path)
+{
+    // Was this script loaded before?
+    Names::iterator itr = std::find(s_TagPaths.begin(), s_TagPaths.end(), path);
+    // Reuse the previous tag so that reloaded scripts are not counted twice
+    if (itr != s_TagPaths.end())
+    {
+        return static_cast< SQInteger >(itr - s_TagPaths.begin()) + 1;
+    }
+    // Are there any tags left?
+    else if (s_TagPaths.size() >= static_cast< size_t >(SQ_MEMTAG_MAX - 2))
+    {
+        return SQ_MEMTAG_MAX - 1;
+    }
+    // Assign the next tag
+    s_TagPaths.push_back(path);
+    // Return the assigned tag
+    return static_cast< SQInteger >(s_TagPaths.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+const String * ScriptSrc::GetTagPath(SQInteger tag)
+{
+    if (tag < 1 || static_cast< size_t >(tag) > s_TagPaths.size())
+    {
+        return nullptr;
+    }
+    return &s_TagPaths[static_cast< size_t >(tag) - 1];
+}
+
 // ------------------------------------------------------------------------------------------------
 ScriptSrc::ScriptSrc(HSQUIRRELVM vm, String && path, bool delay, bool info)
     : mExec(vm)
     , mPath(std::move(path))
     , mData()
     , mLine()
+    , mCode()
     , mInfo(info)
     , mDelay(delay)
+    , mCached(false)
+    , mDeclared()
+    , mTag(0)
 {
     // Is the specified virtual machine invalid?
     if (!vm)
@@ -159,11 +747,9 @@ ScriptSrc::ScriptSrc(HSQUIRRELVM vm, String && path, bool delay, bool info)
     {
         throw std::runtime_error("Invalid or empty script path");
     }
-    // Should we load the file contents for debugging purposes?
-    else if (mInfo)
-    {
-        Process();
-    }
+    // Attribute the allocations of this script
+    mTag = AcquireTag(mPath);
+    // The file contents are loaded for debugging purposes when the script is compiled
 }
 
 } // Namespace::  SqMod
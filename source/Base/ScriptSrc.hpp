@@ -23,20 +23,60 @@ public:
 
     // --------------------------------------------------------------------------------------------
     typedef std::vector< Uint32 > Line;
+    typedef std::vector< String > Names;
 
     // --------------------------------------------------------------------------------------------
     Script      mExec; // Reference to the script object.
     String      mPath; // Path to the script file.
     String      mData; // The contents of the script file.
     Line        mLine; // List of lines of code in the data.
+    String      mCode; // Compiled bytecode waiting to be loaded into the virtual machine.
     bool        mInfo; // Whether this script contains line information.
     bool        mDelay; // Don't execute immediately after compilation.
+    bool        mCached; // Whether the compiled bytecode was loaded from the cache.
+    Names       mDeclared; // Constants declared or modified when this script was compiled.
+    SQInteger   mTag; // Memory tag that the allocations made by this script are attributed to.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the memory tag of the script with the specified path, assigning one if necessary.
+     * Tag zero is used for allocations outside of scripts and the last tag is shared by the
+     * scripts that loaded after all the other tags were taken.
+    */
+    static SQInteger AcquireTag(const String & path);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the path of the script that owns the specified memory tag or null if none.
+    */
+    static const String * GetTagPath(SQInteger tag);
 
     /* --------------------------------------------------------------------------------------------
      * Read file contents and calculate information about the lines of code.
     */
     void Process();
 
+    /* --------------------------------------------------------------------------------------------
+     * Create a virtual machine used only for compiling, with a copy of the constants of another one.
+    */
+    static HSQUIRRELVM CreateScratch(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Read, index and compile the script into bytecode using the specified scratch virtual machine.
+     * Safe to call from worker threads. Returns true if the bytecode is ready to be loaded. Scripts
+     * that declare constants are left to be compiled in the virtual machine of the script.
+    */
+    bool Precompile(HSQUIRRELVM vm, const String & cache);
+
+    /* --------------------------------------------------------------------------------------------
+     * Compile the script, using the bytecode in the cache directory if it is still valid.
+     * Returns true if the bytecode was loaded from the cache.
+    */
+    bool Compile(const String & cache);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the source code of the script uses any of the specified identifiers.
+    */
+    bool Uses(const Names & names) const;
+
     /* --------------------------------------------------------------------------------------------
      * Base constructor.
     */
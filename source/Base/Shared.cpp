@@ -209,6 +209,30 @@ const ULongInt & GetULongInt(CSStr s)
     return l;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool IsFunctionFrom(const HSQOBJECT & func, CSStr source)
+{
+    // Only script closures remember where they came from
+    if (!sq_isclosure(func))
+    {
+        return false;
+    }
+    // Grab the virtual machine once
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Remember the current stack size
+    const StackGuard sg(vm);
+    // Push the function on the stack
+    sq_pushobject(vm, func);
+    // Attempt to retrieve the name of the source file
+    CSStr name = nullptr;
+    if (SQ_FAILED(sq_getclosuresource(vm, -1)) || SQ_FAILED(sq_getstring(vm, -1, &name)))
+    {
+        return false;
+    }
+    // Compare the source file names
+    return (std::strcmp(name, source) == 0);
+}
+
 // ------------------------------------------------------------------------------------------------
 bool NameFilterCheck(CSStr filter, CSStr name)
 {
@@ -208,6 +208,11 @@ extern void InitSignalPair(SignalPair & sp, LightObj & et, const char * name);
 */
 extern void ResetSignalPair(SignalPair & sp, bool clear = true);
 
+/* ------------------------------------------------------------------------------------------------
+ * See whether the specified function was compiled from the specified script file.
+*/
+bool IsFunctionFrom(const HSQOBJECT & func, CSStr source);
+
 /* ------------------------------------------------------------------------------------------------
  * A simple implementation of name filtering.
 */
@@ -0,0 +1,257 @@
+// ------------------------------------------------------------------------------------------------
+#include "Collector.hpp"
+#include "Core.hpp"
+#include "Library/Chrono.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Int64   Collector::s_Baseline = 0;
+Int64   Collector::s_LastTime = 0;
+Int64   Collector::s_Growth = SQMOD_COLLECTOR_GROWTH * 1024LL;
+Int64   Collector::s_Interval = SQMOD_COLLECTOR_INTERVAL * 1000LL;
+Int64   Collector::s_Budget = SQMOD_COLLECTOR_BUDGET * 1000LL;
+Int32   Collector::s_LowPlayers = SQMOD_COLLECTOR_LOW_PLAYERS;
+Uint32  Collector::s_Deferred = 0;
+bool    Collector::s_Enabled = true;
+
+// ------------------------------------------------------------------------------------------------
+Uint32  Collector::s_Count = 0;
+Uint32  Collector::s_Forced = 0;
+Int64   Collector::s_LastDuration = 0;
+Int64   Collector::s_MaxDuration = 0;
+Int64   Collector::s_TotalDuration = 0;
+Int64   Collector::s_LastFreed = 0;
+Int64   Collector::s_TotalFreed = 0;
+Int64   Collector::s_LastReclaimed = 0;
+Int64   Collector::s_TotalReclaimed = 0;
+
+// ------------------------------------------------------------------------------------------------
+Int64 Collector::GetAllocated()
+{
+    SQMemPoolStats stats;
+    // Retrieve the allocator statistics
+    sq_getmempoolstats(&stats);
+    // Return the live bytes
+    return static_cast< Int64 >(stats.live);
+}
+
+// ------------------------------------------------------------------------------------------------
+Int32 Collector::GetPlayers()
+{
+    Int32 count = 0;
+    // Count the player slots that are in use
+    for (const auto & inst : Core::Get().GetPlayers())
+    {
+        if (VALID_ENTITY(inst.mID))
+        {
+            ++count;
+        }
+    }
+    // Return the number of connected players
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Collector::Collect()
+{
+    const Int64 before = GetAllocated();
+    const Int64 start = Chrono::GetCurrentSysTime();
+    // Run the cycle collector of the virtual machine
+    const SQInteger freed = sq_collectgarbage(DefaultVM::Get());
+    // Measure the collection
+    s_LastTime = Chrono::GetCurrentSysTime();
+    s_LastDuration = s_LastTime - start;
+    s_Baseline = GetAllocated();
+    // Update the metrics
+    ++s_Count;
+    s_MaxDuration = std::max(s_MaxDuration, s_LastDuration);
+    s_TotalDuration += s_LastDuration;
+    s_LastFreed = ClampMin(static_cast< Int64 >(freed), 0LL);
+    s_TotalFreed += s_LastFreed;
+    s_LastReclaimed = ClampMin(before - s_Baseline, 0LL);
+    s_TotalReclaimed += s_LastReclaimed;
+    // Return the number of released objects
+    return freed;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::Resume()
+{
+    if (!s_Deferred)
+    {
+        STHROWF("Garbage collection was not deferred");
+    }
+    --s_Deferred;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::SetThreshold(SQInteger kb)
+{
+    if (kb < 1)
+    {
+        STHROWF("Invalid collection threshold: %lld", static_cast< Int64 >(kb));
+    }
+    s_Growth = static_cast< Int64 >(kb) * 1024LL;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::SetInterval(SQInteger ms)
+{
+    if (ms < 0)
+    {
+        STHROWF("Invalid collection interval: %lld", static_cast< Int64 >(ms));
+    }
+    s_Interval = static_cast< Int64 >(ms) * 1000LL;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::SetBudget(SQInteger ms)
+{
+    if (ms < 0)
+    {
+        STHROWF("Invalid collection budget: %lld", static_cast< Int64 >(ms));
+    }
+    s_Budget = static_cast< Int64 >(ms) * 1000LL;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::SetLowPlayers(SQInteger count)
+{
+    if (count < 0)
+    {
+        STHROWF("Invalid player count: %lld", static_cast< Int64 >(count));
+    }
+    s_LowPlayers = ConvTo< Int32 >::From(count);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Collector::GetStats(HSQUIRRELVM vm)
+{
+    // Create the table with the metrics
+    Table tbl(vm);
+    tbl.SetValue(_SC("Count"), static_cast< SQInteger >(s_Count));
+    tbl.SetValue(_SC("Forced"), static_cast< SQInteger >(s_Forced));
+    tbl.SetValue(_SC("LastDuration"), static_cast< SQInteger >(s_LastDuration));
+    tbl.SetValue(_SC("MaxDuration"), static_cast< SQInteger >(s_MaxDuration));
+    tbl.SetValue(_SC("TotalDuration"), static_cast< SQInteger >(s_TotalDuration));
+    tbl.SetValue(_SC("LastFreed"), static_cast< SQInteger >(s_LastFreed));
+    tbl.SetValue(_SC("TotalFreed"), static_cast< SQInteger >(s_TotalFreed));
+    tbl.SetValue(_SC("LastReclaimed"), static_cast< SQInteger >(s_LastReclaimed));
+    tbl.SetValue(_SC("TotalReclaimed"), static_cast< SQInteger >(s_TotalReclaimed));
+    tbl.SetValue(_SC("Growth"), GetGrowth());
+    // Push the table on the stack
+    sq_pushobject(vm, tbl.GetObject());
+    // We have an argument on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::ResetStats()
+{
+    s_Count = 0;
+    s_Forced = 0;
+    s_LastDuration = 0;
+    s_MaxDuration = 0;
+    s_TotalDuration = 0;
+    s_LastFreed = 0;
+    s_TotalFreed = 0;
+    s_LastReclaimed = 0;
+    s_TotalReclaimed = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::Process()
+{
+    // Are collections scheduled and allowed at this time?
+    if (!s_Enabled || s_Deferred)
+    {
+        return;
+    }
+    const Int64 now = Chrono::GetCurrentSysTime();
+    // Start measuring from the first processed frame
+    if (!s_LastTime)
+    {
+        s_LastTime = now;
+        s_Baseline = GetAllocated();
+        return;
+    }
+    const Int64 growth = GetAllocated() - s_Baseline;
+    // The collector can't be interrupted so the duration of the last collection is the estimate
+    if (growth >= s_Growth * 4)
+    {
+        // Memory grows too fast to keep waiting for a better moment
+        if (s_LastDuration > s_Budget)
+        {
+            ++s_Forced;
+        }
+    }
+    else if (growth >= s_Growth)
+    {
+        // Wait for fewer players if the collection is not expected to fit in the budget
+        if (s_LastDuration > s_Budget && GetPlayers() > s_LowPlayers)
+        {
+            return;
+        }
+    }
+    // Collect periodically while the server is mostly idle
+    else if (!s_Interval || growth <= 0 || (now - s_LastTime) < s_Interval || GetPlayers() > s_LowPlayers)
+    {
+        return;
+    }
+    // Perform the collection
+    Collect();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Collector::Terminate()
+{
+    s_Deferred = 0;
+    s_LastTime = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to schedule the garbage collection.
+*/
+void ProcessCollector()
+{
+    Collector::Process();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate the collector.
+*/
+void TerminateCollector()
+{
+    Collector::Terminate();
+}
+
+// ================================================================================================
+void Register_Collector(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqCollector"), Table(vm)
+        .Func(_SC("Collect"), &Collector::Collect)
+        .Func(_SC("Defer"), &Collector::Defer)
+        .Func(_SC("Resume"), &Collector::Resume)
+        .Func(_SC("IsDeferred"), &Collector::IsDeferred)
+        .Func(_SC("GetEnabled"), &Collector::GetEnabled)
+        .Func(_SC("SetEnabled"), &Collector::SetEnabled)
+        .Func(_SC("GetGrowth"), &Collector::GetGrowth)
+        .Func(_SC("GetThreshold"), &Collector::GetThreshold)
+        .Func(_SC("SetThreshold"), &Collector::SetThreshold)
+        .Func(_SC("GetInterval"), &Collector::GetInterval)
+        .Func(_SC("SetInterval"), &Collector::SetInterval)
+        .Func(_SC("GetBudget"), &Collector::GetBudget)
+        .Func(_SC("SetBudget"), &Collector::SetBudget)
+        .Func(_SC("GetLowPlayers"), &Collector::GetLowPlayers)
+        .Func(_SC("SetLowPlayers"), &Collector::SetLowPlayers)
+        .SquirrelFunc(_SC("GetStats"), &Collector::GetStats)
+        .Func(_SC("ResetStats"), &Collector::ResetStats)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,175 @@
+#ifndef _COLLECTOR_HPP_
+#define _COLLECTOR_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Schedule the cycle collector of the virtual machine based on allocation growth and server load.
+*/
+class Collector
+{
+private:
+
+    // --------------------------------------------------------------------------------------------
+    static Int64    s_Baseline; // Bytes allocated by the virtual machine after the last collection.
+    static Int64    s_LastTime; // The time when the last collection finished.
+    static Int64    s_Growth; // Bytes allocated since the last collection that trigger a collection.
+    static Int64    s_Interval; // Microseconds between collections while few players are connected.
+    static Int64    s_Budget; // Microseconds that a collection is expected to fit in.
+    static Int32    s_LowPlayers; // Maximum number of players for the interval collection.
+    static Uint32   s_Deferred; // The number of pending requests to defer collections.
+    static bool     s_Enabled; // Whether collections are scheduled automatically.
+
+    // --------------------------------------------------------------------------------------------
+    static Uint32   s_Count; // The number of performed collections.
+    static Uint32   s_Forced; // The number of collections forced despite not fitting the time budget.
+    static Int64    s_LastDuration; // Microseconds spent in the last collection.
+    static Int64    s_MaxDuration; // Microseconds spent in the longest collection.
+    static Int64    s_TotalDuration; // Microseconds spent in all collections.
+    static Int64    s_LastFreed; // Objects released by the last collection.
+    static Int64    s_TotalFreed; // Objects released by all collections.
+    static Int64    s_LastReclaimed; // Bytes released by the last collection.
+    static Int64    s_TotalReclaimed; // Bytes released by all collections.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes currently allocated by the virtual machine.
+    */
+    static Int64 GetAllocated();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of connected players.
+    */
+    static Int32 GetPlayers();
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Perform a collection now and return the number of released objects.
+    */
+    static SQInteger Collect();
+
+    /* --------------------------------------------------------------------------------------------
+     * Prevent automatic collections until a matching call to resume.
+    */
+    static void Defer()
+    {
+        ++s_Deferred;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Cancel a previous request to defer automatic collections.
+    */
+    static void Resume();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether automatic collections are deferred.
+    */
+    static bool IsDeferred()
+    {
+        return (s_Deferred > 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether collections are scheduled automatically.
+    */
+    static bool GetEnabled()
+    {
+        return s_Enabled;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether collections are scheduled automatically.
+    */
+    static void SetEnabled(bool toggle)
+    {
+        s_Enabled = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of bytes allocated since the last collection.
+    */
+    static SQInteger GetGrowth()
+    {
+        return static_cast< SQInteger >(GetAllocated() - s_Baseline);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the kilobytes allocated since the last collection that trigger a collection.
+    */
+    static SQInteger GetThreshold()
+    {
+        return static_cast< SQInteger >(s_Growth / 1024);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the kilobytes allocated since the last collection that trigger a collection.
+    */
+    static void SetThreshold(SQInteger kb);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds between collections while few players are connected.
+    */
+    static SQInteger GetInterval()
+    {
+        return static_cast< SQInteger >(s_Interval / 1000);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds between collections while few players are connected.
+    */
+    static void SetInterval(SQInteger ms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds that a collection is expected to fit in.
+    */
+    static SQInteger GetBudget()
+    {
+        return static_cast< SQInteger >(s_Budget / 1000);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds that a collection is expected to fit in.
+    */
+    static void SetBudget(SQInteger ms);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of players for the interval collection.
+    */
+    static SQInteger GetLowPlayers()
+    {
+        return static_cast< SQInteger >(s_LowPlayers);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of players for the interval collection.
+    */
+    static void SetLowPlayers(SQInteger count);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the collection metrics.
+    */
+    static SQInteger GetStats(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Reset the collection metrics.
+    */
+    static void ResetStats();
+
+    /* --------------------------------------------------------------------------------------------
+     * Perform a collection if the growth, the interval and the server load allow it.
+    */
+    static void Process();
+
+    /* --------------------------------------------------------------------------------------------
+     * Cancel any pending requests to defer collections.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _COLLECTOR_HPP_
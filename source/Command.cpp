@@ -1,5 +1,7 @@
 // ------------------------------------------------------------------------------------------------
 #include "Command.hpp"
+#include "Entity/Player.hpp"
+#include "Library/Chrono.hpp"
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -19,7 +21,7 @@ SQMODE_DECL_TYPENAME(ListenerTypename, _SC("SqCmdListener"))
 Guard::Guard(const CtrRef & ctr, Object & invoker)
     : mController(ctr)
     , mPrevious(mController->m_Context)
-    , mCurrent(new Context(invoker))
+    , mCurrent(mController->AcquireCtx(invoker))
 {
     mController->m_Context = mCurrent;
 }
@@ -28,6 +30,43 @@ Guard::Guard(const CtrRef & ctr, Object & invoker)
 Guard::~Guard()
 {
     mController->m_Context = mPrevious;
+    mController->ReleaseCtx(mCurrent);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a script integer without going through the VM stack.
+*/
+static inline Object MakeInteger(SQInteger value)
+{
+    HSQOBJECT obj;
+    sq_resetobject(&obj);
+    obj._type = OT_INTEGER;
+    obj._unVal.nInteger = value;
+    return Object(obj, DefaultVM::Get());
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a script float without going through the VM stack.
+*/
+static inline Object MakeFloat(SQFloat value)
+{
+    HSQOBJECT obj;
+    sq_resetobject(&obj);
+    obj._type = OT_FLOAT;
+    obj._unVal.fFloat = value;
+    return Object(obj, DefaultVM::Get());
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a script boolean without going through the VM stack.
+*/
+static inline Object MakeBool(bool value)
+{
+    HSQOBJECT obj;
+    sq_resetobject(&obj);
+    obj._type = OT_BOOL;
+    obj._unVal.nInteger = value ? 1 : 0;
+    return Object(obj, DefaultVM::Get());
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -130,23 +169,358 @@ Object & Controller::Attach(Object && obj, Listener * ptr)
     }
     // Obtain the unique identifier of the specified name
     const std::size_t hash = std::hash< String >()(name);
+    // Attempt to find a command with the same hash
+    const Int32 idx = Find(hash);
     // Make sure the command doesn't already exist
-    for (const auto & cmd : m_Commands)
+    if (idx >= 0)
     {
-        // Are the hashes identical?
-        if (cmd.mHash == hash)
-        {
-            // Include information necessary to help identify hash collisions!
-            STHROWF("Command '%s' already exists as '%s' for hash (%zu)",
-                        name.c_str(), cmd.mName.c_str(), hash);
-        }
+        // Include information necessary to help identify hash collisions!
+        STHROWF("Command '%s' already exists as '%s' for hash (%zu)",
+                    name.c_str(), m_Commands[idx].mName.c_str(), hash);
     }
     // Attempt to insert the command
     m_Commands.emplace_back(hash, name, ptr, std::move(obj), m_Manager->GetCtr());
+    // Include the command in the lookup structures
+    Index(static_cast< Uint32 >(m_Commands.size() - 1));
+    TrieInsert(name, hash);
+    TrigramInsert(name, hash);
     // Return the script object of the listener
     return m_Commands.back().mObj;
 }
 
+// ------------------------------------------------------------------------------------------------
+void Controller::Erase(Commands::iterator itr)
+{
+    // Remove the command name from the lookup structures
+    TrieRemove(itr->mName, itr->mHash);
+    TrigramRemove(itr->mName, itr->mHash);
+    // Remove the command from the list
+    m_Commands.erase(itr);
+    // The indexes of the following commands have changed
+    Reindex();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::Index(Uint32 idx)
+{
+    // Keep the load factor of the hash table below one half
+    if ((m_Commands.size() * 2) > m_Slots.size())
+    {
+        Reindex(); // Will include the specified command as well
+        return;
+    }
+    // The table size is always a power of two
+    const std::size_t mask = m_Slots.size() - 1;
+    // Find the first empty slot after the ideal position
+    std::size_t pos = (m_Commands[idx].mHash & mask);
+    while (m_Slots[pos] != 0)
+    {
+        pos = ((pos + 1) & mask);
+    }
+    // Store the command index in the slot
+    m_Slots[pos] = (idx + 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::Reindex()
+{
+    // Find the smallest power of two that keeps the load factor below one half
+    std::size_t size = 16;
+    while (size < (m_Commands.size() * 2))
+    {
+        size <<= 1;
+    }
+    // Discard the current slots
+    m_Slots.assign(size, 0);
+    // The table size is always a power of two
+    const std::size_t mask = size - 1;
+    // Insert all commands again
+    for (Uint32 idx = 0; idx < m_Commands.size(); ++idx)
+    {
+        std::size_t pos = (m_Commands[idx].mHash & mask);
+        // Find the first empty slot after the ideal position
+        while (m_Slots[pos] != 0)
+        {
+            pos = ((pos + 1) & mask);
+        }
+        // Store the command index in the slot
+        m_Slots[pos] = (idx + 1);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::TrieInsert(const String & name, std::size_t hash)
+{
+    Uint32 node = 0;
+    // Walk the tree and create the missing nodes
+    for (const auto c : name)
+    {
+        // The tree is case insensitive
+        const SQChar l = static_cast< SQChar >(std::tolower(static_cast< unsigned char >(c)));
+        // This command passes through the current node
+        ++m_Nodes[node].mCount;
+        // Look for the node of this character
+        auto itr = std::find_if(m_Nodes[node].mNodes.begin(), m_Nodes[node].mNodes.end(),
+                                [l](const std::pair< SQChar, Uint32 > & n) { return n.first == l; });
+        // Does the node exist?
+        if (itr != m_Nodes[node].mNodes.end())
+        {
+            node = itr->second;
+        }
+        else
+        {
+            const Uint32 next = static_cast< Uint32 >(m_Nodes.size());
+            // Create the node (may invalidate references to other nodes)
+            m_Nodes.emplace_back();
+            // Link it to the parent
+            m_Nodes[node].mNodes.emplace_back(l, next);
+            // Move to the new node
+            node = next;
+        }
+    }
+    // The command ends at this node
+    ++m_Nodes[node].mCount;
+    m_Nodes[node].mHashes.push_back(hash);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::TrieRemove(const String & name, std::size_t hash)
+{
+    Uint32 node = 0;
+    // Walk the tree and update the counters
+    for (const auto c : name)
+    {
+        // The tree is case insensitive
+        const SQChar l = static_cast< SQChar >(std::tolower(static_cast< unsigned char >(c)));
+        // This command no longer passes through the current node
+        --m_Nodes[node].mCount;
+        // Look for the node of this character
+        auto itr = std::find_if(m_Nodes[node].mNodes.begin(), m_Nodes[node].mNodes.end(),
+                                [l](const std::pair< SQChar, Uint32 > & n) { return n.first == l; });
+        // The node must exist if the command was inserted
+        if (itr == m_Nodes[node].mNodes.end())
+        {
+            return;
+        }
+        node = itr->second;
+    }
+    // The command no longer ends at this node
+    --m_Nodes[node].mCount;
+    CmdHashes & hashes = m_Nodes[node].mHashes;
+    hashes.erase(std::remove(hashes.begin(), hashes.end(), hash), hashes.end());
+}
+
+// ------------------------------------------------------------------------------------------------
+Int32 Controller::TrieFind(CSStr prefix) const
+{
+    Uint32 node = 0;
+    // Walk the tree until the end of the prefix
+    for (; *prefix != '\0'; ++prefix)
+    {
+        // The tree is case insensitive
+        const SQChar l = static_cast< SQChar >(std::tolower(static_cast< unsigned char >(*prefix)));
+        // Look for the node of this character
+        auto itr = std::find_if(m_Nodes[node].mNodes.cbegin(), m_Nodes[node].mNodes.cend(),
+                                [l](const std::pair< SQChar, Uint32 > & n) { return n.first == l; });
+        // Does any command continue with this character?
+        if (itr == m_Nodes[node].mNodes.cend() || m_Nodes[itr->second].mCount == 0)
+        {
+            return -1;
+        }
+        node = itr->second;
+    }
+    // Return the node where the prefix ended
+    return static_cast< Int32 >(node);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Extract the distinct trigrams of a name, padded so that short names and prefixes also match.
+*/
+static void ExtractTrigrams(CSStr name, std::vector< Uint32 > & out)
+{
+    out.clear();
+    // Start with the leading padding
+    Uint32 tri = (static_cast< Uint32 >(' ') << 8) | static_cast< Uint32 >(' ');
+    // Shift every lowercase character and the trailing padding through the trigram
+    for (bool last = false; !last; ++name)
+    {
+        last = (*name == '\0');
+        // The index is case insensitive
+        const Uint32 c = last ? ' ' : static_cast< Uint8 >(std::tolower(static_cast< unsigned char >(*name)));
+        // Shift the character into the trigram
+        tri = ((tri << 8) | c) & 0xFFFFFF;
+        out.push_back(tri);
+    }
+    // Remove the duplicates
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Compute the case insensitive edit distance between two names.
+*/
+static Uint32 EditDistance(CSStr a, CSStr b)
+{
+    static std::vector< Uint32 > row;
+    // Obtain the length of the names
+    const std::size_t la = std::strlen(a), lb = std::strlen(b);
+    // Initialize the first row
+    row.resize(lb + 1);
+    for (std::size_t j = 0; j <= lb; ++j)
+    {
+        row[j] = static_cast< Uint32 >(j);
+    }
+    // Compute the remaining rows in place
+    for (std::size_t i = 1; i <= la; ++i)
+    {
+        Uint32 diag = row[0];
+        row[0] = static_cast< Uint32 >(i);
+        for (std::size_t j = 1; j <= lb; ++j)
+        {
+            const Uint32 up = row[j];
+            const bool same = std::tolower(static_cast< unsigned char >(a[i - 1])) ==
+                                std::tolower(static_cast< unsigned char >(b[j - 1]));
+            row[j] = std::min(std::min(row[j] + 1, row[j - 1] + 1), diag + (same ? 0 : 1));
+            diag = up;
+        }
+    }
+    // The last cell is the distance
+    return row[lb];
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::TrigramInsert(const String & name, std::size_t hash)
+{
+    static std::vector< Uint32 > trigrams;
+    // Extract the trigrams of the name
+    ExtractTrigrams(name.c_str(), trigrams);
+    // Associate the command with each trigram
+    for (const auto tri : trigrams)
+    {
+        m_Trigrams[tri].push_back(hash);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::TrigramRemove(const String & name, std::size_t hash)
+{
+    static std::vector< Uint32 > trigrams;
+    // Extract the trigrams of the name
+    ExtractTrigrams(name.c_str(), trigrams);
+    // Remove the command from each trigram
+    for (const auto tri : trigrams)
+    {
+        auto itr = m_Trigrams.find(tri);
+        // Was the command associated with this trigram?
+        if (itr == m_Trigrams.end())
+        {
+            continue;
+        }
+        itr->second.erase(std::remove(itr->second.begin(), itr->second.end(), hash), itr->second.end());
+        // Discard trigrams that no longer have commands
+        if (itr->second.empty())
+        {
+            m_Trigrams.erase(itr);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Array Controller::Suggest(CSStr name, Uint32 max) const
+{
+    // Structure used to rank the candidates
+    struct Candidate
+    {
+        Uint32      mIndex; // Index of the command.
+        Uint32      mShared; // Number of trigrams shared with the specified name.
+        Float32     mScore; // Similarity of the trigram sets.
+        Uint32      mDistance; // Edit distance to the specified name.
+    };
+    static std::vector< Uint32 > trigrams, shared;
+    static std::vector< Candidate > candidates;
+    // Extract the trigrams of the specified name
+    ExtractTrigrams(name, trigrams);
+    candidates.clear();
+    // Reset the shared trigram counters
+    shared.assign(m_Commands.size(), 0);
+    // Count the trigrams that each command shares with the name
+    for (const auto tri : trigrams)
+    {
+        auto itr = m_Trigrams.find(tri);
+        // Does any command contain this trigram?
+        if (itr == m_Trigrams.end())
+        {
+            continue;
+        }
+        for (const auto hash : itr->second)
+        {
+            const Int32 idx = Find(hash);
+            // Is this the first trigram shared with this command?
+            if (idx >= 0 && shared[idx]++ == 0)
+            {
+                candidates.push_back({static_cast< Uint32 >(idx), 0, 0.0f, 0});
+            }
+        }
+    }
+    // Score the candidates
+    for (auto & cand : candidates)
+    {
+        const String & cmd = m_Commands[cand.mIndex].mName;
+        // Grab the number of shared trigrams
+        cand.mShared = shared[cand.mIndex];
+        // Each name has one trigram per character plus the trailing padding (at most)
+        const Uint32 total = static_cast< Uint32 >(trigrams.size() + cmd.size() + 1) - cand.mShared;
+        cand.mScore = static_cast< Float32 >(cand.mShared) / static_cast< Float32 >(total);
+        cand.mDistance = EditDistance(name, cmd.c_str());
+    }
+    // Discard the candidates that share too little with the name
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                    [](const Candidate & c) { return c.mScore < 0.2f; }), candidates.end());
+    // Sort the candidates by similarity and then by edit distance
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate & a, const Candidate & b) {
+        return (a.mScore > b.mScore) || (a.mScore == b.mScore && a.mDistance < b.mDistance);
+    });
+    // Limit the number of suggestions
+    const Uint32 count = std::min(max, static_cast< Uint32 >(candidates.size()));
+    // Allocate an array with an adequate size
+    Array arr(DefaultVM::Get(), count);
+    // Populate the array with the command names
+    for (Uint32 i = 0; i < count; ++i)
+    {
+        arr.SetValue(static_cast< SQInteger >(i), m_Commands[candidates[i].mIndex].mName);
+    }
+    // Return the resulted array
+    return arr;
+}
+
+// ------------------------------------------------------------------------------------------------
+const Object & Controller::FindByPrefix(CSStr prefix)
+{
+    // Find the node where the prefix ends
+    Int32 node = TrieFind(prefix);
+    // Is there exactly one command that starts with this prefix?
+    if (node < 0 || m_Nodes[node].mCount != 1)
+    {
+        return NullObject(); // Unknown or ambiguous
+    }
+    // Follow the only path until the node where the command ends
+    while (m_Nodes[node].mHashes.empty())
+    {
+        for (const auto & n : m_Nodes[node].mNodes)
+        {
+            if (m_Nodes[n.second].mCount != 0)
+            {
+                node = static_cast< Int32 >(n.second);
+                break;
+            }
+        }
+    }
+    // Retrieve the command from the hash table
+    const Int32 idx = Find(m_Nodes[node].mHashes.front());
+    // Return the command if it exists
+    return (idx < 0) ? NullObject() : m_Commands[idx].mObj;
+}
+
 // ------------------------------------------------------------------------------------------------
 Object Manager::Create(const StackStrF & name, const StackStrF & spec, Array & tags, Uint8 min, Uint8 max, SQInteger auth, bool prot, bool assoc)
 {
@@ -178,6 +552,173 @@ Object Manager::Create(const StackStrF & name, const StackStrF & spec, Array & t
     return o;
 }
 
+// ------------------------------------------------------------------------------------------------
+Int64 GetCmdTime()
+{
+    return (Chrono::GetCurrentSysTime() / 1000LL);
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint64 InvokerKey(const Object & invoker)
+{
+    const HSQOBJECT & obj = invoker.GetObject();
+    // Is the invoker an instance of a player?
+    if (sq_type(obj) == OT_INSTANCE && !ClassType< CPlayer >::getStaticClassData().Expired())
+    {
+        HSQUIRRELVM vm = DefaultVM::Get();
+        SQUserPointer ptr = nullptr;
+        // Attempt to extract the player from the instance
+        sq_pushobject(vm, obj);
+        const SQRESULT res = sq_getinstanceup(vm, -1, &ptr, ClassType< CPlayer >::getStaticClassData().Lock().Get());
+        sq_pop(vm, 1);
+        // Players use their slot which can't be mistaken for the address of an object
+        if (SQ_SUCCEEDED(res) && ptr != nullptr)
+        {
+            return static_cast< Uint64 >(static_cast< CPlayer * >(ptr)->GetID());
+        }
+    }
+    // Other invokers are identified by the address of the object
+    return static_cast< Uint64 >(obj._unVal.raw);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::DropInvoker(Uint64 key)
+{
+    for (auto & ctr : s_Controllers)
+    {
+        ctr->m_Buckets.erase(key);
+        // Discard the cooldowns from the command listeners
+        for (auto & cmd : ctr->m_Commands)
+        {
+            cmd.mPtr->DropInvoker(key);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Controller::DropSource(CSStr source)
+{
+    SQInteger count = 0;
+    for (auto & ctr : s_Controllers)
+    {
+        // Detach the command listeners (backwards because detaching removes them from the list)
+        for (Commands::size_type i = ctr->m_Commands.size(); i > 0; --i)
+        {
+            Listener * ptr = ctr->m_Commands[i - 1].mPtr;
+            // Does this listener belong to the script?
+            if (!ptr->IsFrom(source))
+            {
+                continue;
+            }
+            // Keep the listener alive until it was detached and released
+            const Object obj(ctr->m_Commands[i - 1].mObj);
+            ptr->Detach();
+            // Release the callbacks
+            ptr->m_OnExec.ReleaseGently();
+            ptr->m_OnAuth.ReleaseGently();
+            ptr->m_OnPost.ReleaseGently();
+            ptr->m_OnFail.ReleaseGently();
+            // Count this listener
+            ++count;
+        }
+        // Release the script callbacks of the controller, if they belong to the script
+        if (IsFunctionFrom(ctr->m_OnFail.GetFunc(), source))
+        {
+            ctr->m_OnFail.ReleaseGently();
+        }
+        if (IsFunctionFrom(ctr->m_OnAuth.GetFunc(), source))
+        {
+            ctr->m_OnAuth.ReleaseGently();
+        }
+    }
+    // Return the number of detached listeners
+    return count;
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Controller::RateCheck(const Object & invoker, Int64 now)
+{
+    // Is there a rate limit?
+    if (m_RateTokens == 0)
+    {
+        return 0;
+    }
+    // Discard the buckets that were refilled completely, if there are too many
+    if (m_Buckets.size() >= m_RatePrune)
+    {
+        const Int64 full = static_cast< Int64 >(m_RateTokens) * m_RateRefill;
+        // Remove the buckets that had enough time to refill
+        for (auto itr = m_Buckets.begin(); itr != m_Buckets.end();)
+        {
+            if ((now - itr->second.second) >= full)
+            {
+                itr = m_Buckets.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+        // Wait until the number of buckets doubles before doing this again
+        m_RatePrune = std::max(m_Buckets.size() * 2, static_cast< std::size_t >(64));
+    }
+    // Obtain the bucket of this invoker
+    auto res = m_Buckets.emplace(InvokerKey(invoker), std::make_pair(static_cast< Float64 >(m_RateTokens), now));
+    // Grab a reference to the available tokens
+    Float64 & tokens = res.first->second.first;
+    // Refill the tokens for the time that passed since the last command
+    if (m_RateRefill == 0)
+    {
+        tokens = m_RateTokens;
+    }
+    else if (!res.second)
+    {
+        tokens = std::min(tokens + static_cast< Float64 >(now - res.first->second.second) / m_RateRefill,
+                            static_cast< Float64 >(m_RateTokens));
+    }
+    res.first->second.second = now;
+    // Is there a token available?
+    if (tokens >= 1.0)
+    {
+        tokens -= 1.0;
+        // The command may run
+        return 0;
+    }
+    // Return how long until the next token
+    return static_cast< Int64 >(std::ceil((1.0 - tokens) * m_RateRefill));
+}
+
+// ------------------------------------------------------------------------------------------------
+CtxRef Controller::AcquireCtx(Object & invoker)
+{
+    // Are there any released contexts?
+    if (m_Contexts.empty())
+    {
+        return CtxRef(new Context(invoker));
+    }
+    // Take the most recently released context
+    CtxRef ctx(std::move(m_Contexts.back()));
+    m_Contexts.pop_back();
+    // Assign the new invoker
+    ctx->mInvoker = invoker;
+    // Return the context
+    return ctx;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::ReleaseCtx(CtxRef & ctx)
+{
+    // Is anyone else still using this context?
+    if (!ctx || ctx.Count() > 1)
+    {
+        return; // It will be released by the last owner
+    }
+    // Release the script objects but keep the memory
+    ctx->Reset();
+    // Make it available to the next command
+    m_Contexts.push_back(ctx);
+}
+
 // ------------------------------------------------------------------------------------------------
 Int32 Controller::Run(const Guard & guard, CCStr command)
 {
@@ -253,11 +794,25 @@ Int32 Controller::Run(const Guard & guard, CCStr command)
     }
     // Attempt to find the specified command
     ctx.mObject = FindByName(ctx.mCommand);
+    // Should we look for a command that starts with the specified name?
+    if (ctx.mObject.IsNull() && m_Abbreviate)
+    {
+        ctx.mObject = FindByPrefix(ctx.mCommand.c_str());
+    }
     // Have we found anything?
     if (ctx.mObject.IsNull())
     {
+        // Should the callback receive suggestions instead of the name?
+        if (m_Suggest)
+        {
+            SqError(CMDERR_UNKNOWN_COMMAND, _SC("Unable to find the specified command"),
+                    Suggest(ctx.mCommand.c_str(), m_Suggest));
+        }
         // Tell the script callback to deal with the error
-        SqError(CMDERR_UNKNOWN_COMMAND, _SC("Unable to find the specified command"), ctx.mCommand);
+        else
+        {
+            SqError(CMDERR_UNKNOWN_COMMAND, _SC("Unable to find the specified command"), ctx.mCommand);
+        }
         // Execution failed!
         return -1;
     }
@@ -271,16 +826,36 @@ Int32 Controller::Run(const Guard & guard, CCStr command)
         // Execution failed!
         return -1;
     }
+    // Use the full name of the command if it was abbreviated
+    ctx.mCommand.assign(ctx.mInstance->GetName());
     // Attempt to execute the command
     try
     {
-        return Exec(ctx);
+        const Int32 result = Exec(ctx);
+        // Should we count this invocation?
+        if (m_Profile)
+        {
+            ++ctx.mInstance->m_Stats.mCalls;
+            // Did the command fail or was it aborted?
+            if (result <= 0)
+            {
+                ++ctx.mInstance->m_Stats.mFailures;
+            }
+        }
+        // Return the result
+        return result;
     }
     catch (const Sqrat::Exception & e)
     {
         // Tell the script callback to deal with the error
         SqError(CMDERR_EXECUTION_FAILED, _SC("Exceptions occurred during execution"), e.what());
     }
+    // Should we count this invocation?
+    if (m_Profile)
+    {
+        ++ctx.mInstance->m_Stats.mCalls;
+        ++ctx.mInstance->m_Stats.mFailures;
+    }
     // Execution failed
     return -1;
 }
@@ -292,6 +867,10 @@ Int32 Controller::Exec(Context & ctx)
     ctx.mArgv.clear();
     // Reset the argument counter
     ctx.mArgc = 0;
+    // Obtain the time once for all the checks
+    const Int64 now = GetCmdTime();
+    // Milliseconds until the invoker is allowed to run this command
+    Int64 wait = 0;
     // Is this command suspended from further executions?
     if (ctx.mInstance->GetSuspended())
     {
@@ -300,6 +879,22 @@ Int32 Controller::Exec(Context & ctx)
         // Execution failed!
         return -1;
     }
+    // Has the invoker exceeded the allowed command rate?
+    else if ((wait = RateCheck(ctx.mInvoker, now)) > 0)
+    {
+        // Tell the script callback to deal with the error
+        SqError(CMDERR_RATE_LIMITED, _SC("Too many commands in a short time"), ConvTo< SQInteger >::From(wait));
+        // Execution failed!
+        return -1;
+    }
+    // Was this command used too recently?
+    else if ((wait = ctx.mInstance->CooldownCheck(ctx.mInvoker, now)) > 0)
+    {
+        // Tell the script callback to deal with the error
+        SqError(CMDERR_COMMAND_COOLDOWN, _SC("The command is on cooldown"), ConvTo< SQInteger >::From(wait));
+        // Execution failed!
+        return -1;
+    }
     // Make sure the invoker has enough authority to execute this command
     else if (!ctx.mInstance->AuthCheck(ctx.mInvoker))
     {
@@ -349,12 +944,16 @@ Int32 Controller::Exec(Context & ctx)
             return -1;
         }
     }
+    // The command is about to run so the cooldowns start now
+    ctx.mInstance->CooldownMark(ctx.mInvoker, now);
     // Result of the command execution
     SQInteger result = -1;
     // Clear any data from the buffer to make room for the error message
     ctx.mBuffer.At(0) = '\0';
     // Whether the command execution failed
     bool failed = false;
+    // When did the execution start, if it must be measured
+    const Int64 start = m_Profile ? Chrono::GetCurrentSysTime() : 0;
     // Do we have to call the command with an associative container?
     if (ctx.mInstance->m_Associate)
     {
@@ -409,6 +1008,11 @@ Int32 Controller::Exec(Context & ctx)
             failed = true;
         }
     }
+    // Should we record the time spent in the executor?
+    if (m_Profile)
+    {
+        ctx.mInstance->m_Stats.AddExec(Chrono::GetCurrentSysTime() - start);
+    }
     // Was there a runtime exception during the execution?
     if (failed)
     {
@@ -479,6 +1083,8 @@ bool Controller::Parse(Context & ctx)
     }
     // Obtain the flags of the currently processed argument
     Uint8 arg_flags = ctx.mInstance->m_ArgSpec[ctx.mArgc];
+    // When did the parsing start, if it must be measured
+    const Int64 start = m_Profile ? Chrono::GetCurrentSysTime() : 0;
     // Adjust the internal buffer if necessary (mostly never)
     ctx.mBuffer.Adjust(ctx.mArgument.size());
     // The iterator to the currently processed character
@@ -650,12 +1256,8 @@ bool Controller::Parse(Context & ctx)
                 // See if this whole string was indeed an integer
                 if (next == end)
                 {
-                    // Remember the current stack size
-                    const StackGuard sg;
-                    // Transform it into a script object
-                    sq_pushinteger(DefaultVM::Get(), ConvTo< SQInteger >::From(value));
-                    // Get the object from the stack and add it to the argument list along with it's type
-                    ctx.mArgv.emplace_back(CMDARG_INTEGER, Var< Object >(DefaultVM::Get(), -1).value);
+                    // Add it to the argument list along with it's type
+                    ctx.mArgv.emplace_back(CMDARG_INTEGER, MakeInteger(ConvTo< SQInteger >::From(value)));
                     // We've identified the correct value type
                     identified = true;
                 }
@@ -674,12 +1276,8 @@ bool Controller::Parse(Context & ctx)
                 // See if this whole string was indeed an float
                 if (next == end)
                 {
-                    // Remember the current stack size
-                    const StackGuard sg;
-                    // Transform it into a script object
-                    sq_pushfloat(DefaultVM::Get(), ConvTo< SQFloat >::From(value));
-                    // Get the object from the stack and add it to the argument list along with it's type
-                    ctx.mArgv.emplace_back(CMDARG_FLOAT, Var< Object >(DefaultVM::Get(), -1).value);
+                    // Add it to the argument list along with it's type
+                    ctx.mArgv.emplace_back(CMDARG_FLOAT, MakeFloat(ConvTo< SQFloat >::From(value)));
                     // We've identified the correct value type
                     identified = true;
                 }
@@ -700,30 +1298,22 @@ bool Controller::Parse(Context & ctx)
                 }
                 // Terminate the copied string portion
                 *bptr = '\0';
-                // Remember the current stack size
-                const StackGuard sg;
                 // Is this a boolean true value?
                 if (std::strcmp(lc, "true") == 0 || std::strcmp(lc, "on") == 0)
                 {
-                    // Transform it into a script object
-                    sq_pushbool(DefaultVM::Get(), true);
+                    // Add it to the argument list along with it's type
+                    ctx.mArgv.emplace_back(CMDARG_BOOLEAN, MakeBool(true));
                     // We've identified the correct value type
                     identified = true;
                 }
                 // Is this a boolean false value?
                 else if (std::strcmp(lc, "false") == 0 || std::strcmp(lc, "off") == 0)
                 {
-                    // Transform it into a script object
-                    sq_pushbool(DefaultVM::Get(), false);
+                    // Add it to the argument list along with it's type
+                    ctx.mArgv.emplace_back(CMDARG_BOOLEAN, MakeBool(false));
                     // We've identified the correct value type
                     identified = true;
                 }
-                // Could the value inside the string be interpreted as a boolean?
-                if (identified)
-                {
-                    // Get the object from the stack and add it to the argument list along with it's type
-                    ctx.mArgv.emplace_back(CMDARG_BOOLEAN, Var< Object >(DefaultVM::Get(), -1).value);
-                }
             }
             // If everything else failed then simply treat the value as a string
             if (!identified)
@@ -771,10 +1361,124 @@ bool Controller::Parse(Context & ctx)
         // Advance to the next character
         ++itr;
     }
+    // Should we record the time spent parsing?
+    if (m_Profile)
+    {
+        ctx.mInstance->m_Stats.AddParse(Chrono::GetCurrentSysTime() - start);
+    }
     // Return whether the parsing was successful
     return good;
 }
 
+// ------------------------------------------------------------------------------------------------
+Table CmdStats::ToTable() const
+{
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Create the histogram arrays
+    Array parse_hist(vm, SQMOD_CMD_HISTOGRAM), exec_hist(vm, SQMOD_CMD_HISTOGRAM);
+    // Copy the histogram buckets
+    for (SQInteger i = 0; i < SQMOD_CMD_HISTOGRAM; ++i)
+    {
+        parse_hist.SetValue(i, static_cast< SQInteger >(mParseHist[i]));
+        exec_hist.SetValue(i, static_cast< SQInteger >(mExecHist[i]));
+    }
+    // Create the table with the statistics
+    Table tbl(vm);
+    tbl.SetValue(_SC("Calls"), static_cast< SQInteger >(mCalls));
+    tbl.SetValue(_SC("Failures"), static_cast< SQInteger >(mFailures));
+    tbl.SetValue(_SC("ParseTime"), static_cast< SQInteger >(mParseTime));
+    tbl.SetValue(_SC("ExecTime"), static_cast< SQInteger >(mExecTime));
+    tbl.SetValue(_SC("ParseMax"), static_cast< SQInteger >(mParseMax));
+    tbl.SetValue(_SC("ExecMax"), static_cast< SQInteger >(mExecMax));
+    tbl.SetValue(_SC("ParseHist"), parse_hist);
+    tbl.SetValue(_SC("ExecHist"), exec_hist);
+    // Return the statistics
+    return tbl;
+}
+
+// ------------------------------------------------------------------------------------------------
+Table Controller::GetStats() const
+{
+    // Allocate an empty table
+    Table tbl(DefaultVM::Get());
+    // Populate the table with the statistics of each command listener
+    for (const auto & cmd : m_Commands)
+    {
+        if (cmd.mPtr)
+        {
+            tbl.SetValue(cmd.mName.c_str(), cmd.mPtr->m_Stats.ToTable());
+        }
+    }
+    // Return the resulted table
+    return tbl;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Controller::ResetStats()
+{
+    for (auto & cmd : m_Commands)
+    {
+        if (cmd.mPtr)
+        {
+            cmd.mPtr->m_Stats.Reset();
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Listener::CooldownCheck(const Object & invoker, Int64 now) const
+{
+    Int64 wait = 0;
+    // Is there a cooldown for everyone?
+    if (m_GlobalCooldown && m_LastExec)
+    {
+        wait = (m_LastExec + m_GlobalCooldown) - now;
+    }
+    // Is there a cooldown for each invoker?
+    if (m_Cooldown)
+    {
+        // Find when this invoker last used the command
+        auto itr = m_Stamps.find(InvokerKey(invoker));
+        // Use the longest of the two cooldowns
+        if (itr != m_Stamps.end())
+        {
+            wait = std::max(wait, (itr->second + m_Cooldown) - now);
+        }
+    }
+    // Return the remaining time, if any
+    return std::max(wait, static_cast< Int64 >(0));
+}
+
+// ------------------------------------------------------------------------------------------------
+void Listener::CooldownMark(const Object & invoker, Int64 now)
+{
+    m_LastExec = now;
+    // Is there a cooldown for each invoker?
+    if (!m_Cooldown)
+    {
+        return;
+    }
+    // Discard the expired stamps, if there are too many
+    if (m_Stamps.size() >= m_StampsPrune)
+    {
+        for (auto itr = m_Stamps.begin(); itr != m_Stamps.end();)
+        {
+            if ((now - itr->second) >= m_Cooldown)
+            {
+                itr = m_Stamps.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+        // Wait until the number of stamps doubles before doing this again
+        m_StampsPrune = std::max(m_Stamps.size() * 2, static_cast< std::size_t >(64));
+    }
+    // Remember when this invoker used the command
+    m_Stamps[InvokerKey(invoker)] = now;
+}
+
 // ------------------------------------------------------------------------------------------------
 void Listener::GenerateInfo(bool full)
 {
@@ -1039,14 +1743,24 @@ void Register(HSQUIRRELVM vm)
         .Prop(_SC("Listener"), &Manager::GetListener)
         .Prop(_SC("Command"), &Manager::GetCommand)
         .Prop(_SC("Argument"), &Manager::GetArgument)
+        .Prop(_SC("Abbreviate"), &Manager::GetAbbreviate, &Manager::SetAbbreviate)
+        .Prop(_SC("Profile"), &Manager::GetProfile, &Manager::SetProfile)
+        .Prop(_SC("Suggestions"), &Manager::GetSuggest, &Manager::SetSuggest)
+        .Prop(_SC("RateTokens"), &Manager::GetRateTokens)
+        .Prop(_SC("RateRefill"), &Manager::GetRateRefill)
         // Member Methods
         .FmtFunc(_SC("Run"), &Manager::Run)
         .Func(_SC("Sort"), &Manager::Sort)
         .Func(_SC("Clear"), &Manager::Clear)
         .Func(_SC("Attach"), &Manager::Attach)
         .FmtFunc(_SC("FindByName"), &Manager::FindByName)
+        .FmtFunc(_SC("FindByPrefix"), &Manager::FindByPrefix)
         .Func(_SC("BindFail"), &Manager::SetOnFail)
         .Func(_SC("BindAuth"), &Manager::SetOnAuth)
+        .Func(_SC("SetRateLimit"), &Manager::SetRateLimit)
+        .Func(_SC("Suggest"), &Manager::Suggest)
+        .Func(_SC("Stats"), &Manager::GetStats)
+        .Func(_SC("ResetStats"), &Manager::ResetStats)
         .Func(_SC("GetArray"), &Manager::GetCommandsArray)
         .Func(_SC("GetTable"), &Manager::GetCommandsTable)
         .Func(_SC("Foreach"), &Manager::ForeachCommand)
@@ -1099,6 +1813,8 @@ void Register(HSQUIRRELVM vm)
         .Prop(_SC("Protected"), &Listener::GetProtected, &Listener::SetProtected)
         .Prop(_SC("Suspended"), &Listener::GetSuspended, &Listener::SetSuspended)
         .Prop(_SC("Associate"), &Listener::GetAssociate, &Listener::SetAssociate)
+        .Prop(_SC("Cooldown"), &Listener::GetCooldown, &Listener::SetCooldown)
+        .Prop(_SC("GlobalCooldown"), &Listener::GetGlobalCooldown, &Listener::SetGlobalCooldown)
         .Prop(_SC("MinArgs"), &Listener::GetMinArgC, &Listener::SetMinArgC)
         .Prop(_SC("MaxArgs"), &Listener::GetMaxArgC, &Listener::SetMaxArgC)
         .Prop(_SC("OnExec"), &Listener::GetOnExec)
@@ -1122,6 +1838,9 @@ void Register(HSQUIRRELVM vm)
         .Func(_SC("ArgCheck"), &Listener::ArgCheck)
         .Func(_SC("AuthCheck"), &Listener::AuthCheck)
         .Func(_SC("GenerateInfo"), &Listener::GenerateInfo)
+        .Func(_SC("ResetCooldowns"), &Listener::ResetCooldowns)
+        .Func(_SC("Stats"), &Listener::GetStats)
+        .Func(_SC("ResetStats"), &Listener::ResetStats)
     );
 
     RootTable(vm).Bind(_SC("SqCmd"), cmdns);
@@ -1154,6 +1873,8 @@ void Register(HSQUIRRELVM vm)
         .Const(_SC("ExecutionAborted"),     CMDERR_EXECUTION_ABORTED)
         .Const(_SC("PostProcessingFailed"), CMDERR_POST_PROCESSING_FAILED)
         .Const(_SC("UnresolvedFailure"),    CMDERR_UNRESOLVED_FAILURE)
+        .Const(_SC("Cooldown"),             CMDERR_COMMAND_COOLDOWN)
+        .Const(_SC("RateLimited"),          CMDERR_RATE_LIMITED)
         .Const(_SC("Max"),                  CMDERR_MAX)
     );
 }
@@ -1166,6 +1887,22 @@ void Register_Command(HSQUIRRELVM vm)
     Cmd::Register(vm);
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Forget the cooldowns and token buckets of a player that is being destroyed.
+*/
+void DropCommandInvoker(Int32 id)
+{
+    Cmd::Controller::DropInvoker(static_cast< Uint64 >(id));
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to detach the command listeners that belong to a script file.
+*/
+SQInteger DropCommandSource(CSStr source)
+{
+    return Cmd::Controller::DropSource(source);
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Forward the call to terminate the command manager.
 */
@@ -13,6 +13,7 @@
 #include <map>
 #include <vector>
 #include <iterator>
+#include <unordered_map>
 #include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
@@ -48,6 +49,17 @@ typedef std::vector< Argument >     Arguments; // A list of extracted arguments.
 // ------------------------------------------------------------------------------------------------
 typedef std::vector< Command >      Commands; // List of attached command instances.
 typedef std::vector< Controller * > Controllers; // List of active controllers.
+typedef std::vector< CtxRef >       Contexts; // List of execution contexts.
+
+// ------------------------------------------------------------------------------------------------
+typedef std::vector< Uint32 >       CmdSlots; // Hash table slots holding command indexes.
+typedef std::vector< std::size_t >  CmdHashes; // List of command hashes.
+
+// ------------------------------------------------------------------------------------------------
+typedef std::pair< Float64, Int64 >             CmdBucket; // Available tokens and the time they were updated.
+typedef std::unordered_map< Uint64, Int64 >     CmdStamps; // Time of the last execution for each invoker.
+typedef std::unordered_map< Uint64, CmdBucket > CmdBuckets; // Token bucket of each invoker.
+typedef std::unordered_map< Uint32, CmdHashes > CmdTrigrams; // Commands that contain each trigram.
 
 /* ------------------------------------------------------------------------------------------------
  * Types of arguments supported by the command system.
@@ -101,6 +113,10 @@ enum CmdError
     CMDERR_POST_PROCESSING_FAILED,
     // The callback that was supposed to deal with the failure also failed due to a runtime exception
     CMDERR_UNRESOLVED_FAILURE,
+    // The command failed to execute because it was used again before the cooldown expired
+    CMDERR_COMMAND_COOLDOWN,
+    // The command failed to execute because the invoker exceeded the allowed command rate
+    CMDERR_RATE_LIMITED,
     // Maximum command error identifier
     CMDERR_MAX
 };
@@ -130,6 +146,17 @@ inline CSStr ValidateName(CSStr name)
     return name;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Obtain the key used to identify an invoker in the cooldown and rate limit tables. Players are
+ * identified by their slot so their entries can be discarded when they disconnect.
+*/
+Uint64 InvokerKey(const Object & invoker);
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the current time in milliseconds used by the cooldowns and rate limits.
+*/
+Int64 GetCmdTime();
+
 // ------------------------------------------------------------------------------------------------
 inline CSStr ArgSpecToStr(Uint8 spec)
 {
@@ -158,7 +185,7 @@ public:
     Buffer          mBuffer; // Shared buffer used to extract arguments and process data.
 
     // --------------------------------------------------------------------------------------------
-    const Object    mInvoker; // Reference to the entity that invoked the command.
+    Object          mInvoker; // Reference to the entity that invoked the command.
     String          mCommand; // Command name extracted from the command string.
     String          mArgument; // Command argument extracted from the command string.
     Listener*       mInstance; // Pointer to the currently executed command listener.
@@ -184,6 +211,21 @@ public:
         // Reserve enough space upfront
         mCommand.reserve(64);
         mArgument.reserve(512);
+        mArgv.reserve(SQMOD_MAX_CMD_ARGS);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the script objects and keep the allocated memory for the next execution.
+    */
+    void Reset()
+    {
+        mInvoker.Release();
+        mCommand.clear();
+        mArgument.clear();
+        mInstance = nullptr;
+        mObject.Release();
+        mArgv.clear();
+        mArgc = 0;
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -333,6 +375,103 @@ struct Command
     }
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * Node in the case insensitive prefix tree of command names.
+*/
+struct CmdNode
+{
+    // --------------------------------------------------------------------------------------------
+    std::vector< std::pair< SQChar, Uint32 > >  mNodes; // The child nodes and their characters.
+    CmdHashes                                   mHashes; // Commands that end at this node.
+    Uint32                                      mCount; // Number of commands that pass through this node.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    CmdNode()
+        : mNodes(), mHashes(), mCount(0)
+    {
+        /* ... */
+    }
+};
+
+// ------------------------------------------------------------------------------------------------
+typedef std::vector< CmdNode >      CmdNodes; // List of prefix tree nodes.
+
+/* ------------------------------------------------------------------------------------------------
+ * Execution statistics of a command listener. Histogram bucket N counts durations below 2^N microseconds.
+*/
+struct CmdStats
+{
+    // --------------------------------------------------------------------------------------------
+    Uint64      mCalls; // Number of times the command was invoked.
+    Uint64      mFailures; // Number of invocations that failed or were aborted.
+    Int64       mParseTime; // Total microseconds spent parsing arguments.
+    Int64       mExecTime; // Total microseconds spent in the executor.
+    Int64       mParseMax; // Longest time spent parsing arguments.
+    Int64       mExecMax; // Longest time spent in the executor.
+    Uint32      mParseHist[SQMOD_CMD_HISTOGRAM]; // Distribution of the time spent parsing arguments.
+    Uint32      mExecHist[SQMOD_CMD_HISTOGRAM]; // Distribution of the time spent in the executor.
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    CmdStats()
+    {
+        Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard all recorded statistics.
+    */
+    void Reset()
+    {
+        mCalls = mFailures = 0;
+        mParseTime = mExecTime = mParseMax = mExecMax = 0;
+        std::fill(mParseHist, mParseHist + SQMOD_CMD_HISTOGRAM, 0);
+        std::fill(mExecHist, mExecHist + SQMOD_CMD_HISTOGRAM, 0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the histogram bucket of the specified duration.
+    */
+    static Uint32 Bucket(Int64 micros)
+    {
+        Uint32 bucket = 0;
+        // Count the significant bits of the duration
+        for (; micros > 0 && bucket < (SQMOD_CMD_HISTOGRAM - 1); micros >>= 1)
+        {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Record the time spent parsing arguments.
+    */
+    void AddParse(Int64 micros)
+    {
+        mParseTime += micros;
+        mParseMax = std::max(mParseMax, micros);
+        ++mParseHist[Bucket(micros)];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Record the time spent in the executor.
+    */
+    void AddExec(Int64 micros)
+    {
+        mExecTime += micros;
+        mExecMax = std::max(mExecMax, micros);
+        ++mExecHist[Bucket(micros)];
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a script table with the recorded statistics.
+    */
+    Table ToTable() const;
+};
+
 /* ------------------------------------------------------------------------------------------------
  * Holds a list of commands to execute as well as authentication or failure resolvers.
 */
@@ -347,7 +486,20 @@ private:
 
     // --------------------------------------------------------------------------------------------
     Commands        m_Commands; // List of available command instances.
+    CmdSlots        m_Slots; // Open addressing hash table of indexes in the command list.
+    CmdNodes        m_Nodes; // Case insensitive prefix tree of command names.
+    CmdTrigrams     m_Trigrams; // Case insensitive trigram index of command names.
     CtxRef          m_Context; // Context of the currently executed command.
+    Contexts        m_Contexts; // Execution contexts that can be reused.
+    bool            m_Abbreviate; // Whether commands can be invoked by an unique prefix.
+    bool            m_Profile; // Whether execution statistics are recorded.
+    Uint32          m_Suggest; // Number of suggestions sent to the error callback for unknown commands.
+
+    // --------------------------------------------------------------------------------------------
+    CmdBuckets      m_Buckets; // Token buckets of the invokers.
+    Uint32          m_RateTokens; // Maximum number of commands an invoker can run in a burst.
+    Uint32          m_RateRefill; // Milliseconds needed to regain one token.
+    std::size_t     m_RatePrune; // Number of buckets after which full ones are discarded.
 
     // --------------------------------------------------------------------------------------------
     Function        m_OnFail; // Callback when something failed while running a command.
@@ -366,7 +518,18 @@ protected:
     */
     Controller(Manager * mgr)
         : m_Commands()
+        , m_Slots()
+        , m_Nodes(1)
+        , m_Trigrams()
         , m_Context()
+        , m_Contexts()
+        , m_Abbreviate(false)
+        , m_Profile(false)
+        , m_Suggest(0)
+        , m_Buckets()
+        , m_RateTokens(0)
+        , m_RateRefill(0)
+        , m_RatePrune(64)
         , m_OnFail()
         , m_OnAuth()
         , m_Manager(mgr)
@@ -418,6 +581,16 @@ protected:
         }
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Obtain an execution context for the specified invoker, reusing a released one if possible.
+    */
+    CtxRef AcquireCtx(Object & invoker);
+
+    /* --------------------------------------------------------------------------------------------
+     * Give back an execution context so that it can be reused by the next command.
+    */
+    void ReleaseCtx(CtxRef & ctx);
+
     /* --------------------------------------------------------------------------------------------
      * Execute one of the managed commands.
     */
@@ -433,6 +606,11 @@ protected:
     */
     bool Parse(Context & ctx);
 
+    /* --------------------------------------------------------------------------------------------
+     * Take a token from the bucket of the invoker. Returns the milliseconds to wait if none is left.
+    */
+    Int64 RateCheck(const Object & invoker, Int64 now);
+
     /* --------------------------------------------------------------------------------------------
      * Attach a command listener to a certain name.
     */
@@ -459,23 +637,12 @@ protected:
     */
     void Detach(const String & name)
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
-        // Iterator to the found command, if any
-        Commands::const_iterator itr = m_Commands.cbegin();
         // Attempt to find the specified command
-        for (; itr != m_Commands.cend(); ++itr)
-        {
-            // Are the hashes identical?
-            if (itr->mHash == hash)
-            {
-                break; // We found our command!
-            }
-        }
+        const Int32 idx = Find(std::hash< String >()(name));
         // Make sure the command exist before attempting to remove it
-        if (itr != m_Commands.end())
+        if (idx >= 0)
         {
-            m_Commands.erase(itr);
+            Erase(m_Commands.begin() + idx);
         }
     }
 
@@ -485,9 +652,9 @@ protected:
     void Detach(Listener * ptr)
     {
         // Iterator to the found command, if any
-        Commands::const_iterator itr = m_Commands.cbegin();
+        Commands::iterator itr = m_Commands.begin();
         // Attempt to find the specified command
-        for (; itr != m_Commands.cend(); ++itr)
+        for (; itr != m_Commands.end(); ++itr)
         {
             // Are the instances identical?
             if (itr->mPtr == ptr)
@@ -498,10 +665,75 @@ protected:
         // Make sure the command exists before attempting to remove it
         if (itr != m_Commands.end())
         {
-            m_Commands.erase(itr);
+            Erase(itr);
         }
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Remove a command from the list and the lookup structures.
+    */
+    void Erase(Commands::iterator itr);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the index of the command with the specified hash or -1 if it doesn't exist.
+    */
+    Int32 Find(std::size_t hash) const
+    {
+        // Is the hash table empty?
+        if (m_Slots.empty())
+        {
+            return -1;
+        }
+        // The table size is always a power of two
+        const std::size_t mask = m_Slots.size() - 1;
+        // Probe the slots until an empty one is found
+        for (std::size_t pos = (hash & mask); m_Slots[pos] != 0; pos = ((pos + 1) & mask))
+        {
+            // Are the hashes identical?
+            if (m_Commands[m_Slots[pos] - 1].mHash == hash)
+            {
+                return static_cast< Int32 >(m_Slots[pos] - 1); // We found our command!
+            }
+        }
+        // No such command exists
+        return -1;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert the command at the specified index in the hash table.
+    */
+    void Index(Uint32 idx);
+
+    /* --------------------------------------------------------------------------------------------
+     * Rebuild the hash table from the command list.
+    */
+    void Reindex();
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert a command name in the prefix tree.
+    */
+    void TrieInsert(const String & name, std::size_t hash);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a command name from the prefix tree.
+    */
+    void TrieRemove(const String & name, std::size_t hash);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the node where the specified prefix ends or -1 if no command starts with it.
+    */
+    Int32 TrieFind(CSStr prefix) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert a command name in the trigram index.
+    */
+    void TrigramInsert(const String & name, std::size_t hash);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a command name from the trigram index.
+    */
+    void TrigramRemove(const String & name, std::size_t hash);
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -513,12 +745,27 @@ public:
         {
             // Clear the command listeners
             ctr->Clear();
+            // Release the reusable execution contexts
+            ctr->m_Contexts.clear();
+            // Discard the token buckets
+            ctr->m_Buckets.clear();
             // Release the script callbacks, if any
             ctr->m_OnFail.ReleaseGently();
             ctr->m_OnAuth.ReleaseGently();
         }
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Discard the token buckets and cooldowns of the specified invoker from all controllers.
+    */
+    static void DropInvoker(Uint64 key);
+
+    /* --------------------------------------------------------------------------------------------
+     * Detach the command listeners and release the callbacks that were compiled from the specified
+     * script file. Returns the number of detached command listeners.
+    */
+    static SQInteger DropSource(CSStr source);
+
     /* --------------------------------------------------------------------------------------------
      * Destructor.
     */
@@ -541,19 +788,7 @@ public:
     */
     bool Attached(const String & name) const
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
-        // Attempt to find the specified command
-        for (const auto & cmd : m_Commands)
-        {
-            // Are the hashes identical?
-            if (cmd.mHash == hash)
-            {
-                return true; // We found our command!
-            }
-        }
-        // No such command exists
-        return false;
+        return (Find(std::hash< String >()(name)) >= 0);
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -583,6 +818,8 @@ public:
             [](Commands::const_reference a, Commands::const_reference b) -> bool {
                 return (a.mName < b.mName);
             });
+        // The indexes have changed
+        Reindex();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -591,6 +828,10 @@ public:
     void Clear()
     {
         m_Commands.clear();
+        m_Slots.clear();
+        m_Trigrams.clear();
+        // Keep only the root of the prefix tree
+        m_Nodes.assign(1, CmdNode());
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -598,19 +839,105 @@ public:
     */
     const Object & FindByName(const String & name)
     {
-        // Obtain the unique identifier of the specified name
-        const std::size_t hash = std::hash< String >()(name);
         // Attempt to find the specified command
-        for (const auto & cmd : m_Commands)
-        {
-            // Are the hashes identical?
-            if (cmd.mHash == hash)
-            {
-                return cmd.mObj; // We found our command!
-            }
-        }
-        // No such command exist
-        return NullObject();
+        const Int32 idx = Find(std::hash< String >()(name));
+        // Return the command if it exists
+        return (idx < 0) ? NullObject() : m_Commands[idx].mObj;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Locate and retrieve the only command listener whose name starts with the specified prefix.
+    */
+    const Object & FindByPrefix(CSStr prefix);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether commands can be invoked by an unique prefix.
+    */
+    bool GetAbbreviate() const
+    {
+        return m_Abbreviate;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether commands can be invoked by an unique prefix.
+    */
+    void SetAbbreviate(bool toggle)
+    {
+        m_Abbreviate = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the names of the commands that resemble the specified name, best match first.
+    */
+    Array Suggest(CSStr name, Uint32 max) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of suggestions sent to the error callback for unknown commands.
+    */
+    Uint32 GetSuggest() const
+    {
+        return m_Suggest;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of suggestions sent to the error callback for unknown commands.
+    */
+    void SetSuggest(Uint32 count)
+    {
+        m_Suggest = count;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether execution statistics are recorded.
+    */
+    bool GetProfile() const
+    {
+        return m_Profile;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether execution statistics are recorded.
+    */
+    void SetProfile(bool toggle)
+    {
+        m_Profile = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the execution statistics of all command listeners in a table.
+    */
+    Table GetStats() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the execution statistics of all command listeners.
+    */
+    void ResetStats();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of commands an invoker can run in a burst.
+    */
+    Uint32 GetRateTokens() const
+    {
+        return m_RateTokens;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds needed by an invoker to regain one command.
+    */
+    Uint32 GetRateRefill() const
+    {
+        return m_RateRefill;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the command rate limit of the invokers. Zero tokens disables the limit.
+    */
+    void SetRateLimit(Uint32 tokens, Uint32 refill)
+    {
+        m_RateTokens = tokens;
+        m_RateRefill = refill;
+        // Start over with the new limits
+        m_Buckets.clear();
     }
 
     /* --------------------------------------------------------------------------------------------
@@ -931,6 +1258,127 @@ public:
         return GetValid()->FindByName(String(name.mPtr, name.mLen));
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Locate and retrieve the only command listener whose name starts with the specified prefix.
+    */
+    const Object & FindByPrefix(const StackStrF & prefix)
+    {
+        // Validate the specified prefix
+        if (prefix.mLen <= 0)
+        {
+            STHROWF("Invalid or empty command prefix");
+        }
+        // Attempt to return the requested command
+        return GetValid()->FindByPrefix(prefix.mPtr);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether commands can be invoked by an unique prefix.
+    */
+    bool GetAbbreviate() const
+    {
+        return GetValid()->GetAbbreviate();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether commands can be invoked by an unique prefix.
+    */
+    void SetAbbreviate(bool toggle)
+    {
+        GetValid()->SetAbbreviate(toggle);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the names of the commands that resemble the specified name, best match first.
+    */
+    Array Suggest(const StackStrF & name, SQInteger max) const
+    {
+        // Validate the specified name
+        if (name.mLen <= 0)
+        {
+            STHROWF("Invalid or empty command name");
+        }
+        // Validate the specified limit
+        else if (max < 0)
+        {
+            STHROWF("Invalid number of suggestions: %lld", static_cast< Int64 >(max));
+        }
+        // Attempt to return the suggestions
+        return GetValid()->Suggest(name.mPtr, ConvTo< Uint32 >::From(max));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of suggestions sent to the error callback for unknown commands.
+    */
+    Uint32 GetSuggest() const
+    {
+        return GetValid()->GetSuggest();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of suggestions sent to the error callback for unknown commands.
+    */
+    void SetSuggest(Uint32 count)
+    {
+        GetValid()->SetSuggest(count);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether execution statistics are recorded.
+    */
+    bool GetProfile() const
+    {
+        return GetValid()->GetProfile();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether execution statistics are recorded.
+    */
+    void SetProfile(bool toggle)
+    {
+        GetValid()->SetProfile(toggle);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the execution statistics of all command listeners in a table.
+    */
+    Table GetStats() const
+    {
+        return GetValid()->GetStats();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the execution statistics of all command listeners.
+    */
+    void ResetStats()
+    {
+        GetValid()->ResetStats();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of commands an invoker can run in a burst.
+    */
+    Uint32 GetRateTokens() const
+    {
+        return GetValid()->GetRateTokens();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds needed by an invoker to regain one command.
+    */
+    Uint32 GetRateRefill() const
+    {
+        return GetValid()->GetRateRefill();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the command rate limit of the invokers. Zero tokens disables the limit.
+    */
+    void SetRateLimit(Uint32 tokens, Uint32 refill)
+    {
+        GetValid()->SetRateLimit(tokens, refill);
+    }
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the number of managed command listeners.
     */
@@ -1217,6 +1665,12 @@ public:
         , m_OnPost()
         , m_OnFail()
         , m_Authority(ConvTo< Int32 >::From(auth))
+        , m_Cooldown(0)
+        , m_GlobalCooldown(0)
+        , m_LastExec(0)
+        , m_Stamps()
+        , m_StampsPrune(64)
+        , m_Stats()
         , m_Protected(prot)
         , m_Suspended(false)
         , m_Associate(assoc)
@@ -1626,6 +2080,90 @@ public:
         m_Suspended = toggle;
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds before the same invoker can use this command again.
+    */
+    Uint32 GetCooldown() const
+    {
+        return m_Cooldown;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds before the same invoker can use this command again.
+    */
+    void SetCooldown(Uint32 millis)
+    {
+        m_Cooldown = millis;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds before anyone can use this command again.
+    */
+    Uint32 GetGlobalCooldown() const
+    {
+        return m_GlobalCooldown;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds before anyone can use this command again.
+    */
+    void SetGlobalCooldown(Uint32 millis)
+    {
+        m_GlobalCooldown = millis;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget when this command was last used so that the cooldowns start over.
+    */
+    void ResetCooldowns()
+    {
+        m_LastExec = 0;
+        m_Stamps.clear();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Forget when the specified invoker last used this command.
+    */
+    void DropInvoker(Uint64 key)
+    {
+        m_Stamps.erase(key);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether any of the callbacks was compiled from the specified script file.
+    */
+    bool IsFrom(CSStr source) const
+    {
+        return IsFunctionFrom(m_OnExec.GetFunc(), source) || IsFunctionFrom(m_OnAuth.GetFunc(), source) ||
+                IsFunctionFrom(m_OnPost.GetFunc(), source) || IsFunctionFrom(m_OnFail.GetFunc(), source);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the execution statistics of this command in a table.
+    */
+    Table GetStats() const
+    {
+        return m_Stats.ToTable();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the execution statistics of this command.
+    */
+    void ResetStats()
+    {
+        m_Stats.Reset();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds until the specified invoker can use this command again.
+    */
+    Int64 CooldownCheck(const Object & invoker, Int64 now) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Remember that the specified invoker used this command.
+    */
+    void CooldownMark(const Object & invoker, Int64 now);
+
     /* --------------------------------------------------------------------------------------------
      * See whether this command listener instance receives arguments in an associative container.
     */
@@ -1984,6 +2522,16 @@ private:
     // --------------------------------------------------------------------------------------------
     Int32       m_Authority; // Built-in authority level required to execute this command.
 
+    // --------------------------------------------------------------------------------------------
+    Uint32      m_Cooldown; // Milliseconds before the same invoker can use this command again.
+    Uint32      m_GlobalCooldown; // Milliseconds before anyone can use this command again.
+    Int64       m_LastExec; // Time of the last execution by any invoker.
+    CmdStamps   m_Stamps; // Time of the last execution for each invoker.
+    std::size_t m_StampsPrune; // Number of stamps after which expired ones are discarded.
+
+    // --------------------------------------------------------------------------------------------
+    CmdStats    m_Stats; // Execution statistics recorded by the controller.
+
     // --------------------------------------------------------------------------------------------
     bool        m_Protected; // Whether explicit authentication of the invoker is required.
     bool        m_Suspended; // Whether this command should block further invocations.
@@ -197,6 +197,8 @@ static const EnumElement g_EventEnum[] = {
     {_SC("ServerOption"),               EVT_SERVEROPTION},
     {_SC("ScriptReload"),               EVT_SCRIPTRELOAD},
     {_SC("ScriptLoaded"),               EVT_SCRIPTLOADED},
+    {_SC("ScriptReloading"),            EVT_SCRIPTRELOADING},
+    {_SC("ScriptReloaded"),             EVT_SCRIPTRELOADED},
     {_SC("Max"),                        EVT_MAX}
 };
 
@@ -1,6 +1,9 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core.hpp"
+#include "Collector.hpp"
 #include "Logger.hpp"
+#include "Memory.hpp"
+#include "Routine.hpp"
 #include "Signal.hpp"
 #include "SqMod.h"
 
@@ -26,6 +29,8 @@
 #include <cstdarg>
 #include <exception>
 #include <stdexcept>
+#include <atomic>
+#include <thread>
 #include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
@@ -39,8 +44,16 @@ extern void InitializeTasks();
 extern void InitializeRoutines();
 extern void TerminateTasks();
 extern void TerminateRoutines();
+extern void TerminateZones();
+extern void TerminateStreamer();
+extern void TerminateOutbox();
+extern void TerminateCollector();
+extern void TerminateProfiler();
+extern void TerminatePaths();
 extern void TerminateCommands();
 extern void TerminateSignals();
+extern SQInteger DropTaskSource(CSStr source);
+extern SQInteger DropCommandSource(CSStr source);
 
 // ------------------------------------------------------------------------------------------------
 extern Buffer GetRealFilePath(CSStr path);
@@ -146,6 +159,8 @@ Core::Core()
     , m_ReloadPayload()
     , m_IncomingNameBuffer(nullptr)
     , m_IncomingNameCapacity(0)
+    , m_BytecodeCache()
+    , m_CompileThreads(0)
     , m_Debugging(false)
     , m_Executed(false)
     , m_Shutdown(false)
@@ -207,8 +222,17 @@ bool Core::Initialize()
     m_EmptyInit = conf.GetBoolValue("Squirrel", "EmptyInit", false);
     // Configure the verbosity level
     m_Verbosity = conf.GetLongValue("Log", "VerbosityLevel", 1);
+    // Configure the rotation and batching of the log file
+    Logger::Get().SetRotation(static_cast< Uint64 >(ClampMin(conf.GetLongValue("Log", "MaxFileSize", 0), 0L)) * 1024,
+                                static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "MaxFileAge", 0), 0L)),
+                                static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "KeepFiles", 0), 0L)));
+    Logger::Get().SetFlushInterval(static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "FlushInterval", 0), 0L)));
+    Logger::Get().SetWriteBuffer(static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "WriteBuffer", 0), 0L)) * 1024);
     // Initialize the log filename
     Logger::Get().SetLogFilename(conf.GetValue("Log", "Filename", nullptr));
+    // Initialize the structured log filename
+    Logger::Get().SetJsonFilename(conf.GetValue("Log", "JsonFilename", nullptr));
+    Logger::Get().ToggleJsonMessages(conf.GetBoolValue("Log", "JsonMessages", false));
     // Configure the logging timestamps
     Logger::Get().ToggleConsoleTime(conf.GetBoolValue("Log", "ConsoleTimestamp", false));
     Logger::Get().ToggleLogFileTime(conf.GetBoolValue("Log", "LogFileTimestamp", true));
@@ -227,6 +251,19 @@ bool Core::Initialize()
     Logger::Get().ToggleLogFileLevel(LOGL_WRN, conf.GetBoolValue("Log", "LogFileWarning", true));
     Logger::Get().ToggleLogFileLevel(LOGL_ERR, conf.GetBoolValue("Log", "LogFileError", true));
     Logger::Get().ToggleLogFileLevel(LOGL_FTL, conf.GetBoolValue("Log", "LogFileFatal", true));
+    // Configure how many identical messages are allowed in a window
+    Logger::Get().SetRepeatWindow(static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatWindow", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_DBG, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatDebug", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_USR, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatUser", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_SCS, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatSuccess", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_INF, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatInfo", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_WRN, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatWarning", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_ERR, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatError", 0), 0L)));
+    Logger::Get().SetRepeatLimit(LOGL_FTL, static_cast< Uint32 >(ClampMin(conf.GetLongValue("Log", "RepeatFatal", 0), 0L)));
+    // Configure the background log writer
+    Logger::Get().SetOverflow(static_cast< Uint8 >(conf.GetLongValue("Log", "AsyncOverflow", LOGOF_BLOCK)));
+    Logger::Get().SetSampleRate(static_cast< Uint32 >(conf.GetLongValue("Log", "AsyncSampleRate", 10)));
+    Logger::Get().ToggleAsync(conf.GetBoolValue("Log", "Async", false));
 
     cLogDbg(m_Verbosity >= 1, "Resizing the entity containers");
     // Make sure the entity containers have the proper size
@@ -248,6 +285,17 @@ bool Core::Initialize()
         return false;
     }
 
+    // The allocator can only be selected before the virtual machine allocates anything
+    if (!sq_setmempool(conf.GetBoolValue("Squirrel", "MemoryPool", false)))
+    {
+        LogWrn("Memory pool option takes effect after the server restarts");
+    }
+    // Attributing the allocations to scripts also needs a header on every block
+    if (!sq_setmemtagging(conf.GetBoolValue("Squirrel", "MemoryTagging", false)))
+    {
+        LogWrn("Memory tagging option takes effect after the server restarts");
+    }
+
     cLogDbg(m_Verbosity >= 1, "Creating a virtual machine (%ld stack size)", stack_size);
     // Attempt to create the script virtual machine
     m_VM = sq_open(ConvTo< SQInteger >::From(stack_size));
@@ -261,8 +309,20 @@ bool Core::Initialize()
     DefaultVM::Set(m_VM);
     // Configure error handling
     ErrorHandling::Enable(conf.GetBoolValue("Squirrel", "ErrorHandling", true));
+    // Configure when the garbage collector runs
+    Collector::SetEnabled(conf.GetBoolValue("Collector", "Enabled", true));
+    Collector::SetThreshold(ClampMin(conf.GetLongValue("Collector", "Growth", SQMOD_COLLECTOR_GROWTH), 1L));
+    Collector::SetInterval(ClampMin(conf.GetLongValue("Collector", "Interval", SQMOD_COLLECTOR_INTERVAL), 0L));
+    Collector::SetBudget(ClampMin(conf.GetLongValue("Collector", "Budget", SQMOD_COLLECTOR_BUDGET), 0L));
+    Collector::SetLowPlayers(ClampMin(conf.GetLongValue("Collector", "LowPlayers", SQMOD_COLLECTOR_LOW_PLAYERS), 0L));
+    // Configure the periodic memory reports
+    Memory::SetInterval(ClampMin(conf.GetLongValue("Squirrel", "MemoryReport", 0), 0L));
     // See if debugging options should be enabled
     m_Debugging = conf.GetBoolValue("Squirrel", "Debugging", false);
+    // See if compiled scripts should be cached
+    m_BytecodeCache.assign(conf.GetValue("Squirrel", "BytecodeCache", ""));
+    // See how many threads should compile the scripts (0 means one per core)
+    m_CompileThreads = ConvTo< Uint32 >::From(conf.GetLongValue("Squirrel", "CompileThreads", 0));
 
     // Prevent common null objects from using dead virtual machines
     NullArray() = Array();
@@ -476,6 +536,18 @@ void Core::Terminate(bool shutdown)
     // Release all resources from routines and tasks
     TerminateRoutines();
     TerminateTasks();
+    // Release all resources from zones
+    TerminateZones();
+    // Release all resources from the object streamer
+    TerminateStreamer();
+    // Release all messages waiting to be delivered
+    TerminateOutbox();
+    // Cancel the requests to defer garbage collection
+    TerminateCollector();
+    // Stop sampling the scripts and discard the samples
+    TerminateProfiler();
+    // Release all resources from object paths
+    TerminatePaths();
     // Release all resources from command managers
     TerminateCommands();
     // Release all resources from signals
@@ -521,6 +593,15 @@ void Core::Terminate(bool shutdown)
         // Tell modules to do their monkey business
         _Func->SendPluginCommand(SQMOD_RELEASED_CMD, "");
     }
+    // Write the queued log messages and stop the log writer if the server is closing
+    if (shutdown)
+    {
+        Logger::Get().ToggleAsync(false);
+    }
+    else
+    {
+        Logger::Get().Flush();
+    }
 
     OutputMessage("Squirrel plug-in was successfully terminated");
 }
@@ -628,7 +709,10 @@ bool Core::LoadScript(CSStr filepath, bool delay)
         // Attempt to load and compile the script file
         try
         {
-            m_Scripts.back().mExec.CompileFile(m_Scripts.back().mPath);
+            if (m_Scripts.back().Compile(m_BytecodeCache))
+            {
+                cLogDbg(m_Verbosity >= 3, "Loaded cached bytecode: %s", m_Scripts.back().mPath.c_str());
+            }
         }
         catch (const Sqrat::Exception & e)
         {
@@ -670,6 +754,122 @@ bool Core::LoadScript(CSStr filepath, bool delay)
     return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+bool Core::ReloadScript(CSStr filepath)
+{
+    // Is the specified path empty?
+    if (!filepath || *filepath == '\0')
+    {
+        LogErr("Cannot reload script with empty or invalid path");
+        // Failed to reload
+        return false;
+    }
+    // Are we already reloading?
+    else if (m_CircularLocks & (CCL_RELOAD_SCRIPTS | CCL_RELOAD_SCRIPT))
+    {
+        LogErr("Cannot reload script while another reload is in progress");
+        // Failed to reload
+        return false;
+    }
+
+    Buffer bpath;
+    // Attempt to get the real file path
+    try
+    {
+        bpath = GetRealFilePath(filepath);
+    }
+    catch (const std::exception & e)
+    {
+        LogErr("Unable to reload script: %s", e.what());
+        // Failed to reload
+        return false;
+    }
+
+    // Make the path into a string
+    const String path(bpath.Data(), bpath.Position());
+    // Find the script among the executed ones
+    Scripts::iterator itr = std::find_if(m_Scripts.begin(), m_Scripts.end(), [&path](Scripts::const_reference s) {
+        return (s.mPath == path);
+    });
+    // Only executed scripts can be reloaded
+    if (itr == m_Scripts.end() || (*itr).mExec.IsNull())
+    {
+        LogErr("Script was not executed: %s", path.c_str());
+        // Failed to reload
+        return false;
+    }
+    // Prevent circular reloads from the emitted events
+    const BitGuardU32 bg(m_CircularLocks, static_cast< Uint32 >(CCL_RELOAD_SCRIPT));
+    // Create a new script container with the same options
+    ScriptSrc src(m_VM, path, (*itr).mDelay, m_Debugging);
+    // Compile the new code first so that a syntax error leaves the current state intact
+    try
+    {
+        if (src.Compile(m_BytecodeCache))
+        {
+            cLogDbg(m_Verbosity >= 3, "Loaded cached bytecode: %s", path.c_str());
+        }
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        LogErr("Unable to compile: %s", path.c_str());
+        // Failed to reload
+        return false;
+    }
+    // Allow reloading by default
+    SetState(1);
+    // Give the script a chance to save its state or deny the reload
+    EmitScriptReloading(path.c_str());
+    // Are we allowed to reload?
+    if (!GetState())
+    {
+        return false; // Request denied!
+    }
+    // Disconnect the callbacks that belong to the previous code
+    const SQInteger slots = Signal::DropSource(path.c_str());
+    // Terminate the routines that belong to the previous code
+    const SQInteger routines = Routine::DropSource(path.c_str());
+    // Terminate the entity tasks that belong to the previous code
+    const SQInteger tasks = DropTaskSource(path.c_str());
+    // Detach the command listeners that belong to the previous code
+    const SQInteger commands = DropCommandSource(path.c_str());
+    // Let the user know what was cleaned
+    cLogDbg(m_Verbosity >= 2, "Released %lld slot(s), %lld routine(s), %lld task(s) and %lld command(s) from: %s",
+            static_cast< long long >(slots), static_cast< long long >(routines),
+            static_cast< long long >(tasks), static_cast< long long >(commands), path.c_str());
+    // The script is now using the new code (the search is repeated since events can load scripts)
+    itr = std::find_if(m_Scripts.begin(), m_Scripts.end(), [&path](Scripts::const_reference s) {
+        return (s.mPath == path);
+    });
+    // Did the script manage to vanish in the meantime?
+    if (itr == m_Scripts.end())
+    {
+        return false;
+    }
+    *itr = std::move(src);
+    // Attempt to execute the new code
+    bool success = true;
+    try
+    {
+        (*itr).mExec.Run();
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        LogErr("Unable to execute: %s", path.c_str());
+        // Failed to execute properly
+        success = false;
+    }
+    // Let the user know that the script was reloaded
+    if (success)
+    {
+        cLogScs(m_Verbosity >= 1, "Reloaded script: %s", path.c_str());
+    }
+    // Allow the scripts to bind their handlers again
+    EmitScriptReloaded(path.c_str(), success);
+    // Return whether the new code was executed
+    return success;
+}
+
 // ------------------------------------------------------------------------------------------------
 void Core::SetIncomingName(CSStr name)
 {
@@ -701,11 +901,89 @@ void Core::SetIncomingName(CSStr name)
     m_IncomingNameBuffer[len] = '\0';
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Read, index and compile the specified scripts on worker threads. The resulted bytecode is loaded
+ * into the virtual machine afterwards, in the original order, by the regular compilation.
+*/
+static void PrecompileScripts(HSQUIRRELVM vm, std::vector< ScriptSrc * > & scripts, const String & cache, Uint32 threads)
+{
+    // Use one thread per core if not specified
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    // Don't create more threads than there are scripts
+    threads = std::min(threads, static_cast< Uint32 >(scripts.size()));
+    // Is it worth compiling in parallel?
+    if (threads < 2)
+    {
+        return; // The regular compilation takes care of it
+    }
+    // Each script is compiled in a separate virtual machine with a copy of the current constants
+    std::vector< HSQUIRRELVM > scratch;
+    scratch.reserve(scripts.size());
+    for (size_t i = 0; i < scripts.size(); ++i)
+    {
+        scratch.push_back(ScriptSrc::CreateScratch(vm));
+    }
+    // The next script that should be compiled
+    std::atomic< size_t > next(0);
+    // The routine executed by each worker thread
+    auto worker = [&scripts, &scratch, &cache, &next]() {
+        for (size_t i = next++; i < scripts.size(); i = next++)
+        {
+            // Was the scratch virtual machine created?
+            if (!scratch[i])
+            {
+                continue; // The regular compilation will take care of it
+            }
+            try
+            {
+                scripts[i]->Precompile(scratch[i], cache);
+            }
+            catch (...)
+            {
+                // The regular compilation will report the error
+            }
+            // The scratch virtual machine is no longer needed
+            sq_close(scratch[i]);
+        }
+    };
+    // Start the worker threads
+    std::vector< std::thread > workers;
+    workers.reserve(threads);
+    for (Uint32 n = 0; n < threads; ++n)
+    {
+        workers.emplace_back(worker);
+    }
+    // Wait for all scripts to be compiled
+    for (auto & t : workers)
+    {
+        t.join();
+    }
+}
+
 // ------------------------------------------------------------------------------------------------
 bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
 {
     Scripts::iterator itr_state = itr;
 
+    // Collect the scripts that were not compiled yet
+    std::vector< ScriptSrc * > pending;
+    for (; itr != end; ++itr)
+    {
+        if ((*itr).mExec.IsNull())
+        {
+            pending.push_back(&(*itr));
+        }
+    }
+    // Compile independent scripts in parallel before anything is executed
+    PrecompileScripts(Get().m_VM, pending, Get().m_BytecodeCache, Get().m_CompileThreads);
+    // Constants declared by the scripts compiled so far
+    ScriptSrc::Names declared;
+    // Go back to the first script
+    itr = itr_state;
+
     cLogDbg(Get().m_Verbosity >= 1, "Attempting to compile the specified scripts");
     // Compile scripts first so that the constants can take effect
     for (; itr != end; ++itr)
@@ -716,10 +994,19 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
             continue; // Already compiled!
         }
 
+        // Was this compiled in advance without the constants declared by the previous scripts?
+        if (!(*itr).mCode.empty() && !declared.empty() && (*itr).Uses(declared))
+        {
+            (*itr).mCode.clear(); // Compile it again!
+        }
+
         // Attempt to load and compile the script file
         try
         {
-            (*itr).mExec.CompileFile((*itr).mPath);
+            if ((*itr).Compile(Get().m_BytecodeCache))
+            {
+                cLogDbg(Get().m_Verbosity >= 3, "Loaded cached bytecode: %s", (*itr).mPath.c_str());
+            }
         }
         catch (const Sqrat::Exception & e)
         {
@@ -727,6 +1014,8 @@ bool Core::DoScripts(Scripts::iterator itr, Scripts::iterator end)
             // Failed to execute properly
             return false;
         }
+        // Remember the constants that the following scripts may depend on
+        declared.insert(declared.end(), (*itr).mDeclared.begin(), (*itr).mDeclared.end());
 
         cLogDbg(Get().m_Verbosity >= 3, "Compiled script: %s", (*itr).mPath.c_str());
 
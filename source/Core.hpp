@@ -21,7 +21,8 @@ namespace SqMod {
 enum CoreCircularLocks
 {
     CCL_RELOAD_SCRIPTS      = (1 << 0),
-    CCL_EMIT_SERVER_OPTION  = (2 << 0)
+    CCL_EMIT_SERVER_OPTION  = (2 << 0),
+    CCL_RELOAD_SCRIPT       = (4 << 0)
 };
 
 /* ------------------------------------------------------------------------------------------------
@@ -687,6 +688,10 @@ private:
     CStr                            m_IncomingNameBuffer; // Name of an incoming connection.
     size_t                          m_IncomingNameCapacity; // Incoming connection name size.
 
+    // --------------------------------------------------------------------------------------------
+    String                          m_BytecodeCache; // Directory where compiled scripts are cached.
+    Uint32                          m_CompileThreads; // Number of threads used to compile scripts.
+
     // --------------------------------------------------------------------------------------------
     bool                            m_Debugging; // Enable debugging features, if any.
     bool                            m_Executed; // Whether the scripts were executed.
@@ -888,6 +893,11 @@ public:
     */
     bool LoadScript(CSStr filepath, bool delay);
 
+    /* --------------------------------------------------------------------------------------------
+     * Recompile and execute a single loaded script without restarting the virtual machine.
+    */
+    bool ReloadScript(CSStr filepath);
+
     /* --------------------------------------------------------------------------------------------
      * Modify the name for the currently assigned incoming connection.
     */
@@ -1140,6 +1150,8 @@ public:
     void EmitPickupRespawn(Int32 pickup_id);
     void EmitCheckpointEntered(Int32 checkpoint_id, Int32 player_id);
     void EmitCheckpointExited(Int32 checkpoint_id, Int32 player_id);
+    void EmitZoneEnter(LightObj & zone, Int32 player_id);
+    void EmitZoneLeave(LightObj & zone, Int32 player_id);
 
     /* --------------------------------------------------------------------------------------------
      * Miscellaneous events.
@@ -1183,6 +1195,8 @@ public:
     void EmitServerOption(Int32 option, bool value, Int32 header, LightObj & payload);
     void EmitScriptReload(Int32 header, LightObj & payload);
     void EmitScriptLoaded();
+    void EmitScriptReloading(CCStr path);
+    void EmitScriptReloaded(CCStr path, bool success);
 
     /* --------------------------------------------------------------------------------------------
      * Entity pool changes events.
@@ -1302,6 +1316,8 @@ public:
     SignalPair  mOnCheckpointExited;
     SignalPair  mOnCheckpointWorld;
     SignalPair  mOnCheckpointRadius;
+    SignalPair  mOnZoneEnter;
+    SignalPair  mOnZoneLeave;
     SignalPair  mOnEntityPool;
     SignalPair  mOnClientScriptData;
     SignalPair  mOnPlayerUpdate;
@@ -1336,6 +1352,8 @@ public:
     SignalPair  mOnServerOption;
     SignalPair  mOnScriptReload;
     SignalPair  mOnScriptLoaded;
+    SignalPair  mOnScriptReloading;
+    SignalPair  mOnScriptReloaded;
 };
 
 } // Namespace:: SqMod
@@ -1,12 +1,17 @@
 // ------------------------------------------------------------------------------------------------
 #include "Core.hpp"
 #include "Signal.hpp"
+#include "SqMod.h"
 #include "Base/Buffer.hpp"
 #include "Library/Utils/Buffer.hpp"
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+extern void UpdateZones(Int32 id, const Vector3 & pos);
+extern void ProfilerCommand(CCStr message);
+
 // ------------------------------------------------------------------------------------------------
 void Core::EmitCustomEvent(Int32 group, Int32 header, LightObj & payload)
 {
@@ -186,9 +191,13 @@ void Core::EmitServerFrame(Float32 elapsed_time)
 }
 
 // ------------------------------------------------------------------------------------------------
-void Core::EmitPluginCommand(Uint32 /*command_identifier*/, CCStr /*message*/)
+void Core::EmitPluginCommand(Uint32 command_identifier, CCStr message)
 {
-    // Ignored for now...
+    // Forward the commands addressed to the profiler
+    if (command_identifier == SQMOD_PROFILER_CMD)
+    {
+        ProfilerCommand(message);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -702,6 +711,20 @@ void Core::EmitCheckpointRadius(Int32 checkpoint_id, Float32 old_radius, Float32
     (*mOnCheckpointRadius.first)(_checkpoint.mObj, old_radius, new_radius);
 }
 
+// ------------------------------------------------------------------------------------------------
+void Core::EmitZoneEnter(LightObj & zone, Int32 player_id)
+{
+    PlayerInst & _player = m_Players.at(player_id);
+    (*mOnZoneEnter.first)(_player.mObj, zone);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Core::EmitZoneLeave(LightObj & zone, Int32 player_id)
+{
+    PlayerInst & _player = m_Players.at(player_id);
+    (*mOnZoneLeave.first)(_player.mObj, zone);
+}
+
 // ------------------------------------------------------------------------------------------------
 void Core::EmitObjectWorld(Int32 object_id, Int32 old_world, Int32 new_world)
 {
@@ -821,6 +844,11 @@ void Core::EmitPlayerWorld(Int32 player_id, Int32 old_world, Int32 new_world, bo
     PlayerInst & _player = m_Players.at(player_id);
     (*_player.mOnWorld.first)(old_world, new_world, secondary);
     (*mOnPlayerWorld.first)(_player.mObj, old_world, new_world, secondary);
+    // The zones that the player is inside depend on the world
+    if (!secondary)
+    {
+        UpdateZones(player_id, _player.mLastPosition);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1001,6 +1029,20 @@ void Core::EmitScriptLoaded()
     (*mOnScriptLoaded.first)();
 }
 
+// ------------------------------------------------------------------------------------------------
+void Core::EmitScriptReloading(CCStr path)
+{
+    LightObj src(path, -1);
+    (*mOnScriptReloading.first)(src);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Core::EmitScriptReloaded(CCStr path, bool success)
+{
+    LightObj src(path, -1);
+    (*mOnScriptReloaded.first)(src, success);
+}
+
 // ------------------------------------------------------------------------------------------------
 void Core::EmitEntityPool(vcmpEntityPool entity_type, Int32 entity_id, bool is_deleted)
 {
@@ -1152,6 +1194,8 @@ void Core::EmitPlayerUpdate(Int32 player_id, vcmpPlayerUpdate update_type)
         }
         // Update the tracked value
         inst.mLastPosition = pos;
+        // Update the zones that the player is inside
+        UpdateZones(player_id, pos);
     }
 
     // Obtain the current health of this instance
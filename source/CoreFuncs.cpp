@@ -41,6 +41,57 @@ static SQInteger SqLoadScript(HSQUIRRELVM vm)
     return 1;
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqReloadScript(HSQUIRRELVM vm)
+{
+    // Was the script path specified?
+    if (sq_gettop(vm) <= 1)
+    {
+        return sq_throwerror(vm, "Missing script path");
+    }
+    // Attempt to generate the string value
+    StackStrF val(vm, 2);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.mRes))
+    {
+        return val.mRes; // Propagate the error!
+    }
+    // Forward the call to the actual implementation
+    sq_pushbool(vm, Core::Get().ReloadScript(val.mPtr));
+    // We have an argument on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqGetMemoryStats(HSQUIRRELVM vm)
+{
+    SQMemPoolStats stats;
+    // Retrieve the allocator statistics
+    sq_getmempoolstats(&stats);
+    // Create the table with the results
+    Table tbl(vm);
+    tbl.SetValue(_SC("Pooled"), sq_getmempool() != SQFalse);
+    tbl.SetValue(_SC("Live"), static_cast< SQInteger >(stats.live));
+    tbl.SetValue(_SC("Peak"), static_cast< SQInteger >(stats.peak));
+    tbl.SetValue(_SC("Reserved"), static_cast< SQInteger >(stats.reserved));
+    tbl.SetValue(_SC("Large"), static_cast< SQInteger >(stats.large));
+    // Create the list of size classes
+    Array classes(vm, SQ_MEMPOOL_CLASSES);
+    for (SQInteger i = 0; i < SQ_MEMPOOL_CLASSES; ++i)
+    {
+        Table cls(vm);
+        cls.SetValue(_SC("Size"), static_cast< SQInteger >(stats.size[i]));
+        cls.SetValue(_SC("Blocks"), static_cast< SQInteger >(stats.blocks[i]));
+        cls.SetValue(_SC("Cached"), static_cast< SQInteger >(stats.cached[i]));
+        classes.SetValue(i, cls);
+    }
+    tbl.SetValue(_SC("Classes"), classes);
+    // Push the table on the stack
+    sq_pushobject(vm, tbl.GetObject());
+    // We have an argument on the stack
+    return 1;
+}
+
 // ------------------------------------------------------------------------------------------------
 static SQInteger SqGetEvents(HSQUIRRELVM vm)
 {
@@ -326,6 +377,8 @@ void Register_Core(HSQUIRRELVM vm)
         .Func(_SC("OnPostLoad"), &SqGetPostLoadEvent)
         .Func(_SC("OnUnload"), &SqGetUnloadEvent)
         .SquirrelFunc(_SC("LoadScript"), &SqLoadScript)
+        .SquirrelFunc(_SC("ReloadScript"), &SqReloadScript)
+        .SquirrelFunc(_SC("GetMemoryStats"), &SqGetMemoryStats)
         .SquirrelFunc(_SC("On"), &SqGetEvents)
     );
 }
@@ -26,6 +26,9 @@ namespace SqMod {
 
 // ------------------------------------------------------------------------------------------------
 extern void CleanupTasks(Int32 id, Int32 type);
+extern void LeaveZones(Int32 id);
+extern void DropOutbox(Int32 id);
+extern void DropCommandInvoker(Int32 id);
 
 // ------------------------------------------------------------------------------------------------
 void Core::BlipInst::Destroy(bool destroy, Int32 header, LightObj & payload)
@@ -238,6 +241,12 @@ void Core::PlayerInst::Destroy(bool /*destroy*/, Int32 header, LightObj & payloa
     // Should we notify that this entity is being cleaned up?
     if (VALID_ENTITY(mID))
     {
+        // Don't leave exceptions to prevent us from releasing this instance
+        try
+        {
+            LeaveZones(mID);
+        }
+        SQMOD_CATCH_EVENT_EXCEPTION("while removing player from zones")
         // Don't leave exceptions to prevent us from releasing this instance
         try
         {
@@ -261,6 +270,10 @@ void Core::PlayerInst::Destroy(bool /*destroy*/, Int32 header, LightObj & payloa
     mObj.Release();
     // Release tasks, if any
     CleanupTasks(mID, ENT_PLAYER);
+    // Discard the messages that were not delivered yet
+    DropOutbox(mID);
+    // Forget the command cooldowns and rate limits of this player
+    DropCommandInvoker(mID);
     // Reset the instance to it's initial state
     ResetInstance();
     // Don't release the callbacks abruptly
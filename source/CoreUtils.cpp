@@ -146,6 +146,8 @@ void Core::InitEvents()
     InitSignalPair(mOnCheckpointExited, m_Events, "CheckpointExited");
     InitSignalPair(mOnCheckpointWorld, m_Events, "CheckpointWorld");
     InitSignalPair(mOnCheckpointRadius, m_Events, "CheckpointRadius");
+    InitSignalPair(mOnZoneEnter, m_Events, "ZoneEnter");
+    InitSignalPair(mOnZoneLeave, m_Events, "ZoneLeave");
     InitSignalPair(mOnEntityPool, m_Events, "EntityPool");
     InitSignalPair(mOnClientScriptData, m_Events, "ClientScriptData");
     InitSignalPair(mOnPlayerUpdate, m_Events, "PlayerUpdate");
@@ -180,6 +182,8 @@ void Core::InitEvents()
     InitSignalPair(mOnServerOption, m_Events, "ServerOption");
     InitSignalPair(mOnScriptReload, m_Events, "ScriptReload");
     InitSignalPair(mOnScriptLoaded, m_Events, "ScriptLoaded");
+    InitSignalPair(mOnScriptReloading, m_Events, "ScriptReloading");
+    InitSignalPair(mOnScriptReloaded, m_Events, "ScriptReloaded");
 }
 // ------------------------------------------------------------------------------------------------
 void Core::DropEvents()
@@ -274,6 +278,8 @@ void Core::DropEvents()
     ResetSignalPair(mOnCheckpointExited);
     ResetSignalPair(mOnCheckpointWorld);
     ResetSignalPair(mOnCheckpointRadius);
+    ResetSignalPair(mOnZoneEnter);
+    ResetSignalPair(mOnZoneLeave);
     ResetSignalPair(mOnEntityPool);
     ResetSignalPair(mOnClientScriptData);
     ResetSignalPair(mOnPlayerUpdate);
@@ -308,6 +314,8 @@ void Core::DropEvents()
     ResetSignalPair(mOnServerOption);
     ResetSignalPair(mOnScriptReload);
     ResetSignalPair(mOnScriptLoaded);
+    ResetSignalPair(mOnScriptReloading);
+    ResetSignalPair(mOnScriptReloaded);
     m_Events.Release();
 }
 
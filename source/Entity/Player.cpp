@@ -10,6 +10,8 @@
 
 // ------------------------------------------------------------------------------------------------
 #include <cstring>
+#include <iterator>
+#include <algorithm>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqstdstring.h>
@@ -1569,6 +1571,213 @@ const Vector3 & CPlayer::GetLastPosition() const
     return Core::Get().GetPlayer(m_ID).mLastPosition;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Properties that can be modified or retrieved in bulk.
+*/
+enum PlayerProperty
+{
+    PLAYERPROP_ADMIN = 0,
+    PLAYERPROP_ALPHA,
+    PLAYERPROP_ARMOR,
+    PLAYERPROP_COLOR,
+    PLAYERPROP_FPS,
+    PLAYERPROP_HEADING,
+    PLAYERPROP_HEALTH,
+    PLAYERPROP_ID,
+    PLAYERPROP_IMMUNITY,
+    PLAYERPROP_MONEY,
+    PLAYERPROP_NAME,
+    PLAYERPROP_PING,
+    PLAYERPROP_POSITION,
+    PLAYERPROP_SCORE,
+    PLAYERPROP_SECONDARY_WORLD,
+    PLAYERPROP_SKIN,
+    PLAYERPROP_SPAWNED,
+    PLAYERPROP_SPEED,
+    PLAYERPROP_STATE,
+    PLAYERPROP_TEAM,
+    PLAYERPROP_WANTED_LEVEL,
+    PLAYERPROP_WEAPON,
+    PLAYERPROP_WORLD,
+    PLAYERPROP_UNKNOWN
+};
+
+// ------------------------------------------------------------------------------------------------
+static const std::pair< CSStr, Int32 > g_PlayerProperties[] = {
+    // Must be sorted by name for the binary search
+    {_SC("Admin"),          PLAYERPROP_ADMIN},
+    {_SC("Alpha"),          PLAYERPROP_ALPHA},
+    {_SC("Angle"),          PLAYERPROP_HEADING},
+    {_SC("Armor"),          PLAYERPROP_ARMOR},
+    {_SC("Armour"),         PLAYERPROP_ARMOR},
+    {_SC("Color"),          PLAYERPROP_COLOR},
+    {_SC("Colour"),         PLAYERPROP_COLOR},
+    {_SC("FPS"),            PLAYERPROP_FPS},
+    {_SC("Heading"),        PLAYERPROP_HEADING},
+    {_SC("Health"),         PLAYERPROP_HEALTH},
+    {_SC("ID"),             PLAYERPROP_ID},
+    {_SC("Immunity"),       PLAYERPROP_IMMUNITY},
+    {_SC("Money"),          PLAYERPROP_MONEY},
+    {_SC("Name"),           PLAYERPROP_NAME},
+    {_SC("Ping"),           PLAYERPROP_PING},
+    {_SC("Pos"),            PLAYERPROP_POSITION},
+    {_SC("Position"),       PLAYERPROP_POSITION},
+    {_SC("Score"),          PLAYERPROP_SCORE},
+    {_SC("SecWorld"),       PLAYERPROP_SECONDARY_WORLD},
+    {_SC("SecondaryWorld"), PLAYERPROP_SECONDARY_WORLD},
+    {_SC("Skin"),           PLAYERPROP_SKIN},
+    {_SC("Spawned"),        PLAYERPROP_SPAWNED},
+    {_SC("Speed"),          PLAYERPROP_SPEED},
+    {_SC("State"),          PLAYERPROP_STATE},
+    {_SC("Team"),           PLAYERPROP_TEAM},
+    {_SC("WantedLevel"),    PLAYERPROP_WANTED_LEVEL},
+    {_SC("Weapon"),         PLAYERPROP_WEAPON},
+    {_SC("World"),          PLAYERPROP_WORLD}
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Find the property identifier associated with the specified name.
+*/
+static Int32 FindPlayerProperty(CSStr name)
+{
+    auto * end = std::end(g_PlayerProperties);
+    // Binary search the sorted list of names
+    auto * itr = std::lower_bound(std::begin(g_PlayerProperties), end, name,
+                        [](const std::pair< CSStr, Int32 > & p, CSStr n) { return std::strcmp(p.first, n) < 0; });
+    // Return the identifier if the name matched
+    return (itr != end && std::strcmp(itr->first, name) == 0) ? itr->second : PLAYERPROP_UNKNOWN;
+}
+
+// ------------------------------------------------------------------------------------------------
+CPlayer & CPlayer::Apply(Table & props)
+{
+    // Validate the managed identifier
+    Validate();
+    // Make sure the properties are in a table
+    if (props.IsNull() || props.GetType() != OT_TABLE)
+    {
+        STHROWF("Expected a table of properties");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Restore the stack on exit
+    const StackGuard sg(vm);
+    // Push the table on the stack
+    sq_pushobject(vm, props.GetObject());
+    sq_pushnull(vm);
+    // Process every property
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        CSStr name = nullptr;
+        // Properties must be identified by name
+        if (sq_gettype(vm, -2) != OT_STRING || SQ_FAILED(sq_getstring(vm, -2, &name)))
+        {
+            STHROWF("Property names must be strings");
+        }
+        // Apply the property value
+        switch (FindPlayerProperty(name))
+        {
+            case PLAYERPROP_ADMIN:              SetAdmin(Var< bool >(vm, -1).value); break;
+            case PLAYERPROP_ALPHA:              SetAlphaEx(Var< Int32 >(vm, -1).value, 0); break;
+            case PLAYERPROP_ARMOR:              _Func->SetPlayerArmour(m_ID, Var< Float32 >(vm, -1).value); break;
+            case PLAYERPROP_COLOR:
+            {
+                _Func->SetPlayerColour(m_ID, Var< const Color3 & >(vm, -1).value.GetRGB());
+            } break;
+            case PLAYERPROP_HEADING:            _Func->SetPlayerHeading(m_ID, Var< Float32 >(vm, -1).value); break;
+            case PLAYERPROP_HEALTH:             _Func->SetPlayerHealth(m_ID, Var< Float32 >(vm, -1).value); break;
+            case PLAYERPROP_IMMUNITY:           SetImmunity(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_MONEY:              SetMoney(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_POSITION:
+            {
+                const Vector3 & pos = Var< const Vector3 & >(vm, -1).value;
+                // Perform the requested operation
+                _Func->SetPlayerPosition(m_ID, pos.x, pos.y, pos.z);
+            } break;
+            case PLAYERPROP_SCORE:              SetScore(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_SECONDARY_WORLD:    SetSecondaryWorld(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_SKIN:               SetSkin(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_SPEED:
+            {
+                const Vector3 & vel = Var< const Vector3 & >(vm, -1).value;
+                // Perform the requested operation
+                _Func->SetPlayerSpeed(m_ID, vel.x, vel.y, vel.z);
+            } break;
+            case PLAYERPROP_TEAM:               SetTeam(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_WANTED_LEVEL:       SetWantedLevel(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_WEAPON:             SetWeapon(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_WORLD:              SetWorld(Var< Int32 >(vm, -1).value); break;
+            case PLAYERPROP_UNKNOWN:            STHROWF("Unknown player property: %s", name); break;
+            default:                            STHROWF("Player property cannot be modified: %s", name);
+        }
+        // Pop the key and value from the stack
+        sq_pop(vm, 2);
+    }
+    // Allow chaining
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+Table CPlayer::Read(Array & names) const
+{
+    // Validate the managed identifier
+    Validate();
+    // Make sure the names are in an array
+    if (names.IsNull() || names.GetType() != OT_ARRAY)
+    {
+        STHROWF("Expected an array of property names");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // The table where the values are stored
+    Table tbl(vm);
+    // Restore the stack on exit
+    const StackGuard sg(vm);
+    // Push the array on the stack
+    sq_pushobject(vm, names.GetObject());
+    sq_pushnull(vm);
+    // Process every name
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        CSStr name = nullptr;
+        // Properties must be identified by name
+        if (sq_gettype(vm, -1) != OT_STRING || SQ_FAILED(sq_getstring(vm, -1, &name)))
+        {
+            STHROWF("Property names must be strings");
+        }
+        // Retrieve the property value
+        switch (FindPlayerProperty(name))
+        {
+            case PLAYERPROP_ADMIN:              tbl.SetValue(name, _Func->IsPlayerAdmin(m_ID) != 0); break;
+            case PLAYERPROP_ALPHA:              tbl.SetValue(name, _Func->GetPlayerAlpha(m_ID)); break;
+            case PLAYERPROP_ARMOR:              tbl.SetValue(name, _Func->GetPlayerArmour(m_ID)); break;
+            case PLAYERPROP_COLOR:              tbl.SetValue(name, GetColor()); break;
+            case PLAYERPROP_FPS:                tbl.SetValue(name, static_cast< Float32 >(_Func->GetPlayerFPS(m_ID))); break;
+            case PLAYERPROP_HEADING:            tbl.SetValue(name, _Func->GetPlayerHeading(m_ID)); break;
+            case PLAYERPROP_HEALTH:             tbl.SetValue(name, _Func->GetPlayerHealth(m_ID)); break;
+            case PLAYERPROP_ID:                 tbl.SetValue(name, m_ID); break;
+            case PLAYERPROP_IMMUNITY:           tbl.SetValue(name, _Func->GetPlayerImmunityFlags(m_ID)); break;
+            case PLAYERPROP_MONEY:              tbl.SetValue(name, _Func->GetPlayerMoney(m_ID)); break;
+            case PLAYERPROP_NAME:               tbl.SetValue(name, GetName()); break;
+            case PLAYERPROP_PING:               tbl.SetValue(name, _Func->GetPlayerPing(m_ID)); break;
+            case PLAYERPROP_POSITION:           tbl.SetValue(name, GetPosition()); break;
+            case PLAYERPROP_SCORE:              tbl.SetValue(name, _Func->GetPlayerScore(m_ID)); break;
+            case PLAYERPROP_SECONDARY_WORLD:    tbl.SetValue(name, _Func->GetPlayerSecondaryWorld(m_ID)); break;
+            case PLAYERPROP_SKIN:               tbl.SetValue(name, _Func->GetPlayerSkin(m_ID)); break;
+            case PLAYERPROP_SPAWNED:            tbl.SetValue(name, _Func->IsPlayerSpawned(m_ID) != 0); break;
+            case PLAYERPROP_SPEED:              tbl.SetValue(name, GetSpeed()); break;
+            case PLAYERPROP_STATE:              tbl.SetValue(name, _Func->GetPlayerState(m_ID)); break;
+            case PLAYERPROP_TEAM:               tbl.SetValue(name, _Func->GetPlayerTeam(m_ID)); break;
+            case PLAYERPROP_WANTED_LEVEL:       tbl.SetValue(name, _Func->GetPlayerWantedLevel(m_ID)); break;
+            case PLAYERPROP_WEAPON:             tbl.SetValue(name, _Func->GetPlayerWeapon(m_ID)); break;
+            case PLAYERPROP_WORLD:              tbl.SetValue(name, _Func->GetPlayerWorld(m_ID)); break;
+            default:                            STHROWF("Unknown player property: %s", name);
+        }
+        // Pop the key and value from the stack
+        sq_pop(vm, 2);
+    }
+    // Return the retrieved values
+    return tbl;
+}
+
 // ------------------------------------------------------------------------------------------------
 void CPlayer::StartStream()
 {
@@ -2442,6 +2651,8 @@ void Register_CPlayer(HSQUIRRELVM vm)
         .Prop(_SC("Blue"), &CPlayer::GetColorB, &CPlayer::SetColorB)
         // Member Methods
         .Func(_SC("StreamedFor"), &CPlayer::IsStreamedFor)
+        .Func(_SC("Apply"), &CPlayer::Apply)
+        .Func(_SC("Read"), &CPlayer::Read)
         .Func(_SC("Kick"), &CPlayer::Kick)
         .Func(_SC("Ban"), &CPlayer::Ban)
         .Func(_SC("KickBecause"), &CPlayer::KickBecause)
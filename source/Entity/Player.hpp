@@ -835,6 +835,16 @@ public:
     */
     const Vector3 & GetLastPosition() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Modify multiple properties of the managed player entity from a table of name/value pairs.
+    */
+    CPlayer & Apply(Table & props);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve multiple properties of the managed player entity into a table.
+    */
+    Table Read(Array & names) const;
+
     /* --------------------------------------------------------------------------------------------
      * Start a new stream with the default size.
     */
@@ -7,6 +7,11 @@
 #include "Core.hpp"
 #include "Tasks.hpp"
 
+// ------------------------------------------------------------------------------------------------
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
@@ -1200,6 +1205,188 @@ const Quaternion & CVehicle::GetLastRotation() const
     return Core::Get().GetVehicle(m_ID).mLastRotation;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Properties that can be modified or retrieved in bulk.
+*/
+enum VehicleProperty
+{
+    VEHICLEPROP_EULER_ROTATION = 0,
+    VEHICLEPROP_HEALTH,
+    VEHICLEPROP_ID,
+    VEHICLEPROP_IDLE_RESPAWN_TIMER,
+    VEHICLEPROP_IMMUNITY,
+    VEHICLEPROP_MODEL,
+    VEHICLEPROP_POSITION,
+    VEHICLEPROP_PRIMARY_COLOR,
+    VEHICLEPROP_RADIO,
+    VEHICLEPROP_RELATIVE_SPEED,
+    VEHICLEPROP_ROTATION,
+    VEHICLEPROP_SECONDARY_COLOR,
+    VEHICLEPROP_SPAWN_POSITION,
+    VEHICLEPROP_SPAWN_ROTATION,
+    VEHICLEPROP_SPEED,
+    VEHICLEPROP_SYNC_SOURCE,
+    VEHICLEPROP_TURN_SPEED,
+    VEHICLEPROP_WORLD,
+    VEHICLEPROP_WRECKED,
+    VEHICLEPROP_UNKNOWN
+};
+
+// ------------------------------------------------------------------------------------------------
+static const std::pair< CSStr, Int32 > g_VehicleProperties[] = {
+    {_SC("EulerRot"),            VEHICLEPROP_EULER_ROTATION},
+    {_SC("EulerRotation"),       VEHICLEPROP_EULER_ROTATION},
+    {_SC("Health"),              VEHICLEPROP_HEALTH},
+    {_SC("ID"),                  VEHICLEPROP_ID},
+    {_SC("IdleRespawnTimer"),    VEHICLEPROP_IDLE_RESPAWN_TIMER},
+    {_SC("Immunity"),            VEHICLEPROP_IMMUNITY},
+    {_SC("Model"),               VEHICLEPROP_MODEL},
+    {_SC("Pos"),                 VEHICLEPROP_POSITION},
+    {_SC("Position"),            VEHICLEPROP_POSITION},
+    {_SC("PrimaryColor"),        VEHICLEPROP_PRIMARY_COLOR},
+    {_SC("PrimaryColour"),       VEHICLEPROP_PRIMARY_COLOR},
+    {_SC("Radio"),               VEHICLEPROP_RADIO},
+    {_SC("RelSpeed"),            VEHICLEPROP_RELATIVE_SPEED},
+    {_SC("RelativeSpeed"),       VEHICLEPROP_RELATIVE_SPEED},
+    {_SC("Rot"),                 VEHICLEPROP_ROTATION},
+    {_SC("Rotation"),            VEHICLEPROP_ROTATION},
+    {_SC("SecondaryColor"),      VEHICLEPROP_SECONDARY_COLOR},
+    {_SC("SecondaryColour"),     VEHICLEPROP_SECONDARY_COLOR},
+    {_SC("SpawnPos"),            VEHICLEPROP_SPAWN_POSITION},
+    {_SC("SpawnPosition"),       VEHICLEPROP_SPAWN_POSITION},
+    {_SC("SpawnRot"),            VEHICLEPROP_SPAWN_ROTATION},
+    {_SC("SpawnRotation"),       VEHICLEPROP_SPAWN_ROTATION},
+    {_SC("Speed"),               VEHICLEPROP_SPEED},
+    {_SC("SyncSource"),          VEHICLEPROP_SYNC_SOURCE},
+    {_SC("TurnSpeed"),           VEHICLEPROP_TURN_SPEED},
+    {_SC("World"),               VEHICLEPROP_WORLD},
+    {_SC("Wrecked"),             VEHICLEPROP_WRECKED}
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Find the identifier of a property from its name.
+*/
+static Int32 FindVehicleProperty(CSStr name)
+{
+    auto * end = std::end(g_VehicleProperties);
+    // Binary search the sorted list of names
+    auto * itr = std::lower_bound(std::begin(g_VehicleProperties), end, name,
+                        [](const std::pair< CSStr, Int32 > & p, CSStr n) { return std::strcmp(p.first, n) < 0; });
+    // Return the identifier if the name matched
+    return (itr != end && std::strcmp(itr->first, name) == 0) ? itr->second : VEHICLEPROP_UNKNOWN;
+}
+
+// ------------------------------------------------------------------------------------------------
+CVehicle & CVehicle::Apply(Table & props)
+{
+    // Validate the managed identifier
+    Validate();
+    // Make sure the properties are in a table
+    if (props.IsNull() || props.GetType() != OT_TABLE)
+    {
+        STHROWF("Expected a table of properties");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Restore the stack on exit
+    const StackGuard sg(vm);
+    // Push the table on the stack
+    sq_pushobject(vm, props.GetObject());
+    sq_pushnull(vm);
+    // Process every property
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        CSStr name = nullptr;
+        // Properties must be identified by name
+        if (sq_gettype(vm, -2) != OT_STRING || SQ_FAILED(sq_getstring(vm, -2, &name)))
+        {
+            STHROWF("Property names must be strings");
+        }
+        // Apply the property value
+        switch (FindVehicleProperty(name))
+        {
+            case VEHICLEPROP_EULER_ROTATION:        SetRotationEuler(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_HEALTH:                SetHealth(Var< Float32 >(vm, -1).value); break;
+            case VEHICLEPROP_IDLE_RESPAWN_TIMER:    SetIdleRespawnTimer(Var< Uint32 >(vm, -1).value); break;
+            case VEHICLEPROP_IMMUNITY:              SetImmunity(Var< Int32 >(vm, -1).value); break;
+            case VEHICLEPROP_POSITION:              SetPosition(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_PRIMARY_COLOR:         SetPrimaryColor(Var< Int32 >(vm, -1).value); break;
+            case VEHICLEPROP_RADIO:                 SetRadio(Var< Int32 >(vm, -1).value); break;
+            case VEHICLEPROP_RELATIVE_SPEED:        SetRelativeSpeed(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_ROTATION:              SetRotation(Var< const Quaternion & >(vm, -1).value); break;
+            case VEHICLEPROP_SECONDARY_COLOR:       SetSecondaryColor(Var< Int32 >(vm, -1).value); break;
+            case VEHICLEPROP_SPAWN_POSITION:        SetSpawnPosition(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_SPAWN_ROTATION:        SetSpawnRotation(Var< const Quaternion & >(vm, -1).value); break;
+            case VEHICLEPROP_SPEED:                 SetSpeed(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_TURN_SPEED:            SetTurnSpeed(Var< const Vector3 & >(vm, -1).value); break;
+            case VEHICLEPROP_WORLD:                 SetWorld(Var< Int32 >(vm, -1).value); break;
+            case VEHICLEPROP_UNKNOWN:               STHROWF("Unknown vehicle property: %s", name); break;
+            default:                                STHROWF("Vehicle property cannot be modified: %s", name);
+        }
+        // Pop the key and value from the stack
+        sq_pop(vm, 2);
+    }
+    // Allow chaining
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+Table CVehicle::Read(Array & names) const
+{
+    // Validate the managed identifier
+    Validate();
+    // Make sure the names are in an array
+    if (names.IsNull() || names.GetType() != OT_ARRAY)
+    {
+        STHROWF("Expected an array of property names");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // The table where the values are stored
+    Table tbl(vm);
+    // Restore the stack on exit
+    const StackGuard sg(vm);
+    // Push the array on the stack
+    sq_pushobject(vm, names.GetObject());
+    sq_pushnull(vm);
+    // Process every name
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        CSStr name = nullptr;
+        // Properties must be identified by name
+        if (sq_gettype(vm, -1) != OT_STRING || SQ_FAILED(sq_getstring(vm, -1, &name)))
+        {
+            STHROWF("Property names must be strings");
+        }
+        // Retrieve the property value
+        switch (FindVehicleProperty(name))
+        {
+            case VEHICLEPROP_EULER_ROTATION:        tbl.SetValue(name, GetRotationEuler()); break;
+            case VEHICLEPROP_HEALTH:                tbl.SetValue(name, _Func->GetVehicleHealth(m_ID)); break;
+            case VEHICLEPROP_ID:                    tbl.SetValue(name, m_ID); break;
+            case VEHICLEPROP_IDLE_RESPAWN_TIMER:    tbl.SetValue(name, _Func->GetVehicleIdleRespawnTimer(m_ID)); break;
+            case VEHICLEPROP_IMMUNITY:              tbl.SetValue(name, _Func->GetVehicleImmunityFlags(m_ID)); break;
+            case VEHICLEPROP_MODEL:                 tbl.SetValue(name, _Func->GetVehicleModel(m_ID)); break;
+            case VEHICLEPROP_POSITION:              tbl.SetValue(name, GetPosition()); break;
+            case VEHICLEPROP_PRIMARY_COLOR:         tbl.SetValue(name, GetPrimaryColor()); break;
+            case VEHICLEPROP_RADIO:                 tbl.SetValue(name, _Func->GetVehicleRadio(m_ID)); break;
+            case VEHICLEPROP_RELATIVE_SPEED:        tbl.SetValue(name, GetRelativeSpeed()); break;
+            case VEHICLEPROP_ROTATION:              tbl.SetValue(name, GetRotation()); break;
+            case VEHICLEPROP_SECONDARY_COLOR:       tbl.SetValue(name, GetSecondaryColor()); break;
+            case VEHICLEPROP_SPAWN_POSITION:        tbl.SetValue(name, GetSpawnPosition()); break;
+            case VEHICLEPROP_SPAWN_ROTATION:        tbl.SetValue(name, GetSpawnRotation()); break;
+            case VEHICLEPROP_SPEED:                 tbl.SetValue(name, GetSpeed()); break;
+            case VEHICLEPROP_SYNC_SOURCE:           tbl.SetValue(name, _Func->GetVehicleSyncSource(m_ID)); break;
+            case VEHICLEPROP_TURN_SPEED:            tbl.SetValue(name, GetTurnSpeed()); break;
+            case VEHICLEPROP_WORLD:                 tbl.SetValue(name, _Func->GetVehicleWorld(m_ID)); break;
+            case VEHICLEPROP_WRECKED:               tbl.SetValue(name, _Func->IsVehicleWrecked(m_ID) != 0); break;
+            default:                                STHROWF("Unknown vehicle property: %s", name);
+        }
+        // Pop the key and value from the stack
+        sq_pop(vm, 2);
+    }
+    // Return the retrieved values
+    return tbl;
+}
+
 // ------------------------------------------------------------------------------------------------
 Float32 CVehicle::GetPositionX() const
 {
@@ -1853,6 +2040,8 @@ void Register_CVehicle(HSQUIRRELVM vm)
         .Prop(_SC("RelTurnSpeedZ"), &CVehicle::GetRelativeTurnSpeedZ, &CVehicle::SetRelativeTurnSpeedZ)
         // Member Methods
         .Func(_SC("StreamedFor"), &CVehicle::IsStreamedFor)
+        .Func(_SC("Apply"), &CVehicle::Apply)
+        .Func(_SC("Read"), &CVehicle::Read)
         .Func(_SC("GetOption"), &CVehicle::GetOption)
         .Func(_SC("SetOption"), &CVehicle::SetOption)
         .Func(_SC("SetOptionEx"), &CVehicle::SetOptionEx)
@@ -657,6 +657,16 @@ public:
     */
     const Quaternion & GetLastRotation() const;
 
+    /* --------------------------------------------------------------------------------------------
+     * Modify multiple properties of the managed vehicle entity from a table of name/value pairs.
+    */
+    CVehicle & Apply(Table & props);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve multiple properties of the managed vehicle entity into a table.
+    */
+    Table Read(Array & names) const;
+
     /* --------------------------------------------------------------------------------------------
      * Retrieve the position on the x axis of the managed vehicle entity.
     */
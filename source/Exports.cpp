@@ -805,6 +805,7 @@ static int32_t SqExport_PopulateSquirrelAPI(HSQLIBAPI api, size_t size)
     api->setinstanceup                  = sq_setinstanceup;
     api->getinstanceup                  = sq_getinstanceup;
     api->setclassudsize                 = sq_setclassudsize;
+    api->setclassaccessors              = sq_setclassaccessors;
     api->newclass                       = sq_newclass;
     api->createinstance                 = sq_createinstance;
     api->setattributes                  = sq_setattributes;
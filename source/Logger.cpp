@@ -7,6 +7,12 @@
 #include <cerrno>
 #include <cstring>
 #include <cstdarg>
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 // ------------------------------------------------------------------------------------------------
 #include <sqrat.h>
@@ -175,15 +181,276 @@ static inline void OutputConsoleMessage(Uint8 level, bool sub, CCStr tms, CCStr
 }
 
 /* ------------------------------------------------------------------------------------------------
- * Identify the associated message color.
+ * Convert the specified time to local time. Safe to use from both the main and the writer thread.
 */
-static inline CCStr GetTimeStampStr()
+static inline const std::tm * GetLocalTime(std::time_t t, std::tm & tm)
 {
-    static CharT tmbuff[80];
-    std::time_t t = std::time(nullptr);
-    std::strftime(tmbuff, sizeof(tmbuff), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+#ifdef SQMOD_OS_WINDOWS
+    return (localtime_s(&tm, &t) == 0) ? &tm : nullptr;
+#else
+    return localtime_r(&t, &tm);
+#endif // SQMOD_OS_WINDOWS
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Format the specified time into the buffer provided by the caller.
+*/
+static inline CCStr GetTimeStampStr(std::time_t t, CStr buff, std::size_t size)
+{
+    std::tm tm;
+    // Was the time converted and formatted?
+    if (!GetLocalTime(t, tm) || std::strftime(buff, size, "%Y-%m-%d %H:%M:%S", &tm) == 0)
+    {
+        *buff = '\0';
+    }
     // Return the resulted buffer
-    return tmbuff;
+    return buff;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Flags that describe a queued log record.
+*/
+enum LogRecordFlags
+{
+    LOGR_HEAD       = (1 << 0), // The record starts a message.
+    LOGR_TAIL       = (1 << 1), // The record ends a message.
+    LOGR_SUB        = (1 << 2), // The message is a sub message.
+    LOGR_CONSOLE    = (1 << 3), // The message goes to the console.
+    LOGR_FILE       = (1 << 4), // The message goes to the log file.
+    LOGR_JSON       = (1 << 5) // The message is a serialized structured record.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * A slot in the asynchronous log queue. Long messages span multiple consecutive records.
+*/
+struct LogRecord
+{
+    std::atomic< std::size_t >  mSequence; // Position of the slot used to synchronize access.
+    std::time_t                 mTime; // When the message was generated.
+    Uint16                      mLength; // Number of characters in this record.
+    Uint8                       mLevel; // The level of the message.
+    Uint8                       mFlags; // How the record should be handled.
+    CharT                       mText[SQMOD_LOG_RECORD_SIZE]; // Portion of the message text.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Bounded lock-free queue of log records consumed by a background writer thread.
+*/
+struct LogQueue
+{
+    // --------------------------------------------------------------------------------------------
+    LogRecord *                 mRecords; // The slots of the queue.
+    const std::size_t           mMask; // Used to wrap positions. The size is a power of two.
+    std::atomic< std::size_t >  mHead; // Position where the next record is pushed.
+    std::atomic< std::size_t >  mTail; // Position where the next record is popped.
+    std::atomic< std::size_t >  mPending; // Records that were pushed but not yet written.
+    std::atomic< Uint32 >       mDropped; // Messages that were discarded since the last report.
+    std::atomic< Uint32 >       mTotalDropped; // Messages that were discarded in total.
+    std::atomic< bool >         mRunning; // Whether the writer should keep waiting for records.
+
+    // --------------------------------------------------------------------------------------------
+    std::mutex                  mMutex; // Used by the writer to wait for records.
+    std::condition_variable     mCond; // Used to wake up the writer.
+    std::mutex                  mOutput; // Held while the writer uses the outputs.
+    std::thread                 mThread; // The writer thread.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    explicit LogQueue(std::size_t size)
+        : mRecords(new LogRecord[size]), mMask(size - 1), mHead(0), mTail(0), mPending(0)
+        , mDropped(0), mTotalDropped(0), mRunning(true), mMutex(), mCond(), mOutput(), mThread()
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            mRecords[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~LogQueue()
+    {
+        delete[] mRecords;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of records currently in the queue.
+    */
+    std::size_t Size() const
+    {
+        return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Claim a free slot. Returns null if the queue is full.
+    */
+    LogRecord * Claim()
+    {
+        std::size_t pos = mHead.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            LogRecord * rec = &mRecords[pos & mMask];
+            const std::size_t seq = rec->mSequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t dif = static_cast< std::ptrdiff_t >(seq) - static_cast< std::ptrdiff_t >(pos);
+            // Is the slot free at this position?
+            if (dif == 0)
+            {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    return rec;
+                }
+            }
+            // Is the queue full?
+            else if (dif < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Make a claimed slot visible to the writer.
+    */
+    void Publish(LogRecord * rec)
+    {
+        mPending.fetch_add(1, std::memory_order_relaxed);
+        rec->mSequence.store(rec->mSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the next published record. Returns null if the queue is empty.
+    */
+    LogRecord * Peek()
+    {
+        const std::size_t pos = mTail.load(std::memory_order_relaxed);
+        LogRecord * rec = &mRecords[pos & mMask];
+        // Was the record at this position published?
+        if (rec->mSequence.load(std::memory_order_acquire) != (pos + 1))
+        {
+            return nullptr;
+        }
+        return rec;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the record returned by Peek so that the slot can be reused.
+    */
+    void Release(LogRecord * rec)
+    {
+        const std::size_t pos = mTail.load(std::memory_order_relaxed);
+        mTail.store(pos + 1, std::memory_order_relaxed);
+        rec->mSequence.store(pos + mMask + 1, std::memory_order_release);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Wake up the writer thread.
+    */
+    void Notify()
+    {
+        mCond.notify_one();
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Lock the outputs if there is a background writer that could use them.
+*/
+static inline std::unique_lock< std::mutex > LockOutput(LogQueue * queue)
+{
+    return queue ? std::unique_lock< std::mutex >(queue->mOutput) : std::unique_lock< std::mutex >();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve a monotonic time in milliseconds.
+*/
+static inline Int64 GetLogClock()
+{
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Identify the name of the level in structured records.
+*/
+static inline CCStr GetLevelName(Uint8 level)
+{
+    switch (level)
+    {
+        case LOGL_DBG:  return "debug";
+        case LOGL_USR:  return "user";
+        case LOGL_SCS:  return "success";
+        case LOGL_INF:  return "info";
+        case LOGL_WRN:  return "warning";
+        case LOGL_ERR:  return "error";
+        case LOGL_FTL:  return "fatal";
+        default:        return "unknown";
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Append a quoted and escaped JSON string to a buffer.
+*/
+static void JsonString(std::string & out, CCStr str, std::size_t len)
+{
+    static const CharT hex[] = "0123456789abcdef";
+    // Open the string
+    out.push_back('"');
+    // Escape the characters that need it
+    for (CCStr end = str + len; str != end; ++str)
+    {
+        const CharT c = *str;
+        switch (c)
+        {
+            case '"':   out.append("\\\"", 2); break;
+            case '\\':  out.append("\\\\", 2); break;
+            case '\n':  out.append("\\n", 2); break;
+            case '\r':  out.append("\\r", 2); break;
+            case '\t':  out.append("\\t", 2); break;
+            default:
+            {
+                // Control characters must be written as unicode escapes
+                if (static_cast< unsigned char >(c) < 0x20)
+                {
+                    out.append("\\u00", 4);
+                    out.push_back(hex[(c >> 4) & 0xF]);
+                    out.push_back(hex[c & 0xF]);
+                }
+                else
+                {
+                    out.push_back(c);
+                }
+            }
+        }
+    }
+    // Close the string
+    out.push_back('"');
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the index of a single level flag.
+*/
+static inline Uint32 GetLevelIndex(Uint8 level)
+{
+    Uint32 idx = 0;
+    // Find the position of the level bit
+    while (level > 1)
+    {
+        level >>= 1, ++idx;
+    }
+    return idx;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Generate the name of a rotated log file.
+*/
+static inline std::string GetRotatedName(const std::string & name, Uint32 index)
+{
+    return index ? (name + '.' + std::to_string(index)) : name;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -198,109 +465,757 @@ Logger::Logger()
     , m_LogFileTime(true)
     , m_File(nullptr)
     , m_Filename()
+    , m_Pattern()
+    , m_MaxSize(0)
+    , m_MaxAge(0)
+    , m_KeepFiles(0)
+    , m_Written(0)
+    , m_Opened(0)
+    , m_FlushInterval(0)
+    , m_WriteBuffer(0)
+    , m_LastFlush(0)
+    , m_Unflushed(false)
+    , m_JsonFile(nullptr)
+    , m_JsonFilename()
+    , m_Json()
+    , m_JsonMessages(false)
+    , m_Queue(nullptr)
+    , m_Overflow(LOGOF_BLOCK)
+    , m_SampleRate(10)
+    , m_Sampled(0)
+    , m_Repeats()
+    , m_RepeatWindow(0)
+    , m_RepeatLimit{0}
+    , m_RepeatSweep(0)
 {
     /* ... */
 }
 
 // ------------------------------------------------------------------------------------------------
-Logger::~Logger()
+Logger::~Logger()
+{
+    ToggleAsync(false);
+    Close();
+    SetJsonFilename(nullptr);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Close()
+{
+    // Write the queued messages before closing the file
+    Flush();
+    // Prevent the writer from using the file while it is closed
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Close the file handle
+    CloseFile();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::CloseFile()
+{
+    // Is there a file handle to close?
+    if (m_File)
+    {
+        // Flush buffered data
+        std::fflush(m_File);
+        // Close the file handle
+        std::fclose(m_File);
+        // Prevent further use of this file handle
+        m_File = nullptr;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::OpenFile(bool append)
+{
+    // Attempt to open the file for writing
+    m_File = std::fopen(m_Filename.c_str(), append ? "a" : "w");
+    // See if the file could be opened
+    if (!m_File)
+    {
+        OutputError("Unable to open the log file (%s) : %s", m_Filename.c_str(), std::strerror(errno));
+        return;
+    }
+    // Use a larger stream buffer so that writes are batched
+    if (m_WriteBuffer)
+    {
+        std::setvbuf(m_File, nullptr, _IOFBF, m_WriteBuffer);
+    }
+    // Start counting for this file
+    m_Written = 0;
+    m_Opened = std::time(nullptr);
+    m_LastFlush = GetLogClock();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::RotateFile(std::time_t tm)
+{
+    // Generate the name of the new file from the pattern
+    CharT name[1024];
+    std::tm ltm;
+    if (!GetLocalTime(tm, ltm) || std::strftime(name, sizeof(name), m_Pattern.c_str(), &ltm) == 0)
+    {
+        CloseFile();
+        m_Filename.clear();
+        return;
+    }
+    // Same name and no files to keep? Reopening it would only discard the current contents
+    else if (m_File && !m_KeepFiles && m_Filename == name)
+    {
+        // Keep writing to the current file and start counting again
+        m_Written = 0;
+        m_Opened = tm;
+        return;
+    }
+    // Close the current file
+    CloseFile();
+    // Did the pattern produce the same name?
+    if (m_Filename == name)
+    {
+        // Discard the oldest file that is kept
+        if (m_KeepFiles)
+        {
+            std::remove(GetRotatedName(m_Filename, m_KeepFiles).c_str());
+        }
+        // Shift the remaining files to make room for the current one
+        for (Uint32 i = m_KeepFiles; i > 0; --i)
+        {
+            std::rename(GetRotatedName(m_Filename, i - 1).c_str(), GetRotatedName(m_Filename, i).c_str());
+        }
+    }
+    else
+    {
+        m_Filename.assign(name);
+    }
+    // Open the new file without discarding a file that already has this name
+    OpenFile(true);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SyncFile(bool force)
+{
+    // Is there anything to flush?
+    if ((!m_File && !m_JsonFile) || !m_Unflushed)
+    {
+        return;
+    }
+    // Is it time to flush?
+    else if (!force)
+    {
+        // Is flushing left to the stream?
+        if (!m_FlushInterval)
+        {
+            return;
+        }
+        // Did the interval elapse?
+        else if (GetLogClock() - m_LastFlush < static_cast< Int64 >(m_FlushInterval))
+        {
+            return;
+        }
+    }
+    // Flush the buffered data
+    if (m_File)
+    {
+        std::fflush(m_File);
+    }
+    if (m_JsonFile)
+    {
+        std::fflush(m_JsonFile);
+    }
+    // Remember when this happened
+    m_LastFlush = GetLogClock();
+    m_Unflushed = false;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetRotation(Uint64 size, Uint32 age, Uint32 keep)
+{
+    // Prevent the writer from reading these while they change
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Assign the new limits
+    m_MaxSize = size;
+    m_MaxAge = age;
+    m_KeepFiles = keep;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Rotate()
+{
+    // Write the queued messages to the current file
+    Flush();
+    // Prevent the writer from using the file while it is replaced
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Is there a file to rotate?
+    if (!m_Pattern.empty())
+    {
+        RotateFile(std::time(nullptr));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetJsonFilename(CCStr filename)
+{
+    // Write the queued records before closing the file
+    Flush();
+    // Prevent the writer from using the file while it is replaced
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Close the current file, if any
+    if (m_JsonFile)
+    {
+        std::fclose(m_JsonFile);
+        m_JsonFile = nullptr;
+    }
+    // Clear the current name
+    m_JsonFilename.clear();
+    // Was there a name specified?
+    if (!filename || *filename == '\0')
+    {
+        return; // We're done here!
+    }
+    // Generate the filename using the current time-stamp
+    CharT name[1024];
+    std::tm tm;
+    if (!GetLocalTime(std::time(nullptr), tm) || std::strftime(name, sizeof(name), filename, &tm) == 0)
+    {
+        return; // We're done here!
+    }
+    m_JsonFilename.assign(name);
+    // Attempt to open the file for writing
+    m_JsonFile = std::fopen(m_JsonFilename.c_str(), "w");
+    // See if the file could be opened
+    if (!m_JsonFile)
+    {
+        OutputError("Unable to open the structured log file (%s) : %s", m_JsonFilename.c_str(), std::strerror(errno));
+    }
+    // Use the same stream buffer size as the log file
+    else if (m_WriteBuffer)
+    {
+        std::setvbuf(m_JsonFile, nullptr, _IOFBF, m_WriteBuffer);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::BeginRecord(std::string & out, Uint8 level) const
+{
+    const Int64 wall = std::chrono::duration_cast< std::chrono::milliseconds >(
+                            std::chrono::system_clock::now().time_since_epoch()).count();
+    const Int64 mono = std::chrono::duration_cast< std::chrono::microseconds >(
+                            std::chrono::steady_clock::now().time_since_epoch()).count();
+    // Start with the fields that every record has
+    out.assign("{\"level\":\"");
+    out.append(GetLevelName(level));
+    out.append("\",\"time\":");
+    out.append(std::to_string(wall));
+    out.append(",\"mono\":");
+    out.append(std::to_string(mono));
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::CommitRecord(std::string & out, Uint8 level)
+{
+    // Finish the record
+    out.append("}\n", 2);
+    // Should the record be written by the background thread?
+    if (m_Queue)
+    {
+        Enqueue(level, LOGR_JSON, out.data(), out.size());
+    }
+    else
+    {
+        OutputJson(out.data(), out.size());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::OutputJson(CCStr data, std::size_t size)
+{
+    if (m_JsonFile)
+    {
+        std::fwrite(data, 1, size, m_JsonFile);
+        // Flush the file if the interval elapsed
+        m_Unflushed = true;
+        if (!m_Queue)
+        {
+            SyncFile(false);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Process()
+{
+    // Report the repeated messages whose window ended
+    SweepRepeats(false);
+    // The background writer takes care of this on its own
+    if (!m_Queue)
+    {
+        SyncFile(false);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetRepeatWindow(Uint32 window)
+{
+    // Report what was counted so far
+    SweepRepeats(true);
+    // Assign the new window
+    m_RepeatWindow = window;
+}
+
+// ------------------------------------------------------------------------------------------------
+Uint32 Logger::GetRepeatLimit(Uint8 level) const
+{
+    return m_RepeatLimit[GetLevelIndex(level)];
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetRepeatLimit(Uint8 level, Uint32 limit)
+{
+    // Apply the limit to every specified level
+    for (Uint32 idx = 0; idx < 8; ++idx)
+    {
+        if (level & (1 << idx))
+        {
+            m_RepeatLimit[idx] = limit;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Logger::Suppress(Uint8 level, bool sub)
+{
+    const Uint32 limit = m_RepeatLimit[GetLevelIndex(level)];
+    // Are repeated messages limited for this level?
+    if (!m_RepeatWindow || !limit)
+    {
+        return false;
+    }
+    // Hash the level and the message text
+    Uint64 hash = 14695981039346656037ULL ^ level;
+    for (CCStr str = m_Buffer.Get(); *str != '\0'; ++str)
+    {
+        hash = (hash ^ static_cast< unsigned char >(*str)) * 1099511628211ULL;
+    }
+    // Obtain the current time
+    const Int64 now = GetLogClock();
+    // Obtain the repeat information of this message
+    Repeat & rep = m_Repeats[hash];
+    // Is this the first time the message is seen?
+    if (rep.mCount == 0)
+    {
+        rep.mStart = now;
+        rep.mLevel = level;
+        rep.mSub = sub;
+        rep.mText.assign(m_Buffer.Get(), std::min(std::strlen(m_Buffer.Get()), static_cast< std::size_t >(96)));
+    }
+    // Did the window of this message end?
+    else if ((now - rep.mStart) >= static_cast< Int64 >(m_RepeatWindow))
+    {
+        Summarize(rep);
+        // Start a new window
+        rep.mStart = now;
+        rep.mCount = 0;
+    }
+    // Was the message seen too many times in this window?
+    return (++rep.mCount > limit);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Summarize(const Repeat & rep)
+{
+    const Uint32 limit = m_RepeatLimit[GetLevelIndex(rep.mLevel)];
+    // Were any messages suppressed?
+    if (!limit || rep.mCount <= limit)
+    {
+        return;
+    }
+    // Generate the summary without touching the internal buffer
+    CharT buf[256];
+    std::snprintf(buf, sizeof(buf), "Previous message repeated %u more times: %s",
+                    rep.mCount - limit, rep.mText.c_str());
+    // Send the summary to the outputs
+    Emit(rep.mLevel, rep.mSub, buf);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SweepRepeats(bool force)
+{
+    // Is there anything to inspect?
+    if (m_Repeats.empty())
+    {
+        return;
+    }
+    // Obtain the current time
+    const Int64 now = GetLogClock();
+    // Don't inspect the messages more often than needed
+    if (!force && (now - m_RepeatSweep) < static_cast< Int64 >(m_RepeatWindow))
+    {
+        return;
+    }
+    m_RepeatSweep = now;
+    // Report and forget the messages whose window ended
+    for (Repeats::iterator itr = m_Repeats.begin(); itr != m_Repeats.end();)
+    {
+        if (force || (now - itr->second.mStart) >= static_cast< Int64 >(m_RepeatWindow))
+        {
+            Summarize(itr->second);
+            itr = m_Repeats.erase(itr);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::SetLogFilename(CCStr filename)
+{
+    // Close the current logging file, if any
+    Close();
+    // Clear the current name
+    m_Filename.clear();
+    m_Pattern.clear();
+    // Was there a name specified?
+    if (!filename || *filename == '\0')
+    {
+        return; // We're done here!
+    }
+    // Remember the pattern for when the file is rotated
+    m_Pattern.assign(filename);
+    // Make sure the internal buffer has some memory
+    m_Buffer.Adjust(1024);
+    // Obtain the current local time for generating the filename
+    std::tm tm;
+    // Generate the filename using the current time-stamp
+    if (GetLocalTime(std::time(nullptr), tm) && std::strftime(m_Buffer.Data(), m_Buffer.Size(), filename, &tm) > 0)
+    {
+        m_Filename.assign(m_Buffer.Data());
+    }
+    else
+    {
+        return; // We're done here!
+    }
+    // Prevent the writer from using the file while it is opened
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Attempt to open the file for writing
+    OpenFile();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Initialize(CCStr filename)
+{
+    // Close the logging file
+    Close();
+    // Allocate some memory in the buffer
+    m_Buffer.Adjust(1024);
+    // Set the log file name and open the file if necessary
+    SetLogFilename(filename);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Terminate()
+{
+    // Write the queued messages and stop the writer
+    ToggleAsync(false);
+    // Release all the buffer resources and references
+    m_Buffer.ResetAll();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::ToggleAsync(bool enabled)
+{
+    // Is there anything to change?
+    if (enabled == (m_Queue != nullptr))
+    {
+        return;
+    }
+    // Should we start the writer?
+    else if (enabled)
+    {
+        m_Queue = new LogQueue(SQMOD_LOG_QUEUE_SIZE);
+        // Start the writer thread
+        try
+        {
+            m_Queue->mThread = std::thread(&Logger::Consume, this);
+        }
+        catch (const std::exception & e)
+        {
+            delete m_Queue;
+            m_Queue = nullptr;
+            // Continue to write the messages directly
+            OutputError("Unable to start the log writer thread: %s", e.what());
+        }
+        return;
+    }
+    // Tell the writer to stop once the queue is empty
+    m_Queue->mRunning.store(false);
+    {
+        std::lock_guard< std::mutex > lock(m_Queue->mMutex);
+        m_Queue->Notify();
+    }
+    // Wait for the remaining messages to be written
+    m_Queue->mThread.join();
+    // Release the queue
+    delete m_Queue;
+    m_Queue = nullptr;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Flush()
 {
-    Close();
+    // Report the messages that were suppressed so far
+    SweepRepeats(true);
+    // Is there a writer to wait for?
+    if (m_Queue)
+    {
+        // Wait until all records were written
+        while (m_Queue->mPending.load() != 0)
+        {
+            m_Queue->Notify();
+            std::this_thread::yield();
+        }
+    }
+    // Prevent the writer from using the file while it is flushed
+    std::unique_lock< std::mutex > lock = LockOutput(m_Queue);
+    // Write the buffered data to the file
+    SyncFile(true);
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::Close()
+Uint32 Logger::GetDropped() const
 {
-    // Is there a file handle to close?
-    if (m_File)
-    {
-        // Flush buffered data
-        std::fflush(m_File);
-        // Close the file handle
-        std::fclose(m_File);
-        // Prevent further use of this file handle
-        m_File = nullptr;
-    }
+    return m_Queue ? m_Queue->mTotalDropped.load() : 0;
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::SetLogFilename(CCStr filename)
+void Logger::Enqueue(Uint8 level, Uint8 flags, CCStr msg, std::size_t len)
 {
-    // Close the current logging file, if any
-    Close();
-    // Clear the current name
-    m_Filename.clear();
-    // Was there a name specified?
-    if (!filename || *filename == '\0')
+    // Number of records needed for the message
+    const std::size_t count = (len / SQMOD_LOG_RECORD_SIZE) + 1;
+    // Should this message be skipped while sampling?
+    if (m_Overflow == LOGOF_SAMPLE && m_Queue->Size() >= (SQMOD_LOG_QUEUE_SIZE / 2) && (++m_Sampled % m_SampleRate) != 0)
     {
-        return; // We're done here!
+        ++(m_Queue->mDropped), ++(m_Queue->mTotalDropped);
+        return;
     }
-    // Make sure the internal buffer has some memory
-    m_Buffer.Adjust(1024);
-    // Obtain the current time for generating the filename
-    const std::time_t t = std::time(nullptr);
-    // Generate the filename using the current time-stamp
-    if (std::strftime(m_Buffer.Data(), m_Buffer.Size(), filename, std::localtime(&t)) > 0)
+    // Is there enough room for the whole message if it can't wait?
+    else if (m_Overflow != LOGOF_BLOCK && (m_Queue->Size() + count) > SQMOD_LOG_QUEUE_SIZE)
     {
-        m_Filename.assign(m_Buffer.Data());
+        ++(m_Queue->mDropped), ++(m_Queue->mTotalDropped);
+        return;
     }
-    else
+    // Obtain the time once for all records
+    const std::time_t tm = std::time(nullptr);
+    // Split the message into records
+    for (std::size_t i = 0; i < count; ++i)
     {
-        return; // We're done here!
+        LogRecord * rec = m_Queue->Claim();
+        // Wait for the writer to make room
+        while (!rec)
+        {
+            m_Queue->Notify();
+            std::this_thread::yield();
+            rec = m_Queue->Claim();
+        }
+        // Copy this portion of the message
+        const std::size_t n = std::min(len, static_cast< std::size_t >(SQMOD_LOG_RECORD_SIZE));
+        std::memcpy(rec->mText, msg, n);
+        msg += n, len -= n;
+        // Fill the remaining information
+        rec->mTime = tm;
+        rec->mLength = static_cast< Uint16 >(n);
+        rec->mLevel = level;
+        rec->mFlags = flags | (i == 0 ? LOGR_HEAD : 0) | ((i + 1) == count ? LOGR_TAIL : 0);
+        // Make the record visible to the writer
+        m_Queue->Publish(rec);
     }
-    // Attempt to open the file for writing
-    m_File = std::fopen(m_Filename.c_str(), "w");
-    // See if the file could be opened
-    if (!m_File)
+    // Wake up the writer
+    m_Queue->Notify();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Logger::Consume()
+{
+    // The message currently assembled from records
+    std::string msg;
+    msg.reserve(1024);
+    // Process records until stopped
+    for (;;)
     {
-        OutputError("Unable to open the log file (%s) : %s", m_Filename.c_str(), std::strerror(errno));
+        bool written = false;
+        // Write all the published records
+        for (LogRecord * rec = m_Queue->Peek(); rec != nullptr; rec = m_Queue->Peek())
+        {
+            // Does a new message start here?
+            if (rec->mFlags & LOGR_HEAD)
+            {
+                msg.clear();
+            }
+            // Append this portion of the message
+            msg.append(rec->mText, rec->mLength);
+            // Grab the information before the slot is reused
+            const Uint8 level = rec->mLevel, flags = rec->mFlags;
+            const std::time_t tm = rec->mTime;
+            // Allow the slot to be reused
+            m_Queue->Release(rec);
+            // Is this a structured record?
+            if ((flags & (LOGR_TAIL | LOGR_JSON)) == (LOGR_TAIL | LOGR_JSON))
+            {
+                std::lock_guard< std::mutex > lock(m_Queue->mOutput);
+                // Save the record as is
+                OutputJson(msg.data(), msg.size());
+            }
+            // Is the message complete?
+            else if (flags & LOGR_TAIL)
+            {
+                std::lock_guard< std::mutex > lock(m_Queue->mOutput);
+                // Send the message to the outputs
+                Output(level, (flags & LOGR_SUB) != 0, tm, msg.c_str(), (flags & LOGR_CONSOLE) != 0, (flags & LOGR_FILE) != 0);
+            }
+            written = true;
+            // This record was handled
+            m_Queue->mPending.fetch_sub(1);
+        }
+        // Were any messages discarded since the last report?
+        const Uint32 dropped = m_Queue->mDropped.exchange(0);
+        if (dropped)
+        {
+            CharT buf[128];
+            std::snprintf(buf, sizeof(buf), "%u log messages were discarded because the queue was full", dropped);
+            // Let the user know that messages are missing
+            std::lock_guard< std::mutex > lock(m_Queue->mOutput);
+            Output(LOGL_WRN, false, std::time(nullptr), buf, true, true);
+        }
+        // Push the written data to the file if the flush interval elapsed
+        {
+            std::lock_guard< std::mutex > lock(m_Queue->mOutput);
+            SyncFile(false);
+        }
+        // Keep going while there are records
+        if (written)
+        {
+            continue;
+        }
+        // Should we stop? Only after the queue is empty
+        else if (!m_Queue->mRunning.load())
+        {
+            break;
+        }
+        // Wait for more records
+        else
+        {
+            std::unique_lock< std::mutex > lock(m_Queue->mMutex);
+            m_Queue->mCond.wait_for(lock, std::chrono::milliseconds(10));
+        }
     }
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::Initialize(CCStr filename)
+void Logger::Proccess(Uint8 level, bool sub)
 {
-    // Close the logging file
-    Close();
-    // Allocate some memory in the buffer
-    m_Buffer.Adjust(1024);
-    // Set the log file name and open the file if necessary
-    SetLogFilename(filename);
+    // Was this message repeated too many times?
+    if (!Suppress(level, sub))
+    {
+        Emit(level, sub, m_Buffer.Get());
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::Terminate()
+void Logger::Emit(Uint8 level, bool sub, CCStr msg)
 {
-    // Release all the buffer resources and references
-    m_Buffer.ResetAll();
+    // Should the message be written by the background thread?
+    if (m_Queue)
+    {
+        // Build the flags of the records
+        Uint8 flags = sub ? LOGR_SUB : 0;
+        // Are we allowed to send this message level to console?
+        if (m_ConsoleLevels & level)
+        {
+            flags |= LOGR_CONSOLE;
+        }
+        // Are we allowed to write it to a file?
+        if (m_LogFileLevels & level)
+        {
+            flags |= LOGR_FILE;
+        }
+        // Is there anywhere to send this message?
+        if (flags & (LOGR_CONSOLE | LOGR_FILE))
+        {
+            Enqueue(level, flags, msg, std::strlen(msg));
+        }
+    }
+    else
+    {
+        Output(level, sub, std::time(nullptr), msg, (m_ConsoleLevels & level) != 0, (m_LogFileLevels & level) != 0);
+    }
+    // Should the message also be saved as a structured record?
+    if (m_JsonMessages && IsJsonLevel(level))
+    {
+        BeginRecord(m_Json, level);
+        // Append the message
+        m_Json.append(",\"msg\":");
+        JsonString(m_Json, msg, std::strlen(msg));
+        // Mark sub messages
+        if (sub)
+        {
+            m_Json.append(",\"sub\":true");
+        }
+        // Save the record
+        CommitRecord(m_Json, level);
+    }
 }
 
 // ------------------------------------------------------------------------------------------------
-void Logger::Proccess(Uint8 level, bool sub)
+void Logger::Output(Uint8 level, bool sub, std::time_t tm, CCStr msg, bool console, bool file)
 {
     // Obtain the time-stamp if necessary
-    CCStr tms = (m_ConsoleTime || m_LogFileTime) ? GetTimeStampStr() : nullptr;
+    CharT tmbuff[80];
+    CCStr tms = (m_ConsoleTime || m_LogFileTime) ? GetTimeStampStr(tm, tmbuff, sizeof(tmbuff)) : nullptr;
     // Are we allowed to send this message level to console?
-    if (m_ConsoleLevels & level)
+    if (console)
     {
-        OutputConsoleMessage(level, sub, (m_ConsoleTime ? tms : nullptr), m_Buffer.Get());
+        OutputConsoleMessage(level, sub, (m_ConsoleTime ? tms : nullptr), msg);
     }
     // Are we allowed to write it to a file?
-    if (m_File && (m_LogFileLevels & level))
+    if (m_File && file)
     {
+        // Obtain the size of the decorated message
+        CCStr tag = GetLevelTag(level);
+        const bool stamp = (m_LogFileTime && tms);
+        const Uint64 size = std::strlen(tag) + (stamp ? std::strlen(tms) + 1 : 0) + std::strlen(msg) + 2;
+        // Should we start a new file before writing this message?
+        if ((m_MaxSize && (m_Written + size) > m_MaxSize && m_Written) ||
+            (m_MaxAge && (tm - m_Opened) >= static_cast< std::time_t >(m_MaxAge)))
+        {
+            RotateFile(tm);
+            // Could the new file be opened?
+            if (!m_File)
+            {
+                return;
+            }
+        }
         // Write the level tag
-        std::fputs(GetLevelTag(level), m_File);
+        std::fputs(tag, m_File);
         std::fputc(' ', m_File);
         // Should we include the time-stamp?
-        if (m_LogFileTime && tms)
+        if (stamp)
         {
             std::fputs(tms, m_File);
             std::fputc(' ', m_File);
         }
         // Write the message
-        std::fputs(m_Buffer.Get(), m_File);
+        std::fputs(msg, m_File);
         // Append a new line
         std::fputc('\n', m_File);
+        // Keep track of the written data
+        m_Written += size;
+        m_Unflushed = true;
+        // Flush the file if the interval elapsed
+        if (!m_Queue)
+        {
+            SyncFile(false);
+        }
     }
 }
 
@@ -551,6 +1466,188 @@ template < Uint8 L, bool S > static SQInteger LogBasicMessage(HSQUIRRELVM vm)
     return 0;
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Append the value at the specified stack index as a JSON object key to a buffer.
+*/
+static void JsonKey(std::string & out, HSQUIRRELVM vm, SQInteger idx)
+{
+    // Use string keys directly
+    if (sq_gettype(vm, idx) == OT_STRING)
+    {
+        CSStr val = nullptr;
+        sq_getstring(vm, idx, &val);
+        JsonString(out, val, static_cast< std::size_t >(sq_getsize(vm, idx)));
+        return;
+    }
+    // Use the string representation of anything else
+    StackStrF val(vm, idx, false);
+    if (SQ_SUCCEEDED(val.mRes))
+    {
+        JsonString(out, val.mPtr, static_cast< std::size_t >(val.mLen));
+    }
+    else
+    {
+        out.append("\"\"", 2);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Append the value at the specified stack index as JSON to a buffer.
+*/
+static void JsonValue(std::string & out, HSQUIRRELVM vm, SQInteger idx, Uint32 depth)
+{
+    // Make the index absolute since values are pushed while serializing
+    if (idx < 0)
+    {
+        idx = sq_gettop(vm) + idx + 1;
+    }
+    // Serialize the value according to its type
+    switch (sq_gettype(vm, idx))
+    {
+        case OT_NULL:
+        {
+            out.append("null", 4);
+        } break;
+        case OT_BOOL:
+        {
+            SQBool val = SQFalse;
+            sq_getbool(vm, idx, &val);
+            out.append(val ? "true" : "false");
+        } break;
+        case OT_INTEGER:
+        {
+            SQInteger val = 0;
+            sq_getinteger(vm, idx, &val);
+            out.append(std::to_string(val));
+        } break;
+        case OT_FLOAT:
+        {
+            SQFloat val = 0;
+            sq_getfloat(vm, idx, &val);
+            // Infinity and NaN have no representation in JSON
+            if (!std::isfinite(val))
+            {
+                out.append("null", 4);
+            }
+            else
+            {
+                CharT buf[32];
+                out.append(buf, std::snprintf(buf, sizeof(buf), "%.*g",
+                                              std::numeric_limits< SQFloat >::max_digits10, val));
+            }
+        } break;
+        case OT_STRING:
+        {
+            CSStr val = nullptr;
+            sq_getstring(vm, idx, &val);
+            JsonString(out, val, static_cast< std::size_t >(sq_getsize(vm, idx)));
+        } break;
+        case OT_TABLE:
+        case OT_ARRAY:
+        {
+            const bool table = (sq_gettype(vm, idx) == OT_TABLE);
+            // Prevent cyclic or deeply nested containers from going further
+            if (depth >= 8)
+            {
+                out.append("null", 4);
+                break;
+            }
+            out.push_back(table ? '{' : '[');
+            // Iterate over the elements of the container
+            bool first = true;
+            sq_pushnull(vm);
+            while (SQ_SUCCEEDED(sq_next(vm, idx)))
+            {
+                // Separate the elements
+                if (!first)
+                {
+                    out.push_back(',');
+                }
+                first = false;
+                // Tables need a string key
+                if (table)
+                {
+                    JsonKey(out, vm, -2);
+                    out.push_back(':');
+                }
+                // Append the element value
+                JsonValue(out, vm, -1, depth + 1);
+                // Pop the key and value
+                sq_pop(vm, 2);
+            }
+            // Pop the iterator
+            sq_pop(vm, 1);
+            out.push_back(table ? '}' : ']');
+        } break;
+        default:
+        {
+            // Use the string representation of anything else
+            StackStrF val(vm, idx, false);
+            if (SQ_SUCCEEDED(val.mRes))
+            {
+                JsonString(out, val.mPtr, static_cast< std::size_t >(val.mLen));
+            }
+            else
+            {
+                out.append("null", 4);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+template < Uint8 L > static SQInteger LogEventRecord(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the event name specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing event name");
+    }
+    // Were the fields specified as a table?
+    else if (top > 2 && sq_gettype(vm, 3) != OT_TABLE && sq_gettype(vm, 3) != OT_NULL)
+    {
+        return sq_throwerror(vm, "Event fields must be specified as a table");
+    }
+    // Is there anyone to receive this record?
+    else if (!Logger::Get().IsJsonLevel(L))
+    {
+        return 0;
+    }
+    // Attempt to generate the name value
+    StackStrF name(vm, 2, false);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(name.mRes))
+    {
+        return name.mRes; // Propagate the error!
+    }
+    // Start the record in a buffer of its own since the fields can run script code that logs
+    std::string out;
+    Logger::Get().BeginRecord(out, L);
+    // Append the event name
+    out.append(",\"event\":");
+    JsonString(out, name.mPtr, static_cast< std::size_t >(name.mLen));
+    // Append the location where the event was generated
+    SQStackInfos si;
+    if (SQ_SUCCEEDED(sq_stackinfos(vm, 1, &si)))
+    {
+        out.append(",\"source\":");
+        JsonString(out, si.source ? si.source : _SC("unknown"), std::strlen(si.source ? si.source : _SC("unknown")));
+        out.append(",\"line\":");
+        out.append(std::to_string(si.line));
+    }
+    // Append the fields, if any
+    if (top > 2 && sq_gettype(vm, 3) == OT_TABLE)
+    {
+        out.append(",\"fields\":");
+        JsonValue(out, vm, 3, 0);
+    }
+    // Save the record
+    Logger::Get().CommitRecord(out, L);
+    // This function does not return a value
+    return 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 static void SqLogClose()
 {
@@ -659,6 +1756,150 @@ static void SqLogSetLogFilename(CSStr filename)
     Logger::Get().SetLogFilename(filename);
 }
 
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetAsync(bool toggle)
+{
+    Logger::Get().ToggleAsync(toggle);
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool SqLogIsAsync()
+{
+    return Logger::Get().IsAsync();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetOverflow(Uint8 policy)
+{
+    if (policy > LOGOF_SAMPLE)
+    {
+        STHROWF("Unknown log overflow policy: %u", policy);
+    }
+    Logger::Get().SetOverflow(policy);
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint8 SqLogGetOverflow()
+{
+    return Logger::Get().GetOverflow();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetSampleRate(Uint32 rate)
+{
+    Logger::Get().SetSampleRate(rate);
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetSampleRate()
+{
+    return Logger::Get().GetSampleRate();
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetDropped()
+{
+    return Logger::Get().GetDropped();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogFlush()
+{
+    Logger::Get().Flush();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRotation(SQInteger size, SQInteger age, SQInteger keep)
+{
+    Logger::Get().SetRotation(static_cast< Uint64 >(ClampMin(size, SQInteger(0))),
+                                ConvTo< Uint32 >::From(ClampMin(age, SQInteger(0))),
+                                ConvTo< Uint32 >::From(ClampMin(keep, SQInteger(0))));
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqLogGetMaxFileSize()
+{
+    return static_cast< SQInteger >(Logger::Get().GetMaxFileSize());
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetMaxFileAge()
+{
+    return Logger::Get().GetMaxFileAge();
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetKeepFiles()
+{
+    return Logger::Get().GetKeepFiles();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogRotate()
+{
+    Logger::Get().Rotate();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetFlushInterval(Uint32 interval)
+{
+    Logger::Get().SetFlushInterval(interval);
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetFlushInterval()
+{
+    return Logger::Get().GetFlushInterval();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRepeatWindow(Uint32 window)
+{
+    Logger::Get().SetRepeatWindow(window);
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetRepeatWindow()
+{
+    return Logger::Get().GetRepeatWindow();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetRepeatLimit(Uint8 level, Uint32 limit)
+{
+    Logger::Get().SetRepeatLimit(level, limit);
+}
+
+// ------------------------------------------------------------------------------------------------
+static Uint32 SqLogGetRepeatLimit(Uint8 level)
+{
+    return Logger::Get().GetRepeatLimit(level);
+}
+
+// ------------------------------------------------------------------------------------------------
+static const String & SqLogGetJsonFilename()
+{
+    return Logger::Get().GetJsonFilename();
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogSetJsonFilename(CSStr filename)
+{
+    Logger::Get().SetJsonFilename(filename);
+}
+
+// ------------------------------------------------------------------------------------------------
+static void SqLogToggleJsonMessages(bool toggle)
+{
+    Logger::Get().ToggleJsonMessages(toggle);
+}
+
+// ------------------------------------------------------------------------------------------------
+static bool SqLogHasJsonMessages()
+{
+    return Logger::Get().HasJsonMessages();
+}
+
 // ================================================================================================
 void Register_Log(HSQUIRRELVM vm)
 {
@@ -678,6 +1919,10 @@ void Register_Log(HSQUIRRELVM vm)
         .SquirrelFunc(_SC("SWrn"), &LogBasicMessage< LOGL_WRN, true >)
         .SquirrelFunc(_SC("SErr"), &LogBasicMessage< LOGL_ERR, true >)
         .SquirrelFunc(_SC("SFtl"), &LogBasicMessage< LOGL_FTL, true >)
+        .SquirrelFunc(_SC("Event"), &LogEventRecord< LOGL_INF >)
+        .SquirrelFunc(_SC("DbgEvent"), &LogEventRecord< LOGL_DBG >)
+        .SquirrelFunc(_SC("WrnEvent"), &LogEventRecord< LOGL_WRN >)
+        .SquirrelFunc(_SC("ErrEvent"), &LogEventRecord< LOGL_ERR >)
         .Func(_SC("Close"), &SqLogClose)
         .Func(_SC("Initialize"), &SqLogInitialize)
         .Func(_SC("ToggleConsoleTime"), &SqLogToggleConsoleTime)
@@ -696,6 +1941,35 @@ void Register_Log(HSQUIRRELVM vm)
         .Func(_SC("ToggleLogFileLevel"), &SqLogToggleLogFileLevel)
         .Func(_SC("GetLogFilename"), &SqLogGetLogFilename)
         .Func(_SC("SetLogFilename"), &SqLogSetLogFilename)
+        .Func(_SC("SetAsync"), &SqLogSetAsync)
+        .Func(_SC("IsAsync"), &SqLogIsAsync)
+        .Func(_SC("SetOverflow"), &SqLogSetOverflow)
+        .Func(_SC("GetOverflow"), &SqLogGetOverflow)
+        .Func(_SC("SetSampleRate"), &SqLogSetSampleRate)
+        .Func(_SC("GetSampleRate"), &SqLogGetSampleRate)
+        .Func(_SC("GetDropped"), &SqLogGetDropped)
+        .Func(_SC("Flush"), &SqLogFlush)
+        .Func(_SC("SetRotation"), &SqLogSetRotation)
+        .Func(_SC("GetMaxFileSize"), &SqLogGetMaxFileSize)
+        .Func(_SC("GetMaxFileAge"), &SqLogGetMaxFileAge)
+        .Func(_SC("GetKeepFiles"), &SqLogGetKeepFiles)
+        .Func(_SC("Rotate"), &SqLogRotate)
+        .Func(_SC("SetFlushInterval"), &SqLogSetFlushInterval)
+        .Func(_SC("GetFlushInterval"), &SqLogGetFlushInterval)
+        .Func(_SC("SetRepeatWindow"), &SqLogSetRepeatWindow)
+        .Func(_SC("GetRepeatWindow"), &SqLogGetRepeatWindow)
+        .Func(_SC("SetRepeatLimit"), &SqLogSetRepeatLimit)
+        .Func(_SC("GetRepeatLimit"), &SqLogGetRepeatLimit)
+        .Func(_SC("GetJsonFilename"), &SqLogGetJsonFilename)
+        .Func(_SC("SetJsonFilename"), &SqLogSetJsonFilename)
+        .Func(_SC("ToggleJsonMessages"), &SqLogToggleJsonMessages)
+        .Func(_SC("HasJsonMessages"), &SqLogHasJsonMessages)
+    );
+
+    ConstTable(vm).Enum(_SC("SqLogOverflow"), Enumeration(vm)
+        .Const(_SC("Block"),    static_cast< SQInteger >(LOGOF_BLOCK))
+        .Const(_SC("Drop"),     static_cast< SQInteger >(LOGOF_DROP))
+        .Const(_SC("Sample"),   static_cast< SQInteger >(LOGOF_SAMPLE))
     );
 }
 
@@ -6,8 +6,10 @@
 #include "Base/Buffer.hpp"
 
 // ------------------------------------------------------------------------------------------------
+#include <ctime>
 #include <cstdio>
 #include <string>
+#include <unordered_map>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
@@ -28,6 +30,19 @@ enum LogLvl
     LOGL_ANY = 0xFF
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * What happens to a message when the asynchronous log queue is full.
+*/
+enum LogOverflow
+{
+    LOGOF_BLOCK = 0, // Wait for the writer to make room.
+    LOGOF_DROP, // Discard the message.
+    LOGOF_SAMPLE // Keep only some of the messages once the queue is half full and discard the rest.
+};
+
+// ------------------------------------------------------------------------------------------------
+struct LogQueue;
+
 /* ------------------------------------------------------------------------------------------------
  * Class responsible for logging output.
 */
@@ -68,6 +83,21 @@ private:
     */
     Logger & operator = (Logger && o) = delete;
 
+    /* --------------------------------------------------------------------------------------------
+     * Structure used to keep track of a message that is repeated.
+    */
+    struct Repeat
+    {
+        Int64       mStart; // When the current window started.
+        Uint32      mCount; // Number of times the message was seen in the current window.
+        Uint8       mLevel; // The level of the message.
+        bool        mSub; // Whether this is a sub message.
+        std::string mText; // The beginning of the message, used in the summary.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::unordered_map< Uint64, Repeat > Repeats; // Repeated messages indexed by hash.
+
 private:
 
     // --------------------------------------------------------------------------------------------
@@ -84,6 +114,38 @@ private:
     // --------------------------------------------------------------------------------------------
     std::FILE*  m_File; // Handle to the file where the logs should be saved.
     std::string m_Filename; // The name of the file where the logs are saved.
+    std::string m_Pattern; // The pattern used to generate the name of the log file.
+
+    // --------------------------------------------------------------------------------------------
+    Uint64      m_MaxSize; // Start a new file when the current one exceeds this many bytes.
+    Uint32      m_MaxAge; // Start a new file when the current one is older than this many seconds.
+    Uint32      m_KeepFiles; // The number of rotated files to keep.
+    Uint64      m_Written; // The number of bytes written to the current file.
+    std::time_t m_Opened; // When the current file was opened.
+
+    // --------------------------------------------------------------------------------------------
+    Uint32      m_FlushInterval; // Milliseconds between flushes of the log file. Zero leaves it to the stream.
+    Uint32      m_WriteBuffer; // The size of the stream buffer of the log file.
+    Int64       m_LastFlush; // When the log file was last flushed.
+    bool        m_Unflushed; // Whether there is data that was not flushed yet.
+
+    // --------------------------------------------------------------------------------------------
+    std::FILE*  m_JsonFile; // Handle to the file where the structured records are saved.
+    std::string m_JsonFilename; // The name of the file where the structured records are saved.
+    std::string m_Json; // Buffer used to serialize the structured records of log messages.
+    bool        m_JsonMessages; // Whether regular messages are also saved as structured records.
+
+    // --------------------------------------------------------------------------------------------
+    LogQueue*   m_Queue; // Queue of the asynchronous writer, if enabled.
+    Uint8       m_Overflow; // What happens to a message when the queue is full.
+    Uint32      m_SampleRate; // Keep one of this many messages when sampling.
+    Uint32      m_Sampled; // Number of messages seen while sampling.
+
+    // --------------------------------------------------------------------------------------------
+    Repeats     m_Repeats; // Messages seen in the current window.
+    Uint32      m_RepeatWindow; // Milliseconds during which identical messages are counted.
+    Uint32      m_RepeatLimit[8]; // Identical messages allowed in a window for each level.
+    Int64       m_RepeatSweep; // When the repeated messages were last inspected.
 
 protected:
 
@@ -92,6 +154,67 @@ protected:
     */
     void Proccess(Uint8 level, bool sub);
 
+    /* --------------------------------------------------------------------------------------------
+     * Send a message to the console, log file and structured log file.
+    */
+    void Emit(Uint8 level, bool sub, CCStr msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the message in the internal buffer was repeated too many times.
+    */
+    bool Suppress(Uint8 level, bool sub);
+
+    /* --------------------------------------------------------------------------------------------
+     * Report how many times a message was suppressed during its window.
+    */
+    void Summarize(const Repeat & rep);
+
+    /* --------------------------------------------------------------------------------------------
+     * Report and forget the repeated messages whose window ended, or all of them if forced.
+    */
+    void SweepRepeats(bool force);
+
+    /* --------------------------------------------------------------------------------------------
+     * Send a message to the console and log file.
+    */
+    void Output(Uint8 level, bool sub, std::time_t tm, CCStr msg, bool console, bool file);
+
+    /* --------------------------------------------------------------------------------------------
+     * Push a message to the asynchronous writer.
+    */
+    void Enqueue(Uint8 level, Uint8 flags, CCStr msg, std::size_t len);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the queued messages until the asynchronous writer is stopped.
+    */
+    void Consume();
+
+    /* --------------------------------------------------------------------------------------------
+     * Open the log file with the current name. The output must be locked by the caller. Existing
+     * contents are discarded unless appending.
+    */
+    void OpenFile(bool append = false);
+
+    /* --------------------------------------------------------------------------------------------
+     * Close the log file. The output must be locked by the caller.
+    */
+    void CloseFile();
+
+    /* --------------------------------------------------------------------------------------------
+     * Close the current log file, shift the kept files and open a new one.
+    */
+    void RotateFile(std::time_t tm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Flush the log file if forced or if the flush interval elapsed.
+    */
+    void SyncFile(bool force);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write a serialized record to the structured log file.
+    */
+    void OutputJson(CCStr data, std::size_t size);
+
 public:
 
     /* --------------------------------------------------------------------------------------------
@@ -117,6 +240,61 @@ public:
     */
     void Terminate();
 
+    /* --------------------------------------------------------------------------------------------
+     * Enable or disable writing messages from a background thread.
+    */
+    void ToggleAsync(bool enabled);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether messages are written from a background thread.
+    */
+    bool IsAsync() const
+    {
+        return (m_Queue != nullptr);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Wait until all queued messages were written and flush the log file.
+    */
+    void Flush();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve what happens to a message when the queue is full.
+    */
+    Uint8 GetOverflow() const
+    {
+        return m_Overflow;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify what happens to a message when the queue is full.
+    */
+    void SetOverflow(Uint8 policy)
+    {
+        m_Overflow = policy;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve how many messages are seen for every message kept while sampling.
+    */
+    Uint32 GetSampleRate() const
+    {
+        return m_SampleRate;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify how many messages are seen for every message kept while sampling.
+    */
+    void SetSampleRate(Uint32 rate)
+    {
+        m_SampleRate = rate ? rate : 1;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of messages that were discarded because the queue was full.
+    */
+    Uint32 GetDropped() const;
+
     /* --------------------------------------------------------------------------------------------
      * Enable or disable console message time stamping.
     */
@@ -260,6 +438,148 @@ public:
     */
     void SetLogFilename(CCStr filename);
 
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size in bytes after which a new log file is started.
+    */
+    Uint64 GetMaxFileSize() const
+    {
+        return m_MaxSize;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the age in seconds after which a new log file is started.
+    */
+    Uint32 GetMaxFileAge() const
+    {
+        return m_MaxAge;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of rotated log files to keep.
+    */
+    Uint32 GetKeepFiles() const
+    {
+        return m_KeepFiles;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify when a new log file is started and how many of the old ones are kept.
+    */
+    void SetRotation(Uint64 size, Uint32 age, Uint32 keep);
+
+    /* --------------------------------------------------------------------------------------------
+     * Close the current log file and start a new one.
+    */
+    void Rotate();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds between flushes of the log file.
+    */
+    Uint32 GetFlushInterval() const
+    {
+        return m_FlushInterval;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds between flushes of the log file.
+    */
+    void SetFlushInterval(Uint32 interval)
+    {
+        m_FlushInterval = interval;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size of the stream buffer of the log file.
+    */
+    Uint32 GetWriteBuffer() const
+    {
+        return m_WriteBuffer;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the size of the stream buffer of the log file. Applies to the next opened file.
+    */
+    void SetWriteBuffer(Uint32 size)
+    {
+        m_WriteBuffer = size;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Flush the log file if the flush interval elapsed. Used when there is no background writer.
+    */
+    void Process();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the milliseconds during which identical messages are counted.
+    */
+    Uint32 GetRepeatWindow() const
+    {
+        return m_RepeatWindow;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the milliseconds during which identical messages are counted. Zero disables the limit.
+    */
+    void SetRepeatWindow(Uint32 window);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of identical messages allowed in a window for a level.
+    */
+    Uint32 GetRepeatLimit(Uint8 level) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of identical messages allowed in a window for a level. Zero means unlimited.
+    */
+    void SetRepeatLimit(Uint8 level, Uint32 limit);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the name of the structured log file.
+    */
+    const std::string & GetJsonFilename() const
+    {
+        return m_JsonFilename;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the name of the structured log file. An empty name closes it.
+    */
+    void SetJsonFilename(CCStr filename);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether regular messages are also saved as structured records.
+    */
+    bool HasJsonMessages() const
+    {
+        return m_JsonMessages;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether regular messages are also saved as structured records.
+    */
+    void ToggleJsonMessages(bool toggle)
+    {
+        m_JsonMessages = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a structured record with the specified level would be saved.
+    */
+    bool IsJsonLevel(Uint8 level) const
+    {
+        return (m_JsonFile && (m_LogFileLevels & level));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Start a structured record in the specified buffer. The remaining fields are appended by the
+     * caller. Records that run script code while they are built must use a buffer of their own.
+    */
+    void BeginRecord(std::string & out, Uint8 level) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Finish the structured record in the specified buffer and save it.
+    */
+    void CommitRecord(std::string & out, Uint8 level);
+
     /* --------------------------------------------------------------------------------------------
      * Send a log message.
     */
@@ -16,6 +16,11 @@ static bool g_Reload = false;
 extern void InitExports();
 extern void ProcessTasks();
 extern void ProcessRoutines();
+extern void ProcessStreamer();
+extern void ProcessOutbox();
+extern void ProcessCollector();
+extern void ProcessMemory();
+extern void ProcessPaths(Float32 elapsed);
 
 /* ------------------------------------------------------------------------------------------------
  * Will the scripts be reloaded at the end of the current event?
@@ -190,6 +195,18 @@ static void OnServerFrame(float elapsed_time)
     // Process routines and tasks, if any
     ProcessRoutines();
     ProcessTasks();
+    // Stream objects in and out, if any
+    ProcessStreamer();
+    // Advance object paths, if any
+    ProcessPaths(elapsed_time);
+    // Deliver queued client messages, if any
+    ProcessOutbox();
+    // Collect garbage if the growth and the server load allow it
+    ProcessCollector();
+    // Log the memory usage if the interval elapsed
+    ProcessMemory();
+    // Flush the log file if the interval elapsed
+    Logger::Get().Process();
     // See if a reload was requested
     SQMOD_RELOAD_CHECK(g_Reload)
 }
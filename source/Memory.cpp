@@ -0,0 +1,350 @@
+// ------------------------------------------------------------------------------------------------
+#include "Memory.hpp"
+#include "Base/ScriptSrc.hpp"
+#include "Library/Chrono.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Int64   Memory::s_Interval = 0;
+Int64   Memory::s_LastReport = 0;
+Uint32  Memory::s_ReportSize = SQMOD_MEMORY_REPORT_SIZE;
+
+/* ------------------------------------------------------------------------------------------------
+ * Objects counted while walking the heap of the virtual machine.
+*/
+struct HeapTally
+{
+    std::unordered_map< Uint32, Memory::Usage > mKinds; // Usages by object type.
+    Memory::Owners                              mClasses; // Instance usages by class.
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the name of a kind of object.
+*/
+static CSStr GetKindName(SQObjectType type)
+{
+    switch (type)
+    {
+        case OT_TABLE:          return _SC("Table");
+        case OT_ARRAY:          return _SC("Array");
+        case OT_STRING:         return _SC("String");
+        case OT_CLOSURE:        return _SC("Closure");
+        case OT_NATIVECLOSURE:  return _SC("NativeClosure");
+        case OT_FUNCPROTO:      return _SC("Function");
+        case OT_CLASS:          return _SC("Class");
+        case OT_INSTANCE:       return _SC("Instance");
+        case OT_GENERATOR:      return _SC("Generator");
+        case OT_USERDATA:       return _SC("UserData");
+        case OT_OUTER:          return _SC("Outer");
+        case OT_THREAD:         return _SC("Thread");
+        default:                return _SC("Other");
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Count an object found while walking the heap. Must not allocate memory in the virtual machine.
+*/
+static void TallyObject(const SQHeapObjectInfo * info, SQUserPointer up)
+{
+    HeapTally * tally = static_cast< HeapTally * >(up);
+    // Count the object with the others of the same kind
+    Memory::Usage & kind = tally->mKinds[static_cast< Uint32 >(info->type)];
+    kind.mCount += info->count;
+    kind.mSize += info->size;
+    // Count instances with the others of the same class
+    if (info->type == OT_INSTANCE)
+    {
+        Memory::Usage & cls = tally->mClasses[info->owner];
+        cls.mCount += info->count;
+        cls.mSize += info->size;
+        // Classes registered through the binding library have a type tag
+        cls.mNative = (info->typetag != nullptr);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Sort usages from the largest to the smallest.
+*/
+static bool CompareUsage(const Memory::Usage & a, const Memory::Usage & b)
+{
+    return a.mSize > b.mSize;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::CollectScripts(Usages & scripts)
+{
+    SQMemPoolStats stats;
+    // Retrieve the allocator statistics
+    sq_getmempoolstats(&stats);
+    // Attribute the bytes of each tag
+    for (SQInteger tag = 0; tag < SQ_MEMTAG_MAX; ++tag)
+    {
+        if (!stats.tags[tag])
+        {
+            continue; // Nothing allocated under this tag
+        }
+        scripts.emplace_back();
+        Usage & usage = scripts.back();
+        usage.mSize = static_cast< Uint64 >(stats.tags[tag]);
+        // Find the script that owns the tag
+        const String * path = ScriptSrc::GetTagPath(tag);
+        if (path != nullptr)
+        {
+            usage.mName.assign(*path);
+        }
+        else
+        {
+            usage.mName.assign(tag ? _SC("<other scripts>") : _SC("<plug-in>"));
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::CollectObjects(Usages & kinds, Usages & classes)
+{
+    HSQUIRRELVM vm = DefaultVM::Get();
+    HeapTally tally;
+    // Count the objects of the virtual machine
+    if (SQ_FAILED(sq_walkheap(vm, &TallyObject, &tally)))
+    {
+        STHROWF("Unable to walk the heap of the virtual machine");
+    }
+    // Generate the list of kinds
+    for (auto & kind : tally.mKinds)
+    {
+        kind.second.mName.assign(GetKindName(static_cast< SQObjectType >(kind.first)));
+        kinds.push_back(std::move(kind.second));
+    }
+    // Name the classes that can be reached from the root table
+    sq_pushroottable(vm);
+    NameClasses(vm, String(), SQMOD_MEMORY_NAME_DEPTH, tally.mClasses);
+    sq_pop(vm, 1);
+    // Merge the classes without a name
+    std::unordered_map< String, Usage > named;
+    for (auto & cls : tally.mClasses)
+    {
+        if (cls.second.mName.empty())
+        {
+            cls.second.mName.assign(cls.second.mNative ? _SC("<native class>") : _SC("<script class>"));
+        }
+        Usage & usage = named[cls.second.mName];
+        usage.mName = cls.second.mName;
+        usage.mCount += cls.second.mCount;
+        usage.mSize += cls.second.mSize;
+        usage.mNative = cls.second.mNative;
+    }
+    // Generate the list of classes
+    for (auto & cls : named)
+    {
+        classes.push_back(std::move(cls.second));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::NameClasses(HSQUIRRELVM vm, const String & prefix, Uint32 depth, Owners & classes)
+{
+    HSQOBJECT val;
+    CSStr name = nullptr;
+    // Iterate the table on the top of the stack
+    sq_pushnull(vm);
+    while (SQ_SUCCEEDED(sq_next(vm, -2)))
+    {
+        sq_getstackobj(vm, -1, &val);
+        // Only slots with a name are of interest
+        if (sq_gettype(vm, -2) == OT_STRING && SQ_SUCCEEDED(sq_getstring(vm, -2, &name)))
+        {
+            if (sq_type(val) == OT_CLASS)
+            {
+                Owners::iterator itr = classes.find(val._unVal.pClass);
+                // Name the class only if it has instances and wasn't named already
+                if (itr != classes.end() && itr->second.mName.empty())
+                {
+                    itr->second.mName.assign(prefix).append(name);
+                }
+            }
+            else if (sq_type(val) == OT_TABLE && depth > 0)
+            {
+                NameClasses(vm, String(prefix).append(name).append(_SC(".")), depth - 1, classes);
+            }
+        }
+        // Pop the key and value
+        sq_pop(vm, 2);
+    }
+    // Pop the iterator
+    sq_pop(vm, 1);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Memory::PushUsages(HSQUIRRELVM vm, const Usages & usages)
+{
+    // Create the table with the results
+    Table tbl(vm);
+    for (const auto & usage : usages)
+    {
+        Table entry(vm);
+        entry.SetValue(_SC("Count"), static_cast< SQInteger >(usage.mCount));
+        entry.SetValue(_SC("Size"), static_cast< SQInteger >(usage.mSize));
+        entry.SetValue(_SC("Native"), usage.mNative);
+        tbl.SetValue(usage.mName.c_str(), entry);
+    }
+    // Push the table on the stack
+    sq_pushobject(vm, tbl.GetObject());
+    // We have an argument on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::LogUsages(CSStr title, Usages & usages)
+{
+    // Show the largest entries first
+    std::sort(usages.begin(), usages.end(), &CompareUsage);
+    // Log the title of the category
+    LogInf("%s (%u)", title, static_cast< Uint32 >(usages.size()));
+    // Log the entries
+    for (Usages::size_type i = 0; i < usages.size() && i < s_ReportSize; ++i)
+    {
+        LogInf("  %12llu bytes %10llu objects  %s", static_cast< unsigned long long >(usages[i].mSize),
+                static_cast< unsigned long long >(usages[i].mCount), usages[i].mName.c_str());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Memory::GetScripts(HSQUIRRELVM vm)
+{
+    Usages scripts;
+    // Attribute the bytes to the scripts
+    CollectScripts(scripts);
+    // Create the table with the results
+    Table tbl(vm);
+    for (const auto & script : scripts)
+    {
+        tbl.SetValue(script.mName.c_str(), static_cast< SQInteger >(script.mSize));
+    }
+    // Push the table on the stack
+    sq_pushobject(vm, tbl.GetObject());
+    // We have an argument on the stack
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Memory::GetKinds(HSQUIRRELVM vm)
+{
+    Usages kinds, classes;
+    // Walk the heap of the virtual machine
+    CollectObjects(kinds, classes);
+    // Push the table with the results on the stack
+    return PushUsages(vm, kinds);
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Memory::GetClasses(HSQUIRRELVM vm)
+{
+    Usages kinds, classes;
+    // Walk the heap of the virtual machine
+    CollectObjects(kinds, classes);
+    // Push the table with the results on the stack
+    return PushUsages(vm, classes);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::Report()
+{
+    SQMemPoolStats stats;
+    // Retrieve the allocator statistics
+    sq_getmempoolstats(&stats);
+    // Log the totals
+    LogInf("Virtual machine memory: %llu bytes live, %llu bytes peak",
+            static_cast< unsigned long long >(stats.live), static_cast< unsigned long long >(stats.peak));
+    // Are the allocations attributed to scripts?
+    if (GetTagging())
+    {
+        Usages scripts;
+        CollectScripts(scripts);
+        LogUsages("Memory by script", scripts);
+    }
+    Usages kinds, classes;
+    // Walk the heap of the virtual machine
+    CollectObjects(kinds, classes);
+    // Log the results
+    LogUsages("Memory by object kind", kinds);
+    LogUsages("Memory by class", classes);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::SetInterval(SQInteger seconds)
+{
+    if (seconds < 0)
+    {
+        STHROWF("Invalid report interval: %lld", static_cast< Int64 >(seconds));
+    }
+    s_Interval = static_cast< Int64 >(seconds) * 1000000LL;
+    // Start counting from now
+    s_LastReport = Chrono::GetCurrentSysTime();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::SetReportSize(SQInteger size)
+{
+    if (size < 1)
+    {
+        STHROWF("Invalid report size: %lld", static_cast< Int64 >(size));
+    }
+    s_ReportSize = ConvTo< Uint32 >::From(size);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Memory::Process()
+{
+    // Are periodic reports enabled?
+    if (!s_Interval)
+    {
+        return;
+    }
+    const Int64 now = Chrono::GetCurrentSysTime();
+    // Did the interval elapse?
+    if ((now - s_LastReport) < s_Interval)
+    {
+        return;
+    }
+    s_LastReport = now;
+    // Log the report
+    try
+    {
+        Report();
+    }
+    catch (const std::exception & e)
+    {
+        LogErr("Unable to report the memory usage: %s", e.what());
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to log the periodic memory report.
+*/
+void ProcessMemory()
+{
+    Memory::Process();
+}
+
+// ================================================================================================
+void Register_Memory(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqMemory"), Table(vm)
+        .Func(_SC("GetTagging"), &Memory::GetTagging)
+        .SquirrelFunc(_SC("GetScripts"), &Memory::GetScripts)
+        .SquirrelFunc(_SC("GetKinds"), &Memory::GetKinds)
+        .SquirrelFunc(_SC("GetClasses"), &Memory::GetClasses)
+        .Func(_SC("Report"), &Memory::Report)
+        .Func(_SC("GetInterval"), &Memory::GetInterval)
+        .Func(_SC("SetInterval"), &Memory::SetInterval)
+        .Func(_SC("GetReportSize"), &Memory::GetReportSize)
+        .Func(_SC("SetReportSize"), &Memory::SetReportSize)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,143 @@
+#ifndef _MEMORY_HPP_
+#define _MEMORY_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Attribute the memory of the virtual machine to scripts, object kinds and classes.
+*/
+class Memory
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure that holds the number of objects and the bytes attributed to something.
+    */
+    struct Usage
+    {
+        String      mName; // The name of what the memory is attributed to.
+        Uint64      mCount; // The number of objects.
+        Uint64      mSize; // The number of bytes.
+        bool        mNative; // Whether this is a class registered by the plug-in or a module.
+
+        /* ----------------------------------------------------------------------------------------
+         * Default constructor.
+        */
+        Usage()
+            : mName(), mCount(0), mSize(0), mNative(false)
+        {
+            /* ... */
+        }
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef std::vector< Usage >                        Usages; // List of attributed usages.
+    typedef std::unordered_map< const void *, Usage >   Owners; // Usages by object address.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    static Int64    s_Interval; // Microseconds between periodic reports or zero to disable them.
+    static Int64    s_LastReport; // The time when the last periodic report was logged.
+    static Uint32   s_ReportSize; // Maximum number of entries logged per category.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the memory attributed to each script through the allocator tags.
+    */
+    static void CollectScripts(Usages & scripts);
+
+    /* --------------------------------------------------------------------------------------------
+     * Walk the heap of the virtual machine and attribute the objects to kinds and classes.
+    */
+    static void CollectObjects(Usages & kinds, Usages & classes);
+
+    /* --------------------------------------------------------------------------------------------
+     * Find the names under which classes are reachable from the root table.
+    */
+    static void NameClasses(HSQUIRRELVM vm, const String & prefix, Uint32 depth, Owners & classes);
+
+    /* --------------------------------------------------------------------------------------------
+     * Push a table with the specified usages on the stack.
+    */
+    static SQInteger PushUsages(HSQUIRRELVM vm, const Usages & usages);
+
+    /* --------------------------------------------------------------------------------------------
+     * Log the largest entries from the specified usages.
+    */
+    static void LogUsages(CSStr title, Usages & usages);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the allocations are attributed to the scripts that make them.
+    */
+    static bool GetTagging()
+    {
+        return (sq_getmemtagging() != SQFalse);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the bytes attributed to each script.
+    */
+    static SQInteger GetScripts(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of objects and the bytes attributed to each kind of object.
+    */
+    static SQInteger GetKinds(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of instances and the bytes attributed to each class.
+    */
+    static SQInteger GetClasses(HSQUIRRELVM vm);
+
+    /* --------------------------------------------------------------------------------------------
+     * Log the memory attributed to scripts, object kinds and classes.
+    */
+    static void Report();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the seconds between periodic reports.
+    */
+    static SQInteger GetInterval()
+    {
+        return static_cast< SQInteger >(s_Interval / 1000000LL);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the seconds between periodic reports.
+    */
+    static void SetInterval(SQInteger seconds);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of entries logged per category.
+    */
+    static SQInteger GetReportSize()
+    {
+        return static_cast< SQInteger >(s_ReportSize);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of entries logged per category.
+    */
+    static void SetReportSize(SQInteger size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Log a report if the interval elapsed.
+    */
+    static void Process();
+};
+
+} // Namespace:: SqMod
+
+#endif // _MEMORY_HPP_
@@ -0,0 +1,439 @@
+// ------------------------------------------------------------------------------------------------
+#include "Core.hpp"
+#include "Base/Shared.hpp"
+#include "Entity/Object.hpp"
+#include "Entity/Pickup.hpp"
+#include "Entity/Vehicle.hpp"
+#include "Library/Utils/Buffer.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Identifier and version of the binary map format.
+*/
+#define SQMOD_MAP_MAGIC     0x504D5153 // "SQMP"
+#define SQMOD_MAP_VERSION   1
+
+/* ------------------------------------------------------------------------------------------------
+ * Packed entity records used by the binary map format. All values are stored in little endian.
+*/
+#pragma pack(push, 1)
+
+// ------------------------------------------------------------------------------------------------
+struct MapHeader
+{
+    Uint32  mMagic, mVersion, mObjects, mPickups, mVehicles;
+};
+
+// ------------------------------------------------------------------------------------------------
+struct MapObject
+{
+    Int32   mModel, mWorld;
+    Float32 mX, mY, mZ;
+    Float32 mRX, mRY, mRZ, mRW;
+    Int32   mAlpha;
+};
+
+// ------------------------------------------------------------------------------------------------
+struct MapPickup
+{
+    Int32   mModel, mWorld, mQuantity;
+    Float32 mX, mY, mZ;
+    Int32   mAlpha, mAutomatic;
+};
+
+// ------------------------------------------------------------------------------------------------
+struct MapVehicle
+{
+    Int32   mModel, mWorld;
+    Float32 mX, mY, mZ, mAngle;
+    Int32   mPrimary, mSecondary;
+};
+
+#pragma pack(pop)
+
+/* ------------------------------------------------------------------------------------------------
+ * Retrieve the instance managed by an entity script object.
+*/
+template < typename T > static T * GetEntityInst(LightObj & obj)
+{
+    // Restore the stack on exit
+    const StackGuard sg;
+    // Push the script object on the stack
+    sq_pushobject(DefaultVM::Get(), obj.mObj);
+    // Extract the instance
+    return Var< T * >(DefaultVM::Get(), -1).value;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Read the numeric fields of a definition from an array located at the specified stack index.
+*/
+static void ReadDefinition(HSQUIRRELVM vm, SQInteger idx, SQInteger row,
+                            SQFloat * out, SQInteger min, SQInteger max)
+{
+    // Is the definition an array?
+    if (sq_gettype(vm, idx) != OT_ARRAY)
+    {
+        STHROWF("Definition (%lld) is not an array", static_cast< Int64 >(row));
+    }
+    // Obtain the number of fields
+    const SQInteger size = sq_getsize(vm, idx);
+    // Do we have the right amount of fields?
+    if (size < min || size > max)
+    {
+        STHROWF("Definition (%lld) has %lld fields, expected between %lld and %lld",
+                static_cast< Int64 >(row), static_cast< Int64 >(size),
+                static_cast< Int64 >(min), static_cast< Int64 >(max));
+    }
+    // Read the fields
+    for (SQInteger i = 0; i < size; ++i)
+    {
+        sq_pushinteger(vm, i);
+        // Retrieve the field from the array
+        if (SQ_FAILED(sq_rawget(vm, idx < 0 ? idx - 1 : idx)) || SQ_FAILED(sq_getfloat(vm, -1, &out[i])))
+        {
+            STHROWF("Field (%lld) of definition (%lld) is not a number",
+                    static_cast< Int64 >(i), static_cast< Int64 >(row));
+        }
+        sq_pop(vm, 1);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Invoke a functor for every definition in an array of definitions.
+*/
+template < typename F > static void EachDefinition(Array & defs, SQInteger min, SQInteger max, F f)
+{
+    // Make sure the definitions are in an array
+    if (defs.IsNull() || defs.GetType() != OT_ARRAY)
+    {
+        STHROWF("Expected an array of definitions");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Restore the stack on exit
+    const StackGuard sg(vm);
+    // Push the array on the stack
+    sq_pushobject(vm, defs.GetObject());
+    // Fields of the current definition
+    SQFloat fields[16];
+    // Process every definition
+    for (SQInteger row = 0, count = sq_getsize(vm, -1); row < count; ++row)
+    {
+        sq_pushinteger(vm, row);
+        // Retrieve the definition from the array
+        if (SQ_FAILED(sq_rawget(vm, -2)))
+        {
+            STHROWF("Unable to retrieve definition (%lld)", static_cast< Int64 >(row));
+        }
+        // Assume optional fields were not specified
+        std::fill(fields, fields + max, SQFloat(0));
+        // Read the definition fields
+        ReadDefinition(vm, -1, row, fields, min, max);
+        // Pop the definition from the stack
+        sq_pop(vm, 1);
+        // Forward the definition
+        f(fields, row);
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a tagged object and apply its rotation.
+*/
+static LightObj & MakeObject(Int32 model, Int32 world, Float32 x, Float32 y, Float32 z, Int32 alpha,
+                            const Quaternion & rot, const StackStrF & tag)
+{
+    LightObj & obj = Core::Get().NewObject(model, world, x, y, z, alpha, SQMOD_CREATE_DEFAULT, NullLightObj());
+    // Obtain the managed instance
+    CObject * inst = GetEntityInst< CObject >(obj);
+    // Was it destroyed during the creation events?
+    if (inst && inst->IsActive())
+    {
+        inst->SetTag(tag);
+        // Apply the rotation, if any
+        if (rot != Quaternion::IDENTITY)
+        {
+            _Func->RotateObjectTo(inst->GetID(), rot.x, rot.y, rot.z, rot.w, 0);
+        }
+    }
+    return obj;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a tagged pickup.
+*/
+static LightObj & MakePickup(Int32 model, Int32 world, Int32 quantity, Float32 x, Float32 y, Float32 z,
+                            Int32 alpha, bool automatic, const StackStrF & tag)
+{
+    LightObj & obj = Core::Get().NewPickup(model, world, quantity, x, y, z, alpha, automatic,
+                                            SQMOD_CREATE_DEFAULT, NullLightObj());
+    // Obtain the managed instance
+    CPickup * inst = GetEntityInst< CPickup >(obj);
+    // Was it destroyed during the creation events?
+    if (inst && inst->IsActive())
+    {
+        inst->SetTag(tag);
+    }
+    return obj;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create a tagged vehicle.
+*/
+static LightObj & MakeVehicle(Int32 model, Int32 world, Float32 x, Float32 y, Float32 z, Float32 angle,
+                            Int32 primary, Int32 secondary, const StackStrF & tag)
+{
+    LightObj & obj = Core::Get().NewVehicle(model, world, x, y, z, angle, primary, secondary,
+                                            SQMOD_CREATE_DEFAULT, NullLightObj());
+    // Obtain the managed instance
+    CVehicle * inst = GetEntityInst< CVehicle >(obj);
+    // Was it destroyed during the creation events?
+    if (inst && inst->IsActive())
+    {
+        inst->SetTag(tag);
+    }
+    return obj;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create objects from an array of [model, world, x, y, z, alpha, (rx, ry, rz, rw)] definitions.
+*/
+static Array SqBatchObjects(Array & defs, const StackStrF & tag)
+{
+    Array arr(DefaultVM::Get(), 0);
+    // Create the objects in one go
+    EachDefinition(defs, 6, 10, [&arr, &tag](const SQFloat * f, SQInteger) {
+        const Quaternion rot = (f[9] != SQFloat(0) || f[6] != SQFloat(0) || f[7] != SQFloat(0) ||
+                                f[8] != SQFloat(0)) ? Quaternion(f[6], f[7], f[8], f[9]) : Quaternion::IDENTITY;
+        arr.Append(MakeObject(static_cast< Int32 >(f[0]), static_cast< Int32 >(f[1]),
+                                static_cast< Float32 >(f[2]), static_cast< Float32 >(f[3]),
+                                static_cast< Float32 >(f[4]), static_cast< Int32 >(f[5]), rot, tag));
+    });
+    // Return the created objects
+    return arr;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create pickups from an array of [model, world, quantity, x, y, z, alpha, automatic] definitions.
+*/
+static Array SqBatchPickups(Array & defs, const StackStrF & tag)
+{
+    Array arr(DefaultVM::Get(), 0);
+    // Create the pickups in one go
+    EachDefinition(defs, 8, 8, [&arr, &tag](const SQFloat * f, SQInteger) {
+        arr.Append(MakePickup(static_cast< Int32 >(f[0]), static_cast< Int32 >(f[1]),
+                                static_cast< Int32 >(f[2]), static_cast< Float32 >(f[3]),
+                                static_cast< Float32 >(f[4]), static_cast< Float32 >(f[5]),
+                                static_cast< Int32 >(f[6]), f[7] != SQFloat(0), tag));
+    });
+    // Return the created pickups
+    return arr;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create vehicles from an array of [model, world, x, y, z, angle, primary, secondary] definitions.
+*/
+static Array SqBatchVehicles(Array & defs, const StackStrF & tag)
+{
+    Array arr(DefaultVM::Get(), 0);
+    // Create the vehicles in one go
+    EachDefinition(defs, 8, 8, [&arr, &tag](const SQFloat * f, SQInteger) {
+        arr.Append(MakeVehicle(static_cast< Int32 >(f[0]), static_cast< Int32 >(f[1]),
+                                static_cast< Float32 >(f[2]), static_cast< Float32 >(f[3]),
+                                static_cast< Float32 >(f[4]), static_cast< Float32 >(f[5]),
+                                static_cast< Int32 >(f[6]), static_cast< Int32 >(f[7]), tag));
+    });
+    // Return the created vehicles
+    return arr;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create the entities from a binary map and return the number of consumed bytes.
+*/
+static Buffer::SzType LoadMap(const Buffer::Value * data, Buffer::SzType size, Table & tbl, const StackStrF & tag)
+{
+    // Can we read the header?
+    if (size < sizeof(MapHeader))
+    {
+        STHROWF("Map data is too small to contain a header");
+    }
+    MapHeader hdr;
+    std::memcpy(&hdr, data, sizeof(MapHeader));
+    // Is this a map we understand?
+    if (hdr.mMagic != SQMOD_MAP_MAGIC)
+    {
+        STHROWF("Map data has an invalid signature");
+    }
+    else if (hdr.mVersion != SQMOD_MAP_VERSION)
+    {
+        STHROWF("Unsupported map version: %u", hdr.mVersion);
+    }
+    // Compute the size of the map data
+    const Uint64 need = sizeof(MapHeader) +
+                        static_cast< Uint64 >(hdr.mObjects) * sizeof(MapObject) +
+                        static_cast< Uint64 >(hdr.mPickups) * sizeof(MapPickup) +
+                        static_cast< Uint64 >(hdr.mVehicles) * sizeof(MapVehicle);
+    // Is the map complete?
+    if (need > size)
+    {
+        STHROWF("Map data is truncated: %llu bytes required, %u available", need, size);
+    }
+    // Where the entity records start
+    const Buffer::Value * ptr = data + sizeof(MapHeader);
+    // Arrays for the created entities
+    Array objects(DefaultVM::Get(), 0), pickups(DefaultVM::Get(), 0), vehicles(DefaultVM::Get(), 0);
+    // Create the objects
+    for (Uint32 n = 0; n < hdr.mObjects; ++n, ptr += sizeof(MapObject))
+    {
+        MapObject o;
+        std::memcpy(&o, ptr, sizeof(MapObject));
+        objects.Append(MakeObject(o.mModel, o.mWorld, o.mX, o.mY, o.mZ, o.mAlpha,
+                                    Quaternion(o.mRX, o.mRY, o.mRZ, o.mRW), tag));
+    }
+    // Create the pickups
+    for (Uint32 n = 0; n < hdr.mPickups; ++n, ptr += sizeof(MapPickup))
+    {
+        MapPickup p;
+        std::memcpy(&p, ptr, sizeof(MapPickup));
+        pickups.Append(MakePickup(p.mModel, p.mWorld, p.mQuantity, p.mX, p.mY, p.mZ,
+                                    p.mAlpha, p.mAutomatic != 0, tag));
+    }
+    // Create the vehicles
+    for (Uint32 n = 0; n < hdr.mVehicles; ++n, ptr += sizeof(MapVehicle))
+    {
+        MapVehicle v;
+        std::memcpy(&v, ptr, sizeof(MapVehicle));
+        vehicles.Append(MakeVehicle(v.mModel, v.mWorld, v.mX, v.mY, v.mZ, v.mAngle,
+                                    v.mPrimary, v.mSecondary, tag));
+    }
+    // Store the created entities in the result table
+    tbl.SetValue(_SC("Objects"), objects);
+    tbl.SetValue(_SC("Pickups"), pickups);
+    tbl.SetValue(_SC("Vehicles"), vehicles);
+    // Return the consumed size
+    return static_cast< Buffer::SzType >(need);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create the entities from a binary map stored in a buffer, starting at the buffer cursor.
+*/
+static Table SqBatchLoadMap(SqBuffer & buffer, const StackStrF & tag)
+{
+    // Validate the buffer
+    buffer.ValidateDeeper();
+    // Obtain the buffer
+    Buffer & b = *buffer.GetRef();
+    // Table with the created entities
+    Table tbl(DefaultVM::Get());
+    // Load the map and move the cursor past it
+    b.Advance(LoadMap(b.Data() + b.Position(), b.Capacity() - b.Position(), tbl, tag));
+    // Return the created entities
+    return tbl;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Create the entities from a binary map file.
+*/
+static Table SqBatchLoadMapFile(const StackStrF & path, const StackStrF & tag)
+{
+    // Attempt to open the file
+    std::FILE * fp = std::fopen(path.mPtr, "rb");
+    // Could we open it?
+    if (!fp)
+    {
+        STHROWF("Unable to open map file: %s", path.mPtr);
+    }
+    // Read the whole file
+    std::vector< Buffer::Value > data;
+    std::fseek(fp, 0, SEEK_END);
+    const long size = std::ftell(fp);
+    std::fseek(fp, 0, SEEK_SET);
+    // Allocate the memory and read the contents
+    if (size > 0)
+    {
+        data.resize(static_cast< size_t >(size));
+        // Was everything read?
+        if (std::fread(&data[0], 1, data.size(), fp) != data.size())
+        {
+            std::fclose(fp);
+            STHROWF("Unable to read map file: %s", path.mPtr);
+        }
+    }
+    std::fclose(fp);
+    // Table with the created entities
+    Table tbl(DefaultVM::Get());
+    // Load the map
+    LoadMap(data.empty() ? nullptr : &data[0], static_cast< Buffer::SzType >(data.size()), tbl, tag);
+    // Return the created entities
+    return tbl;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Destroy all objects, pickups and vehicles with the specified tag.
+*/
+static SQInteger SqBatchDestroy(const StackStrF & tag)
+{
+    const String str(tag.mPtr, ClampMin(tag.mLen, 0));
+    // Identifiers of the entities to destroy
+    std::vector< Int32 > objects, pickups, vehicles;
+    // Find the tagged objects
+    for (const auto & inst : Core::Get().GetObjects())
+    {
+        if (VALID_ENTITY(inst.mID) && inst.mInst && inst.mInst->GetTag() == str)
+        {
+            objects.push_back(inst.mID);
+        }
+    }
+    // Find the tagged pickups
+    for (const auto & inst : Core::Get().GetPickups())
+    {
+        if (VALID_ENTITY(inst.mID) && inst.mInst && inst.mInst->GetTag() == str)
+        {
+            pickups.push_back(inst.mID);
+        }
+    }
+    // Find the tagged vehicles
+    for (const auto & inst : Core::Get().GetVehicles())
+    {
+        if (VALID_ENTITY(inst.mID) && inst.mInst && inst.mInst->GetTag() == str)
+        {
+            vehicles.push_back(inst.mID);
+        }
+    }
+    // Destroy them all
+    for (auto id : objects)
+    {
+        Core::Get().DelObject(id, SQMOD_DESTROY_DEFAULT, NullLightObj());
+    }
+    for (auto id : pickups)
+    {
+        Core::Get().DelPickup(id, SQMOD_DESTROY_DEFAULT, NullLightObj());
+    }
+    for (auto id : vehicles)
+    {
+        Core::Get().DelVehicle(id, SQMOD_DESTROY_DEFAULT, NullLightObj());
+    }
+    // Return the number of destroyed entities
+    return static_cast< SQInteger >(objects.size() + pickups.size() + vehicles.size());
+}
+
+// ================================================================================================
+void Register_Batch(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqBatch"), Table(vm)
+        .FmtFunc(_SC("Objects"), &SqBatchObjects)
+        .FmtFunc(_SC("Pickups"), &SqBatchPickups)
+        .FmtFunc(_SC("Vehicles"), &SqBatchVehicles)
+        .FmtFunc(_SC("LoadMap"), &SqBatchLoadMap)
+        .Func(_SC("LoadMapFile"), &SqBatchLoadMapFile)
+        .FmtFunc(_SC("Destroy"), &SqBatchDestroy)
+    );
+}
+
+} // Namespace:: SqMod
@@ -3,11 +3,239 @@
 #include "Base/Shared.hpp"
 #include "Base/Color3.hpp"
 #include "Base/Color4.hpp"
+#include "Base/Vector3.hpp"
 #include "Entity/Player.hpp"
+#include "Library/Utils/Buffer.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <bitset>
 
 // ------------------------------------------------------------------------------------------------
 namespace SqMod {
 
+// ------------------------------------------------------------------------------------------------
+SQMODE_DECL_TYPENAME(Typename, _SC("SqBroadcastFilter"))
+
+/* ------------------------------------------------------------------------------------------------
+ * Criteria that a player must meet in order to receive a filtered broadcast.
+*/
+class BroadcastFilter
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * The criteria that were specified.
+    */
+    enum Criteria
+    {
+        BFC_WORLD       = (1 << 0),
+        BFC_TEAM        = (1 << 1),
+        BFC_AUTHORITY   = (1 << 2),
+        BFC_RADIUS      = (1 << 3),
+        BFC_PREFIX      = (1 << 4),
+        BFC_PLAYERS     = (1 << 5)
+    };
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    Uint32      m_Criteria; // The criteria that were specified.
+    Int32       m_World; // The world where the player must be.
+    Int32       m_Team; // The team of the player.
+    Int32       m_Authority; // The minimum authority level of the player.
+    Vector3     m_Center; // The center of the area where the player must be.
+    Float32     m_Radius; // The squared radius of the area where the player must be.
+    String      m_Prefix; // The prefix of the player tag.
+
+    // --------------------------------------------------------------------------------------------
+    std::bitset< SQMOD_PLAYER_POOL > m_Players; // The explicit list of players.
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Default constructor.
+    */
+    BroadcastFilter()
+        : m_Criteria(0), m_World(0), m_Team(0), m_Authority(0)
+        , m_Center(), m_Radius(0), m_Prefix(), m_Players()
+    {
+        /* ... */
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow players in the specified world.
+    */
+    BroadcastFilter & World(Int32 world)
+    {
+        m_World = world;
+        m_Criteria |= BFC_WORLD;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow players in the specified team.
+    */
+    BroadcastFilter & Team(Int32 team)
+    {
+        m_Team = team;
+        m_Criteria |= BFC_TEAM;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow players with at least the specified authority level.
+    */
+    BroadcastFilter & Authority(Int32 level)
+    {
+        m_Authority = level;
+        m_Criteria |= BFC_AUTHORITY;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow players within the specified distance of a point.
+    */
+    BroadcastFilter & Radius(const Vector3 & center, Float32 radius)
+    {
+        m_Center = center;
+        m_Radius = radius * radius;
+        m_Criteria |= BFC_RADIUS;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow players whose tag starts with the specified string.
+    */
+    BroadcastFilter & Prefix(const StackStrF & prefix)
+    {
+        m_Prefix.assign(prefix.mPtr, ClampMin(prefix.mLen, 0));
+        m_Criteria |= BFC_PREFIX;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Only allow the players from the specified list of identifiers or instances.
+    */
+    BroadcastFilter & Players(Array & list)
+    {
+        HSQUIRRELVM vm = list.GetVM();
+        // Restore the stack on exit
+        const StackGuard sg(vm);
+        // Push the list on the stack so that we can iterate it
+        sq_pushobject(vm, list.GetObject());
+        sq_pushnull(vm);
+        // Process each element in the list
+        while (SQ_SUCCEEDED(sq_next(vm, -2)))
+        {
+            Int32 id = -1;
+            // Is this a player identifier?
+            if (sq_gettype(vm, -1) == OT_INTEGER)
+            {
+                id = ConvTo< Int32 >::From(PopStackInteger(vm, -1));
+            }
+            // Is this a player instance?
+            else if (sq_gettype(vm, -1) == OT_INSTANCE)
+            {
+                CPlayer * player = Var< CPlayer * >(vm, -1).value;
+                id = player ? player->GetID() : -1;
+            }
+            // Is this a valid player identifier?
+            if (!VALID_ENTITYEX(id, SQMOD_PLAYER_POOL))
+            {
+                STHROWF("Invalid player in broadcast list");
+            }
+            m_Players.set(static_cast< size_t >(id));
+            // Pop the key and value
+            sq_pop(vm, 2);
+        }
+        m_Criteria |= BFC_PLAYERS;
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove all criteria.
+    */
+    BroadcastFilter & Clear()
+    {
+        m_Criteria = 0;
+        m_Prefix.clear();
+        m_Players.reset();
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified player meets all the criteria.
+    */
+    bool Match(const Core::Players::value_type & inst) const
+    {
+        // Check the cheapest criteria first
+        if ((m_Criteria & BFC_PLAYERS) && !m_Players.test(static_cast< size_t >(inst.mID)))
+        {
+            return false;
+        }
+        else if ((m_Criteria & BFC_AUTHORITY) && inst.mAuthority < m_Authority)
+        {
+            return false;
+        }
+        else if ((m_Criteria & BFC_WORLD) && _Func->GetPlayerWorld(inst.mID) != m_World)
+        {
+            return false;
+        }
+        else if ((m_Criteria & BFC_TEAM) && _Func->GetPlayerTeam(inst.mID) != m_Team)
+        {
+            return false;
+        }
+        else if ((m_Criteria & BFC_PREFIX) &&
+                    inst.mInst->GetTag().compare(0, m_Prefix.size(), m_Prefix) != 0)
+        {
+            return false;
+        }
+        // Is the player close enough?
+        else if (m_Criteria & BFC_RADIUS)
+        {
+            Vector3 pos;
+            _Func->GetPlayerPosition(inst.mID, &pos.x, &pos.y, &pos.z);
+            // Compare the squared distances
+            return ((pos - m_Center).GetLengthSquared() <= m_Radius);
+        }
+        // All criteria were met
+        return true;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified player meets all the criteria.
+    */
+    bool Test(CPlayer & player) const
+    {
+        player.Validate();
+        // Forward the call to the native implementation
+        return Match(Core::Get().GetPlayer(player.GetID()));
+    }
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Extract the broadcast filter from the specified stack index.
+*/
+static SQRESULT SqGrabBroadcastFilter(HSQUIRRELVM vm, Int32 idx, const BroadcastFilter * & filter)
+{
+    // Attempt to extract the filter instance
+    try
+    {
+        filter = Var< const BroadcastFilter * >(vm, idx).value;
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Was there a filter instance?
+    if (!filter)
+    {
+        return sq_throwerror(vm, "Invalid broadcast filter");
+    }
+    // At this point we've extracted the filter
+    return SQ_OK;
+}
+
 // ------------------------------------------------------------------------------------------------
 static inline bool SqCanBeInteger(HSQUIRRELVM vm, Int32 idx)
 {
@@ -691,6 +919,433 @@ static SQInteger SqBroadcastAnnounceEx(HSQUIRRELVM vm)
     return 1;
 }
 
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastMsgTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+    // Was the message color specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing message color");
+    }
+    // Was the message value specified?
+    else if (top <= 3)
+    {
+        return sq_throwerror(vm, "Missing message value");
+    }
+
+    // The broadcast filter
+    const BroadcastFilter * filter = nullptr;
+    // Attempt to extract the filter
+    SQRESULT res = SqGrabBroadcastFilter(vm, 2, filter);
+    // Did we fail to extract the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // The index where the message should start
+    Int32 msgidx = 3;
+    // The message color
+    Uint32 color = 0;
+    // Attempt to identify and extract the color
+    res = SqGrabPlayerMessageColor(vm, 3, color, msgidx);
+    // Did we fail to identify a color?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, msgidx);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.mRes))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Obtain the ends of the entity pool
+    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
+    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // The number of players that the message was sent to
+    Uint32 count = 0;
+    // Currently processed player
+    CPlayer * player = nullptr;
+
+    // Process each entity in the pool
+    for (; itr != end; ++itr)
+    {
+        // Grab the player instance
+        player = itr->mInst;
+        // Is this player instance valid and allowed by the filter?
+        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr && filter->Match(*itr))
+        {
+            // Send the resulted message string
+            const vcmpError result = _Func->SendClientMessage(itr->mID, color,
+                                                        "%s%s%s",
+                                                        player->mMessagePrefix.c_str(),
+                                                        val.mPtr,
+                                                        player->mMessagePostfix.c_str());
+            // Check the result
+            if (result == vcmpErrorTooLargeInput)
+            {
+                return sq_throwerror(vm, ToStrF("Client message too big [%s]", player->GetTag().c_str()));
+            }
+            // Add this player to the count
+            ++count;
+        }
+    }
+
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastMessageTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+    // Was the message value specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing message value");
+    }
+
+    // The broadcast filter
+    const BroadcastFilter * filter = nullptr;
+    // Attempt to extract the filter
+    const SQRESULT res = SqGrabBroadcastFilter(vm, 2, filter);
+    // Did we fail to extract the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, 3);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.mRes))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Obtain the ends of the entity pool
+    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
+    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // The number of players that the message was sent to
+    Uint32 count = 0;
+    // Currently processed player
+    CPlayer * player = nullptr;
+
+    // Process each entity in the pool
+    for (; itr != end; ++itr)
+    {
+        // Grab the player instance
+        player = itr->mInst;
+        // Is this player instance valid and allowed by the filter?
+        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr && filter->Match(*itr))
+        {
+            // Send the resulted message string
+            const vcmpError result = _Func->SendClientMessage(itr->mID, player->mMessageColor,
+                                                                "%s%s%s",
+                                                                player->mMessagePrefix.c_str(),
+                                                                val.mPtr,
+                                                                player->mMessagePostfix.c_str());
+            // Check the result
+            if (result == vcmpErrorTooLargeInput)
+            {
+                return sq_throwerror(vm, ToStrF("Client message too big [%s]", player->GetTag().c_str()));
+            }
+            // Add this player to the count
+            ++count;
+        }
+    }
+
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastAnnounceTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+    // Was the announcement value specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing announcement value");
+    }
+
+    // The broadcast filter
+    const BroadcastFilter * filter = nullptr;
+    // Attempt to extract the filter
+    const SQRESULT res = SqGrabBroadcastFilter(vm, 2, filter);
+    // Did we fail to extract the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, 3);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.mRes))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Obtain the ends of the entity pool
+    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
+    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // The number of players that the message was sent to
+    Uint32 count = 0;
+    // Currently processed player
+    CPlayer * player = nullptr;
+
+    // Process each entity in the pool
+    for (; itr != end; ++itr)
+    {
+        // Grab the player instance
+        player = itr->mInst;
+        // Is this player instance valid and allowed by the filter?
+        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr && filter->Match(*itr))
+        {
+            // Send the resulted announcement string
+            const vcmpError result = _Func->SendGameMessage(itr->mID, player->mAnnounceStyle,
+                                                            "%s%s%s",
+                                                            player->mAnnouncePrefix.c_str(),
+                                                            val.mPtr,
+                                                            player->mAnnouncePostfix.c_str());
+            // Validate the result
+            if (result == vcmpErrorArgumentOutOfBounds)
+            {
+                return sq_throwerror(vm, ToStrF("Invalid announcement style %d [%s]",
+                                                player->mAnnounceStyle, player->GetTag().c_str()));
+            }
+            else if (result == vcmpErrorTooLargeInput)
+            {
+                return sq_throwerror(vm, ToStrF("Game message too big [%s]", player->GetTag().c_str()));
+            }
+            // Add this player to the count
+            ++count;
+        }
+    }
+
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastAnnounceExTo(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the broadcast filter specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing broadcast filter");
+    }
+    // Was the announcement style specified?
+    else if (top <= 2)
+    {
+        return sq_throwerror(vm, "Missing announcement style");
+    }
+    // Was the announcement value specified?
+    else if (top <= 3)
+    {
+        return sq_throwerror(vm, "Missing announcement value");
+    }
+
+    // The broadcast filter
+    const BroadcastFilter * filter = nullptr;
+    // Attempt to extract the filter
+    const SQRESULT res = SqGrabBroadcastFilter(vm, 2, filter);
+    // Did we fail to extract the filter?
+    if (SQ_FAILED(res))
+    {
+        return res; // Propagate the error!
+    }
+
+    Int32 style;
+    // style to extract the argument values
+    try
+    {
+        style = Var< Int32 >(vm, 3).value;
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+
+    // Attempt to generate the string value
+    StackStrF val(vm, 4);
+    // Have we failed to retrieve the string?
+    if (SQ_FAILED(val.mRes))
+    {
+        return val.mRes; // Propagate the error!
+    }
+
+    // Obtain the ends of the entity pool
+    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
+    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // The number of players that the message was sent to
+    Uint32 count = 0;
+    // Currently processed player
+    CPlayer * player = nullptr;
+
+    // Process each entity in the pool
+    for (; itr != end; ++itr)
+    {
+        // Grab the player instance
+        player = itr->mInst;
+        // Is this player instance valid and allowed by the filter?
+        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && player != nullptr && filter->Match(*itr))
+        {
+            // Send the resulted announcement string
+            const vcmpError result = _Func->SendGameMessage(itr->mID, style,
+                                                            "%s%s%s",
+                                                            player->mAnnouncePrefix.c_str(),
+                                                            val.mPtr,
+                                                            player->mAnnouncePostfix.c_str());
+            // Validate the result
+            if (result == vcmpErrorArgumentOutOfBounds)
+            {
+                return sq_throwerror(vm, ToStrF("Invalid announcement style %d [%s]",
+                                                style, player->GetTag().c_str()));
+            }
+            else if (result == vcmpErrorTooLargeInput)
+            {
+                return sq_throwerror(vm, ToStrF("Game message too big [%s]", player->GetTag().c_str()));
+            }
+            // Add this player to the count
+            ++count;
+        }
+    }
+
+    // Push the count count on the stack
+    sq_pushinteger(vm, count);
+    // Specify that this function returned a value
+    return 1;
+}
+
+// ------------------------------------------------------------------------------------------------
+static SQInteger SqBroadcastData(HSQUIRRELVM vm)
+{
+    const Int32 top = sq_gettop(vm);
+    // Was the buffer specified?
+    if (top <= 1)
+    {
+        return sq_throwerror(vm, "Missing data buffer");
+    }
+
+    // The data to send
+    const Buffer * data = nullptr;
+    // Attempt to extract the buffer
+    try
+    {
+        const SqBuffer & buffer = Var< const SqBuffer & >(vm, 2).value;
+        // Validate the specified buffer
+        buffer.ValidateDeeper();
+        // Grab the managed buffer
+        data = buffer.GetRef().Get();
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        return sq_throwerror(vm, e.what());
+    }
+    // Validate the buffer cursor
+    if (!data->Position())
+    {
+        return sq_throwerror(vm, "Cannot send empty stream buffer");
+    }
+
+    // The broadcast filter, if any
+    const BroadcastFilter * filter = nullptr;
+    // Filter created from a list of players, if specified
+    BroadcastFilter list;
+    // Was a list of players specified?
+    if (top > 2 && sq_gettype(vm, 3) == OT_ARRAY)
+    {
+        try
+        {
+            Array arr(Var< Array >(vm, 3).value);
+            list.Players(arr);
+        }
+        catch (const Sqrat::Exception & e)
+        {
+            return sq_throwerror(vm, e.what());
+        }
+        filter = &list;
+    }
+    // Was a filter specified?
+    else if (top > 2 && sq_gettype(vm, 3) != OT_NULL)
+    {
+        const SQRESULT res = SqGrabBroadcastFilter(vm, 3, filter);
+        // Did we fail to extract the filter?
+        if (SQ_FAILED(res))
+        {
+            return res; // Propagate the error!
+        }
+    }
+
+    // Obtain the ends of the entity pool
+    Core::Players::const_iterator itr = Core::Get().GetPlayers().cbegin();
+    Core::Players::const_iterator end = Core::Get().GetPlayers().cend();
+    // The number of players that the data was sent to
+    Uint32 count = 0;
+    // The players that the data could not be sent to
+    Array failed(vm);
+
+    // Process each entity in the pool
+    for (; itr != end; ++itr)
+    {
+        // Is this player instance valid and allowed by the filter?
+        if (VALID_ENTITYEX(itr->mID, SQMOD_PLAYER_POOL) && itr->mInst != nullptr &&
+            (filter == nullptr || filter->Match(*itr)))
+        {
+            // Send the buffer contents
+            const vcmpError result = _Func->SendClientScriptData(itr->mID, data->Data(), data->Position());
+            // Check the result
+            if (result != vcmpErrorNone)
+            {
+                failed.Append(itr->mID);
+            }
+            // Add this player to the count
+            else
+            {
+                ++count;
+            }
+        }
+    }
+
+    // Create the table with the results
+    Table res(vm);
+    res.SetValue(_SC("Sent"), count);
+    res.SetValue(_SC("Failed"), failed);
+    // Push the results on the stack
+    sq_pushobject(vm, res.GetObject());
+    // Specify that this function returned a value
+    return 1;
+}
+
 // ================================================================================================
 void Register_Broadcast(HSQUIRRELVM vm)
 {
@@ -704,9 +1359,33 @@ void Register_Broadcast(HSQUIRRELVM vm)
     .SquirrelFunc(_SC("Announce"), &SqBroadcastAnnounce)
     .SquirrelFunc(_SC("AnnounceEx"), &SqBroadcastAnnounceEx)
     .SquirrelFunc(_SC("Text"), &SqBroadcastAnnounce)
-    .SquirrelFunc(_SC("TextEx"), &SqBroadcastAnnounceEx);
+    .SquirrelFunc(_SC("TextEx"), &SqBroadcastAnnounceEx)
+    .SquirrelFunc(_SC("MsgTo"), &SqBroadcastMsgTo)
+    .SquirrelFunc(_SC("MessageTo"), &SqBroadcastMessageTo)
+    .SquirrelFunc(_SC("AnnounceTo"), &SqBroadcastAnnounceTo)
+    .SquirrelFunc(_SC("AnnounceExTo"), &SqBroadcastAnnounceExTo)
+    .SquirrelFunc(_SC("TextTo"), &SqBroadcastAnnounceTo)
+    .SquirrelFunc(_SC("TextExTo"), &SqBroadcastAnnounceExTo)
+    .SquirrelFunc(_SC("Data"), &SqBroadcastData);
 
     RootTable(vm).Bind(_SC("SqBroadcast"), bns);
+
+    RootTable(vm).Bind(Typename::Str,
+        Class< BroadcastFilter >(vm, Typename::Str)
+        // Constructors
+        .Ctor()
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        // Member Methods
+        .Func(_SC("World"), &BroadcastFilter::World)
+        .Func(_SC("Team"), &BroadcastFilter::Team)
+        .Func(_SC("Authority"), &BroadcastFilter::Authority)
+        .Func(_SC("Radius"), &BroadcastFilter::Radius)
+        .FmtFunc(_SC("Prefix"), &BroadcastFilter::Prefix)
+        .Func(_SC("Players"), &BroadcastFilter::Players)
+        .Func(_SC("Clear"), &BroadcastFilter::Clear)
+        .Func(_SC("Test"), &BroadcastFilter::Test)
+    );
 }
 
 } // Namespace:: SqMod
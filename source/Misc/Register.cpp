@@ -49,6 +49,7 @@ static const LightObj & FindPlayer(Object & by)
 }
 
 // ------------------------------------------------------------------------------------------------
+extern void Register_Batch(HSQUIRRELVM vm);
 extern void Register_Broadcast(HSQUIRRELVM vm);
 
 // ================================================================================================
@@ -176,6 +177,7 @@ void Register_Misc(HSQUIRRELVM vm)
     .Func(_SC("CreateExplosion"), &CreateExplosion)
     .Func(_SC("CreateExplosionEx"), &CreateExplosionEx);
 
+    Register_Batch(vm);
     Register_Broadcast(vm);
 }
 
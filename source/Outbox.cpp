@@ -0,0 +1,312 @@
+// ------------------------------------------------------------------------------------------------
+#include "Outbox.hpp"
+#include "Core.hpp"
+#include "Entity/Player.hpp"
+#include "Library/Utils/Buffer.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Outbox::Queues  Outbox::s_Queues;
+Uint32          Outbox::s_Count = 0;
+Uint32          Outbox::s_Rate = SQMOD_OUTBOX_RATE;
+Uint32          Outbox::s_Budget = SQMOD_OUTBOX_BUDGET;
+Uint32          Outbox::s_Limit = SQMOD_OUTBOX_LIMIT;
+Uint32          Outbox::s_Cursor = 0;
+Uint32          Outbox::s_Dropped = 0;
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::Push(Int32 id, Int32 priority, Uint32 key, Int32 type, Uint32 option, CSStr data, Uint32 size)
+{
+    // Allocate the queues on first use
+    if (s_Queues.empty())
+    {
+        s_Queues.resize(SQMOD_PLAYER_POOL);
+    }
+    // Grab the queue of this player
+    Queue & queue = s_Queues[static_cast< Uint32 >(id)];
+    // Does this message replace one that was not delivered yet?
+    if (key)
+    {
+        for (Queue::iterator itr = queue.begin(); itr != queue.end(); ++itr)
+        {
+            if (itr->mKey == key && itr->mType == type)
+            {
+                // Only the contents change if the priority is the same
+                if (itr->mPriority == priority)
+                {
+                    itr->mOption = option;
+                    itr->mData.assign(data, size);
+                    return true;
+                }
+                // Otherwise the old message goes away and the new one is inserted normally
+                queue.erase(itr), --s_Count;
+                break;
+            }
+        }
+    }
+    // Is there room for another message?
+    if (queue.size() >= s_Limit)
+    {
+        ++s_Dropped;
+        return false;
+    }
+    // Find the position after the messages with the same or higher priority
+    Queue::iterator pos = std::upper_bound(queue.begin(), queue.end(), priority,
+        [](Int32 p, const Pending & msg) -> bool {
+            return p > msg.mPriority;
+        });
+    // Insert the message at that position
+    pos = queue.insert(pos, Pending());
+    pos->mPriority = priority;
+    pos->mKey = key;
+    pos->mType = type;
+    pos->mOption = option;
+    pos->mData.assign(data, size);
+    // One more message to deliver
+    ++s_Count;
+    // The message was queued
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::Deliver(Int32 id, const Pending & msg)
+{
+    vcmpError result = vcmpErrorNone;
+    // Send the message according to its type
+    switch (msg.mType)
+    {
+        case SQMOD_OUTBOX_MESSAGE:
+            result = _Func->SendClientMessage(id, msg.mOption, "%s", msg.mData.c_str());
+        break;
+        case SQMOD_OUTBOX_ANNOUNCE:
+            result = _Func->SendGameMessage(id, static_cast< Int32 >(msg.mOption), "%s", msg.mData.c_str());
+        break;
+        case SQMOD_OUTBOX_DATA:
+            result = _Func->SendClientScriptData(id, msg.mData.data(), msg.mData.size());
+        break;
+        default: break;
+    }
+    // Scripts are no longer around to catch errors at this point
+    if (result != vcmpErrorNone)
+    {
+        LogWrn("Unable to deliver queued message of type %d to player %d: error %d",
+                msg.mType, id, static_cast< Int32 >(result));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::Msg(CPlayer & player, Int32 priority, Uint32 key, const Color4 & color, const StackStrF & msg)
+{
+    player.Validate();
+    // Generate the final message now so that the prefixes at this time are used
+    String str(player.mMessagePrefix);
+    str.append(msg.mPtr, ClampMin(msg.mLen, 0)).append(player.mMessagePostfix);
+    // Queue the message
+    return Push(player.GetID(), priority, key, SQMOD_OUTBOX_MESSAGE, color.GetRGBA(),
+                str.c_str(), static_cast< Uint32 >(str.size()));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::Message(CPlayer & player, Int32 priority, Uint32 key, const StackStrF & msg)
+{
+    player.Validate();
+    // Generate the final message now so that the prefixes at this time are used
+    String str(player.mMessagePrefix);
+    str.append(msg.mPtr, ClampMin(msg.mLen, 0)).append(player.mMessagePostfix);
+    // Queue the message
+    return Push(player.GetID(), priority, key, SQMOD_OUTBOX_MESSAGE, player.mMessageColor,
+                str.c_str(), static_cast< Uint32 >(str.size()));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::Announce(CPlayer & player, Int32 priority, Uint32 key, const StackStrF & msg)
+{
+    player.Validate();
+    // Forward the call with the default style of the player
+    return AnnounceEx(player, priority, key, player.mAnnounceStyle, msg);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::AnnounceEx(CPlayer & player, Int32 priority, Uint32 key, Int32 style, const StackStrF & msg)
+{
+    player.Validate();
+    // Generate the final announcement now so that the prefixes at this time are used
+    String str(player.mAnnouncePrefix);
+    str.append(msg.mPtr, ClampMin(msg.mLen, 0)).append(player.mAnnouncePostfix);
+    // Queue the announcement
+    return Push(player.GetID(), priority, key, SQMOD_OUTBOX_ANNOUNCE, static_cast< Uint32 >(style),
+                str.c_str(), static_cast< Uint32 >(str.size()));
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Outbox::Data(CPlayer & player, Int32 priority, Uint32 key, const SqBuffer & buffer)
+{
+    player.Validate();
+    // Validate the specified buffer
+    buffer.ValidateDeeper();
+    // Validate the buffer cursor
+    if (!buffer.GetRef()->Position())
+    {
+        STHROWF("Cannot send empty stream buffer");
+    }
+    // Queue a copy of the written data
+    return Push(player.GetID(), priority, key, SQMOD_OUTBOX_DATA, 0,
+                buffer.GetRef()->Data(), buffer.GetRef()->Position());
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Outbox::GetPending(CPlayer & player)
+{
+    player.Validate();
+    // Are there any queues?
+    if (s_Queues.empty())
+    {
+        return 0;
+    }
+    // Return the size of the player queue
+    return static_cast< SQInteger >(s_Queues[static_cast< Uint32 >(player.GetID())].size());
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::Discard(CPlayer & player)
+{
+    player.Validate();
+    // Forward the call to the actual implementation
+    Drop(player.GetID());
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::Drop(Int32 id)
+{
+    // Is there anything to drop?
+    if (s_Queues.empty() || INVALID_ENTITYEX(id, SQMOD_PLAYER_POOL))
+    {
+        return;
+    }
+    Queue & queue = s_Queues[static_cast< Uint32 >(id)];
+    // Forget the queued messages
+    s_Count -= static_cast< Uint32 >(queue.size());
+    queue.clear();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::SetRate(SQInteger rate)
+{
+    if (rate < 1)
+    {
+        STHROWF("Invalid outbox rate: %lld", static_cast< Int64 >(rate));
+    }
+    s_Rate = ConvTo< Uint32 >::From(rate);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::SetBudget(SQInteger budget)
+{
+    if (budget < 0)
+    {
+        STHROWF("Invalid outbox budget: %lld", static_cast< Int64 >(budget));
+    }
+    s_Budget = ConvTo< Uint32 >::From(budget);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::SetLimit(SQInteger limit)
+{
+    if (limit < 1)
+    {
+        STHROWF("Invalid outbox limit: %lld", static_cast< Int64 >(limit));
+    }
+    s_Limit = ConvTo< Uint32 >::From(limit);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::Process()
+{
+    // Is there anything to deliver?
+    if (!s_Count)
+    {
+        return;
+    }
+    // The number of messages that can still be delivered in this frame
+    Uint32 budget = s_Budget ? s_Budget : s_Count;
+    // Serve the players starting from a different one each frame
+    for (Uint32 n = 0; n < SQMOD_PLAYER_POOL && budget; ++n)
+    {
+        const Uint32 id = (s_Cursor + n) % SQMOD_PLAYER_POOL;
+        // Grab the queue of this player
+        Queue & queue = s_Queues[id];
+        // Deliver the messages allowed for this player
+        for (Uint32 sent = 0; sent < s_Rate && budget && !queue.empty(); ++sent, --budget)
+        {
+            // Remove the message before delivery in case the player disconnects
+            Pending msg(std::move(queue.front()));
+            queue.pop_front();
+            --s_Count;
+            // Deliver the message
+            Deliver(static_cast< Int32 >(id), msg);
+        }
+    }
+    // Start with the next player in the next frame
+    s_Cursor = (s_Cursor + 1) % SQMOD_PLAYER_POOL;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Outbox::Terminate()
+{
+    s_Queues.clear();
+    s_Count = 0;
+    s_Cursor = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to deliver the queued messages.
+*/
+void ProcessOutbox()
+{
+    Outbox::Process();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to discard the messages of a player.
+*/
+void DropOutbox(Int32 id)
+{
+    Outbox::Drop(id);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate the outbox.
+*/
+void TerminateOutbox()
+{
+    Outbox::Terminate();
+}
+
+// ================================================================================================
+void Register_Outbox(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqOutbox"), Table(vm)
+        .FmtFunc(_SC("Msg"), &Outbox::Msg)
+        .FmtFunc(_SC("Message"), &Outbox::Message)
+        .FmtFunc(_SC("Announce"), &Outbox::Announce)
+        .FmtFunc(_SC("AnnounceEx"), &Outbox::AnnounceEx)
+        .Func(_SC("Data"), &Outbox::Data)
+        .Func(_SC("GetPending"), &Outbox::GetPending)
+        .Func(_SC("Discard"), &Outbox::Discard)
+        .Func(_SC("GetCount"), &Outbox::GetCount)
+        .Func(_SC("GetDropped"), &Outbox::GetDropped)
+        .Func(_SC("GetRate"), &Outbox::GetRate)
+        .Func(_SC("SetRate"), &Outbox::SetRate)
+        .Func(_SC("GetBudget"), &Outbox::GetBudget)
+        .Func(_SC("SetBudget"), &Outbox::SetBudget)
+        .Func(_SC("GetLimit"), &Outbox::GetLimit)
+        .Func(_SC("SetLimit"), &Outbox::SetLimit)
+    );
+}
+
+} // Namespace:: SqMod
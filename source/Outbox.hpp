@@ -0,0 +1,181 @@
+#ifndef _OUTBOX_HPP_
+#define _OUTBOX_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Base/Color4.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <deque>
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+class CPlayer;
+class SqBuffer;
+
+/* ------------------------------------------------------------------------------------------------
+ * The kind of data waiting to be delivered to a player.
+*/
+enum OutboxType
+{
+    SQMOD_OUTBOX_MESSAGE = 0,
+    SQMOD_OUTBOX_ANNOUNCE,
+    SQMOD_OUTBOX_DATA
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Queue client messages, announcements and script data per player and deliver them over frames.
+*/
+class Outbox
+{
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure that holds a queued message until it is delivered.
+    */
+    struct Pending
+    {
+        Int32       mPriority; // Messages with a higher priority are delivered first.
+        Uint32      mKey; // Queued messages with the same key and type are replaced.
+        Int32       mType; // The kind of message.
+        Uint32      mOption; // The color of a client message or the style of an announcement.
+        String      mData; // The text or the bytes to deliver.
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::deque< Pending >   Queue; // Queued messages of a player in delivery order.
+    typedef std::vector< Queue >    Queues; // Queued messages of every player.
+
+    // --------------------------------------------------------------------------------------------
+    static Queues   s_Queues; // The queued messages of each player.
+    static Uint32   s_Count; // The total number of queued messages.
+    static Uint32   s_Rate; // Maximum number of messages to deliver to a player in a frame.
+    static Uint32   s_Budget; // Maximum number of messages to deliver in a frame.
+    static Uint32   s_Limit; // Maximum number of messages queued for a player.
+    static Uint32   s_Cursor; // The player that gets served first in the next frame.
+    static Uint32   s_Dropped; // The number of messages rejected because a queue was full.
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue a message for the specified player. Returns false if the queue was full.
+    */
+    static bool Push(Int32 id, Int32 priority, Uint32 key, Int32 type, Uint32 option, CSStr data, Uint32 size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Deliver a message to the specified player.
+    */
+    static void Deliver(Int32 id, const Pending & msg);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue a client message with the specified color.
+    */
+    static bool Msg(CPlayer & player, Int32 priority, Uint32 key, const Color4 & color, const StackStrF & msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue a client message with the default color of the player.
+    */
+    static bool Message(CPlayer & player, Int32 priority, Uint32 key, const StackStrF & msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue an announcement with the default style of the player.
+    */
+    static bool Announce(CPlayer & player, Int32 priority, Uint32 key, const StackStrF & msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue an announcement with the specified style.
+    */
+    static bool AnnounceEx(CPlayer & player, Int32 priority, Uint32 key, Int32 style, const StackStrF & msg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Queue the contents of a stream buffer as client script data.
+    */
+    static bool Data(CPlayer & player, Int32 priority, Uint32 key, const SqBuffer & buffer);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of messages queued for a player.
+    */
+    static SQInteger GetPending(CPlayer & player);
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the messages queued for a player.
+    */
+    static void Discard(CPlayer & player);
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the messages queued for the specified player identifier.
+    */
+    static void Drop(Int32 id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the total number of queued messages.
+    */
+    static SQInteger GetCount()
+    {
+        return static_cast< SQInteger >(s_Count);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of messages rejected because a queue was full.
+    */
+    static SQInteger GetDropped()
+    {
+        return static_cast< SQInteger >(s_Dropped);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of messages to deliver to a player in a frame.
+    */
+    static SQInteger GetRate()
+    {
+        return static_cast< SQInteger >(s_Rate);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of messages to deliver to a player in a frame.
+    */
+    static void SetRate(SQInteger rate);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of messages to deliver in a frame.
+    */
+    static SQInteger GetBudget()
+    {
+        return static_cast< SQInteger >(s_Budget);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of messages to deliver in a frame. Zero means unlimited.
+    */
+    static void SetBudget(SQInteger budget);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of messages queued for a player.
+    */
+    static SQInteger GetLimit()
+    {
+        return static_cast< SQInteger >(s_Limit);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of messages queued for a player.
+    */
+    static void SetLimit(SQInteger limit);
+
+    /* --------------------------------------------------------------------------------------------
+     * Deliver the queued messages allowed in this frame.
+    */
+    static void Process();
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard all queued messages.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _OUTBOX_HPP_
@@ -0,0 +1,481 @@
+// ------------------------------------------------------------------------------------------------
+#include "Path.hpp"
+#include "Core.hpp"
+#include "Signal.hpp"
+#include "Logger.hpp"
+#include "Entity/Object.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMODE_DECL_TYPENAME(Typename, _SC("SqPath"))
+
+// ------------------------------------------------------------------------------------------------
+Path::Paths Path::s_Paths;
+
+/* ------------------------------------------------------------------------------------------------
+ * Apply an easing function to the specified progress.
+*/
+static Float32 ApplyEasing(Int32 easing, Float32 t)
+{
+    switch (easing)
+    {
+        case SQMOD_PATH_EASE_IN:        return t * t;
+        case SQMOD_PATH_EASE_OUT:       return t * (2.0f - t);
+        case SQMOD_PATH_EASE_IN_OUT:    return (t < 0.5f) ? (2.0f * t * t) : (-1.0f + (4.0f - 2.0f * t) * t);
+        default:                        return t;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Path::Path(const LightObj & obj, CObject * inst)
+    : m_Waypoints(), m_Object(obj), m_Inst(inst)
+    , m_Mode(SQMOD_PATH_ONCE), m_Index(0), m_Direction(1)
+    , m_Step(0), m_Steps(0), m_Remaining(0.0f)
+    , m_FromPos(), m_FromRot(), m_Running(false)
+    , m_Tag(), m_Data(), m_Self(), m_Events()
+    , m_OnWaypoint(), m_OnFinish()
+{
+    /* ... */
+}
+
+// ------------------------------------------------------------------------------------------------
+Path::~Path()
+{
+    // Active paths keep a reference to themselves so this should not be necessary
+    if (!m_Self.IsNull())
+    {
+        Release();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Path::IsObjectValid() const
+{
+    return m_Inst && m_Inst->IsActive();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::BeginSegment()
+{
+    const Waypoint & wp = m_Waypoints[m_Index];
+    // Linear movement is handled by the server in a single step
+    if (wp.mEasing == SQMOD_PATH_LINEAR || wp.mDuration < SQMOD_PATH_EASE_STEPS)
+    {
+        m_Steps = 1;
+    }
+    // Eased movement is approximated with several linear steps
+    else
+    {
+        m_Steps = SQMOD_PATH_EASE_STEPS;
+    }
+    // Start with the first step
+    m_Step = 0;
+    IssueStep();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::IssueStep()
+{
+    const Waypoint & wp = m_Waypoints[m_Index];
+    // Duration of a single step
+    const Uint32 step = wp.mDuration / m_Steps;
+    // The last step receives whatever was left by the division
+    const Uint32 duration = (m_Step + 1 < m_Steps) ? step : (wp.mDuration - step * (m_Steps - 1));
+    // Where the object should be at the end of this step
+    const Float32 t = ApplyEasing(wp.mEasing, static_cast< Float32 >(m_Step + 1) / m_Steps);
+    // Compute the position and rotation at the end of this step
+    const Vector3 pos = (m_Step + 1 < m_Steps) ? m_FromPos + (wp.mPosition - m_FromPos) * t : wp.mPosition;
+    const Quaternion rot = (m_Step + 1 < m_Steps) ? m_FromRot.Slerp(wp.mRotation, t) : wp.mRotation;
+    // Let the server interpolate the object
+    _Func->MoveObjectTo(m_Inst->GetID(), pos.x, pos.y, pos.z, duration);
+    _Func->RotateObjectTo(m_Inst->GetID(), rot.x, rot.y, rot.z, rot.w, duration);
+    // Wait for the step to complete
+    m_Remaining += static_cast< Float32 >(duration);
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Path::NextWaypoint()
+{
+    const Waypoint & wp = m_Waypoints[m_Index];
+    // The next segment starts at the reached waypoint
+    m_FromPos = wp.mPosition;
+    m_FromRot = wp.mRotation;
+    // The index of the last waypoint
+    const Int32 last = static_cast< Int32 >(m_Waypoints.size()) - 1;
+    // Attempt to move in the current direction
+    Int32 next = m_Index + m_Direction;
+    // Did we go past either end of the path?
+    if (next < 0 || next > last)
+    {
+        switch (m_Mode)
+        {
+            case SQMOD_PATH_LOOP:
+            {
+                next = (m_Direction > 0) ? 0 : last;
+            } break;
+            case SQMOD_PATH_PINGPONG:
+            {
+                m_Direction = -m_Direction;
+                // A single waypoint has nowhere else to go
+                next = (last > 0) ? (m_Index + m_Direction) : 0;
+            } break;
+            default: return false;
+        }
+    }
+    // Travel to the selected waypoint
+    m_Index = next;
+    // There's somewhere else to go
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Advance(Float32 delta, Events & events)
+{
+    // Consume the elapsed time
+    m_Remaining -= delta;
+    // Number of waypoints reached in this frame
+    Waypoints::size_type reached = 0;
+    // Process all steps that completed in the meantime
+    while (m_Remaining <= 0.0f)
+    {
+        // Is there another step in this segment?
+        if (++m_Step < m_Steps)
+        {
+            IssueStep();
+            // Wait for this step to complete
+            continue;
+        }
+        // The waypoint was reached
+        events.emplace_back(this, m_Index);
+        // Is there anywhere else to go?
+        if (!NextWaypoint())
+        {
+            m_Running = false;
+            // The path has finished
+            events.emplace_back(this, -1);
+            break;
+        }
+        // Start the next segment
+        BeginSegment();
+        // Don't spin forever on waypoints without a duration
+        if (++reached >= m_Waypoints.size())
+        {
+            m_Remaining = std::max(m_Remaining, 0.0f);
+            break;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Release()
+{
+    // Take the self reference so the instance stays alive until the end of this function
+    LightObj self(std::move(m_Self));
+    // Remove the path from the list of active paths
+    s_Paths.erase(std::remove(s_Paths.begin(), s_Paths.end(), this), s_Paths.end());
+    // No longer animating
+    m_Running = false;
+    // Release the script resources
+    ResetSignalPair(m_OnWaypoint);
+    ResetSignalPair(m_OnFinish);
+    m_Events.Release();
+    m_Data.Release();
+    m_Object.Release();
+    m_Inst = nullptr;
+    // The instance may be destroyed when the self reference goes out of scope
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::SetMode(Int32 mode)
+{
+    // Validate the specified mode
+    if (mode < SQMOD_PATH_ONCE || mode > SQMOD_PATH_PINGPONG)
+    {
+        STHROWF("Invalid path mode: %d", mode);
+    }
+    // Apply the specified value
+    m_Mode = mode;
+}
+
+// ------------------------------------------------------------------------------------------------
+Path & Path::AddWaypointEx(const Vector3 & pos, const Quaternion & rot, Uint32 duration, Int32 easing)
+{
+    // Validate the path
+    Validate();
+    // Validate the specified easing
+    if (easing < SQMOD_PATH_LINEAR || easing >= SQMOD_PATH_EASE_MAX)
+    {
+        STHROWF("Invalid path easing: %d", easing);
+    }
+    // Append the waypoint
+    m_Waypoints.push_back({pos, rot, duration, easing});
+    // Allow chaining
+    return *this;
+}
+
+// ------------------------------------------------------------------------------------------------
+const Vector3 & Path::GetPosition(SQInteger index) const
+{
+    // Validate the specified index
+    if (index < 0 || static_cast< Uint64 >(index) >= m_Waypoints.size())
+    {
+        STHROWF("Waypoint index out of range: %lld >= %llu", static_cast< Int64 >(index),
+                static_cast< Uint64 >(m_Waypoints.size()));
+    }
+    // Return the requested information
+    return m_Waypoints[static_cast< size_t >(index)].mPosition;
+}
+
+// ------------------------------------------------------------------------------------------------
+const Quaternion & Path::GetRotation(SQInteger index) const
+{
+    // Validate the specified index
+    if (index < 0 || static_cast< Uint64 >(index) >= m_Waypoints.size())
+    {
+        STHROWF("Waypoint index out of range: %lld >= %llu", static_cast< Int64 >(index),
+                static_cast< Uint64 >(m_Waypoints.size()));
+    }
+    // Return the requested information
+    return m_Waypoints[static_cast< size_t >(index)].mRotation;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Clear()
+{
+    // Stop the animation
+    Stop();
+    // Remove the waypoints
+    m_Waypoints.clear();
+    m_Index = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::StartFrom(SQInteger index)
+{
+    // Validate the path
+    Validate();
+    // Validate the object
+    m_Inst->Validate();
+    // Validate the specified index
+    if (index < 0 || static_cast< Uint64 >(index) >= m_Waypoints.size())
+    {
+        STHROWF("Waypoint index out of range: %lld >= %llu", static_cast< Int64 >(index),
+                static_cast< Uint64 >(m_Waypoints.size()));
+    }
+    // The first segment starts where the object currently is
+    _Func->GetObjectPosition(m_Inst->GetID(), &m_FromPos.x, &m_FromPos.y, &m_FromPos.z);
+    _Func->GetObjectRotation(m_Inst->GetID(), &m_FromRot.x, &m_FromRot.y, &m_FromRot.z, &m_FromRot.w);
+    // Reset the animation state
+    m_Index = static_cast< Int32 >(index);
+    m_Direction = 1;
+    m_Remaining = 0.0f;
+    m_Running = true;
+    // Start travelling to the selected waypoint
+    BeginSegment();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Stop()
+{
+    // Validate the path
+    Validate();
+    // Is there anything to stop?
+    if (!m_Running)
+    {
+        return;
+    }
+    m_Running = false;
+    // Freeze the object where it currently is
+    if (IsObjectValid())
+    {
+        Vector3 pos;
+        Quaternion rot;
+        // Obtain the current transformation
+        _Func->GetObjectPosition(m_Inst->GetID(), &pos.x, &pos.y, &pos.z);
+        _Func->GetObjectRotation(m_Inst->GetID(), &rot.x, &rot.y, &rot.z, &rot.w);
+        // Cancel the pending interpolation
+        _Func->MoveObjectTo(m_Inst->GetID(), pos.x, pos.y, pos.z, 0);
+        _Func->RotateObjectTo(m_Inst->GetID(), rot.x, rot.y, rot.z, rot.w, 0);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Destroy()
+{
+    // Stop the animation
+    Stop();
+    // Release the path
+    Release();
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Path::Create(CObject & obj)
+{
+    // Validate the specified object
+    obj.Validate();
+    // Create the path instance
+    DeleteGuard< Path > dg(new Path(Core::Get().GetObject(obj.GetID()).mObj, &obj));
+    Path * path = dg.Get();
+    // Create the script object
+    LightObj inst(path);
+    // The instance is now managed by the script
+    dg.Release();
+    // Keep the path alive until it is destroyed
+    path->m_Self = inst;
+    // Create a new table on the stack
+    sq_newtableex(DefaultVM::Get(), 2);
+    // Grab the table object from the stack
+    path->m_Events = LightObj(-1, DefaultVM::Get());
+    // Pop the table object from the stack
+    sq_pop(DefaultVM::Get(), 1);
+    // Proceed to initializing the events
+    InitSignalPair(path->m_OnWaypoint, path->m_Events, "Waypoint");
+    InitSignalPair(path->m_OnFinish, path->m_Events, "Finish");
+    // Register the path
+    s_Paths.push_back(path);
+    // Return the script object
+    return inst;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Process(Float32 elapsed)
+{
+    // Is there anything to process?
+    if (s_Paths.empty())
+    {
+        return;
+    }
+    // Elapsed time in milliseconds
+    const Float32 delta = elapsed * 1000.0f;
+    // Queued events
+    Events events;
+    // Advance the running paths
+    for (Paths::size_type n = 0; n < s_Paths.size();)
+    {
+        Path * path = s_Paths[n];
+        // Was the animated object destroyed?
+        if (!path->IsObjectValid())
+        {
+            // This removes the path from the list
+            path->Release();
+            // Don't move to the next path
+            continue;
+        }
+        // Advance the animation, if running
+        else if (path->m_Running)
+        {
+            path->Advance(delta, events);
+        }
+        ++n;
+    }
+    // Emit the queued events
+    for (auto & e : events)
+    {
+        // Was the path destroyed in the meantime?
+        if (e.mPath->m_Self.IsNull())
+        {
+            continue;
+        }
+        // Don't let a failing event prevent the others
+        try
+        {
+            if (e.mIndex < 0)
+            {
+                (*e.mPath->m_OnFinish.first)();
+            }
+            else
+            {
+                (*e.mPath->m_OnWaypoint.first)(e.mIndex);
+            }
+        }
+        catch (const Sqrat::Exception & ex)
+        {
+            LogErr("Squirrel exception caught in path event");
+            Logger::Get().Debug("%s", ex.what());
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Path::Terminate()
+{
+    // Release the paths from the back to avoid shifting the list
+    while (!s_Paths.empty())
+    {
+        s_Paths.back()->Release();
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to process paths.
+*/
+void ProcessPaths(Float32 elapsed)
+{
+    Path::Process(elapsed);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate paths.
+*/
+void TerminatePaths()
+{
+    Path::Terminate();
+}
+
+// ================================================================================================
+void Register_Path(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(Typename::Str,
+        Class< Path, NoConstructor< Path > >(vm, Typename::Str)
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        .Func(_SC("_tostring"), &Path::ToString)
+        // Properties
+        .Prop(_SC("On"), &Path::GetEvents)
+        .Prop(_SC("Tag"), &Path::GetTag, &Path::SetTag)
+        .Prop(_SC("Data"), &Path::GetData, &Path::SetData)
+        .Prop(_SC("Active"), &Path::IsActive)
+        .Prop(_SC("Running"), &Path::IsRunning)
+        .Prop(_SC("Object"), &Path::GetObject)
+        .Prop(_SC("Mode"), &Path::GetMode, &Path::SetMode)
+        .Prop(_SC("Index"), &Path::GetIndex)
+        .Prop(_SC("Count"), &Path::GetCount)
+        // Member Methods
+        .FmtFunc(_SC("SetTag"), &Path::ApplyTag)
+        .Func(_SC("GetPosition"), &Path::GetPosition)
+        .Func(_SC("GetRotation"), &Path::GetRotation)
+        .Func(_SC("Clear"), &Path::Clear)
+        .Func(_SC("Start"), &Path::Start)
+        .Func(_SC("StartFrom"), &Path::StartFrom)
+        .Func(_SC("Stop"), &Path::Stop)
+        .Func(_SC("Destroy"), &Path::Destroy)
+        // Member Overloads
+        .Overload< Path & (Path::*)(const Vector3 &, const Quaternion &, Uint32) >
+            (_SC("Add"), &Path::AddWaypoint)
+        .Overload< Path & (Path::*)(const Vector3 &, const Quaternion &, Uint32, Int32) >
+            (_SC("Add"), &Path::AddWaypointEx)
+        // Static Functions
+        .StaticFunc(_SC("Create"), &Path::Create)
+        .StaticFunc(_SC("GetActive"), &Path::GetActive)
+    );
+
+    ConstTable(vm).Enum(_SC("SqPathMode"), Enumeration(vm)
+        .Const(_SC("Once"),                 SQMOD_PATH_ONCE)
+        .Const(_SC("Loop"),                 SQMOD_PATH_LOOP)
+        .Const(_SC("PingPong"),             SQMOD_PATH_PINGPONG)
+    );
+
+    ConstTable(vm).Enum(_SC("SqPathEasing"), Enumeration(vm)
+        .Const(_SC("Linear"),               SQMOD_PATH_LINEAR)
+        .Const(_SC("In"),                   SQMOD_PATH_EASE_IN)
+        .Const(_SC("Out"),                  SQMOD_PATH_EASE_OUT)
+        .Const(_SC("InOut"),                SQMOD_PATH_EASE_IN_OUT)
+    );
+}
+
+} // Namespace:: SqMod
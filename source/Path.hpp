@@ -0,0 +1,377 @@
+#ifndef _PATH_HPP_
+#define _PATH_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Base/Vector3.hpp"
+#include "Base/Quaternion.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+class CObject;
+
+/* ------------------------------------------------------------------------------------------------
+ * What happens when a path reaches the last waypoint.
+*/
+enum PathMode
+{
+    SQMOD_PATH_ONCE = 0,
+    SQMOD_PATH_LOOP,
+    SQMOD_PATH_PINGPONG
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * The easing function applied to the segment that ends at a waypoint.
+*/
+enum PathEasing
+{
+    SQMOD_PATH_LINEAR = 0,
+    SQMOD_PATH_EASE_IN,
+    SQMOD_PATH_EASE_OUT,
+    SQMOD_PATH_EASE_IN_OUT,
+    SQMOD_PATH_EASE_MAX
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Move and rotate an object through a sequence of waypoints without script intervention.
+*/
+class Path
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure that describes a point in the path and how to get there.
+    */
+    struct Waypoint
+    {
+        Vector3     mPosition; // The position of the object at this waypoint.
+        Quaternion  mRotation; // The rotation of the object at this waypoint.
+        Uint32      mDuration; // Milliseconds needed to reach this waypoint from the previous one.
+        Int32       mEasing; // The easing applied while travelling to this waypoint.
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef std::vector< Waypoint >     Waypoints; // List of waypoints.
+    typedef std::vector< Path * >       Paths; // List of path instances.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure used to queue the events produced while advancing the paths.
+    */
+    struct Reached
+    {
+        LightObj    mObj; // Strong reference to the path so that it survives the emitted signals.
+        Path *      mPath; // The path instance that produced the event.
+        Int32       mIndex; // The reached waypoint or -1 if the path finished.
+
+        /* ----------------------------------------------------------------------------------------
+         * Base constructor.
+        */
+        Reached(Path * path, Int32 index)
+            : mObj(path->m_Self), mPath(path), mIndex(index)
+        {
+            /* ... */
+        }
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Reached >      Events; // List of queued events.
+
+    // --------------------------------------------------------------------------------------------
+    static Paths    s_Paths; // List of all active paths.
+
+    // --------------------------------------------------------------------------------------------
+    Waypoints   m_Waypoints; // The waypoints of this path.
+    LightObj    m_Object; // The script object of the animated object.
+    CObject *   m_Inst; // The instance of the animated object.
+    Int32       m_Mode; // What happens when the last waypoint is reached.
+    Int32       m_Index; // The waypoint that the object is travelling to.
+    Int32       m_Direction; // The direction in which the waypoints are traversed.
+    Uint32      m_Step; // The current step within the segment.
+    Uint32      m_Steps; // The number of steps in the current segment.
+    Float32     m_Remaining; // Milliseconds remaining until the end of the current step.
+    Vector3     m_FromPos; // The position where the current segment started.
+    Quaternion  m_FromRot; // The rotation where the current segment started.
+    bool        m_Running; // Whether the path is currently animating the object.
+
+    // --------------------------------------------------------------------------------------------
+    String      m_Tag; // User tag associated with this instance.
+    LightObj    m_Data; // User data associated with this instance.
+    LightObj    m_Self; // Strong reference to the script object while the path is active.
+    LightObj    m_Events; // Table containing the emitted path events.
+
+    // --------------------------------------------------------------------------------------------
+    SignalPair  m_OnWaypoint;
+    SignalPair  m_OnFinish;
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    Path(const LightObj & obj, CObject * inst);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    Path(const Path & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    Path(Path && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    Path & operator = (const Path & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    Path & operator = (Path && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate the path and throw an error if it was destroyed.
+    */
+    void Validate() const
+    {
+        if (m_Self.IsNull())
+        {
+            STHROWF("Invalid path reference");
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the animated object still exists.
+    */
+    bool IsObjectValid() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Start travelling towards the current waypoint from the start of the segment.
+    */
+    void BeginSegment();
+
+    /* --------------------------------------------------------------------------------------------
+     * Issue the movement and rotation for the current step of the segment.
+    */
+    void IssueStep();
+
+    /* --------------------------------------------------------------------------------------------
+     * Select the next waypoint. Returns false if the path ended.
+    */
+    bool NextWaypoint();
+
+    /* --------------------------------------------------------------------------------------------
+     * Advance the animation by the specified amount of milliseconds.
+    */
+    void Advance(Float32 delta, Events & events);
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the script resources and detach the path.
+    */
+    void Release();
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~Path();
+
+    /* --------------------------------------------------------------------------------------------
+     * Used by the script engine to convert an instance of this type to a string.
+    */
+    const String & ToString() const
+    {
+        return m_Tag;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag.
+    */
+    const String & GetTag() const
+    {
+        return m_Tag;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user tag.
+    */
+    void SetTag(const StackStrF & tag)
+    {
+        m_Tag.assign(tag.mPtr, ClampMin(tag.mLen, 0));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user tag and return a reference to itself.
+    */
+    Path & ApplyTag(const StackStrF & tag)
+    {
+        SetTag(tag);
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user data.
+    */
+    LightObj & GetData()
+    {
+        return m_Data;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user data.
+    */
+    void SetData(LightObj & data)
+    {
+        m_Data = data;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the events table of this path.
+    */
+    LightObj & GetEvents() const
+    {
+        Validate();
+        // Return the associated event table
+        return const_cast< LightObj & >(m_Events);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the path is still active.
+    */
+    bool IsActive() const
+    {
+        return !m_Self.IsNull();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the path is currently animating the object.
+    */
+    bool IsRunning() const
+    {
+        return m_Running;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the animated object.
+    */
+    LightObj & GetObject()
+    {
+        return m_Object;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve what happens when the last waypoint is reached.
+    */
+    Int32 GetMode() const
+    {
+        return m_Mode;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify what happens when the last waypoint is reached.
+    */
+    void SetMode(Int32 mode);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the waypoint that the object is travelling to.
+    */
+    Int32 GetIndex() const
+    {
+        return m_Index;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of waypoints.
+    */
+    SQInteger GetCount() const
+    {
+        return static_cast< SQInteger >(m_Waypoints.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Append a waypoint to the path using linear movement.
+    */
+    Path & AddWaypoint(const Vector3 & pos, const Quaternion & rot, Uint32 duration)
+    {
+        return AddWaypointEx(pos, rot, duration, SQMOD_PATH_LINEAR);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Append a waypoint to the path using the specified easing.
+    */
+    Path & AddWaypointEx(const Vector3 & pos, const Quaternion & rot, Uint32 duration, Int32 easing);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the position of a waypoint.
+    */
+    const Vector3 & GetPosition(SQInteger index) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the rotation of a waypoint.
+    */
+    const Quaternion & GetRotation(SQInteger index) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove all waypoints and stop the animation.
+    */
+    void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Start animating the object from the first waypoint.
+    */
+    void Start()
+    {
+        StartFrom(0);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Start animating the object from the specified waypoint.
+    */
+    void StartFrom(SQInteger index);
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop animating the object where it currently is.
+    */
+    void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop the animation and deactivate the path.
+    */
+    void Destroy();
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a path for the specified object.
+    */
+    static LightObj Create(CObject & obj);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of active paths.
+    */
+    static SQInteger GetActive()
+    {
+        return static_cast< SQInteger >(s_Paths.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Advance all running paths by the specified amount of seconds.
+    */
+    static void Process(Float32 elapsed);
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all paths and script resources.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _PATH_HPP_
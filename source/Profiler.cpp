@@ -0,0 +1,265 @@
+// ------------------------------------------------------------------------------------------------
+#include "Profiler.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Profiler::Stacks            Profiler::s_Stacks;
+Profiler::Frames            Profiler::s_Frames;
+String                      Profiler::s_Stack;
+Uint64                      Profiler::s_Samples = 0;
+Uint32                      Profiler::s_Rate = SQMOD_PROFILER_RATE;
+Uint32                      Profiler::s_Depth = SQMOD_PROFILER_DEPTH;
+std::thread                 Profiler::s_Thread;
+std::mutex                  Profiler::s_Mutex;
+std::condition_variable     Profiler::s_Wake;
+std::atomic< bool >         Profiler::s_Running(false);
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Timer(HSQUIRRELVM vm, Uint32 rate)
+{
+    const std::chrono::microseconds period(1000000 / rate);
+    // Acquire the lock used to wait between the requests
+    std::unique_lock< std::mutex > lock(s_Mutex);
+    // Keep requesting samples until stopped
+    while (!s_Wake.wait_for(lock, period, [] { return !s_Running.load(); }))
+    {
+        // The virtual machine records the sample at the next call or loop iteration
+        sq_requestsample(vm);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Sample(HSQUIRRELVM vm, SQUserPointer /*up*/)
+{
+    SQStackInfos si;
+    // Collect the frames, starting with the one that is executing
+    s_Frames.clear();
+    for (SQInteger level = 0; s_Frames.size() < s_Depth && SQ_SUCCEEDED(sq_stackinfos(vm, level, &si)); ++level)
+    {
+        s_Frames.push_back(si);
+    }
+    // Was there anything executing?
+    if (s_Frames.empty())
+    {
+        return;
+    }
+    SQChar line[32];
+    // Write the frames starting with the outermost one
+    s_Stack.clear();
+    for (Frames::const_reverse_iterator itr = s_Frames.crbegin(); itr != s_Frames.crend(); ++itr)
+    {
+        if (!s_Stack.empty())
+        {
+            s_Stack.push_back(';');
+        }
+        s_Stack.append(itr->funcname ? itr->funcname : _SC("unknown"));
+        // Native functions have no line information
+        if (itr->line < 0)
+        {
+            s_Stack.append(_SC(" (native)"));
+        }
+        else
+        {
+            std::snprintf(line, sizeof(line), ":%lld)", static_cast< long long >(itr->line));
+            s_Stack.append(_SC(" (")).append(itr->source ? itr->source : _SC("unknown")).append(line);
+        }
+    }
+    // Aggregate the sample
+    ++s_Stacks[s_Stack];
+    ++s_Samples;
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Profiler::WriteStacks(CSStr path)
+{
+    // Is the specified path valid?
+    if (!path || *path == '\0')
+    {
+        STHROWF("Invalid or empty profile path");
+    }
+    // Attempt to open the file
+    std::FILE * fp = std::fopen(path, "w");
+    // Could the file be opened?
+    if (!fp)
+    {
+        STHROWF("Unable to open profile: %s", path);
+    }
+    // Write one line for each call stack
+    for (const auto & stack : s_Stacks)
+    {
+        std::fprintf(fp, "%s %llu\n", stack.first.c_str(), static_cast< unsigned long long >(stack.second));
+    }
+    // Close the file
+    std::fclose(fp);
+    // Return the number of written call stacks
+    return static_cast< SQInteger >(s_Stacks.size());
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Start()
+{
+    // Is the profiler already sampling?
+    if (s_Running.load())
+    {
+        STHROWF("The profiler is already running");
+    }
+    HSQUIRRELVM vm = DefaultVM::Get();
+    // Let the virtual machine know who records the samples
+    sq_setsamplehook(vm, &Sample, nullptr);
+    // Start requesting samples
+    s_Running.store(true);
+    s_Thread = std::thread(&Timer, vm, s_Rate);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Stop()
+{
+    // Is the profiler sampling?
+    if (!s_Running.load())
+    {
+        return;
+    }
+    // Wake the thread and wait for it to finish
+    {
+        std::lock_guard< std::mutex > lock(s_Mutex);
+        s_Running.store(false);
+    }
+    s_Wake.notify_all();
+    s_Thread.join();
+    // No more samples are recorded
+    sq_setsamplehook(DefaultVM::Get(), nullptr, nullptr);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Clear()
+{
+    s_Stacks.clear();
+    s_Samples = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::SetRate(SQInteger rate)
+{
+    if (rate < 1 || rate > 10000)
+    {
+        STHROWF("Invalid profiler rate: %lld", static_cast< Int64 >(rate));
+    }
+    s_Rate = ConvTo< Uint32 >::From(rate);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::SetDepth(SQInteger depth)
+{
+    if (depth < 1)
+    {
+        STHROWF("Invalid profiler depth: %lld", static_cast< Int64 >(depth));
+    }
+    s_Depth = ConvTo< Uint32 >::From(depth);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Command(CCStr message)
+{
+    // Skip leading white space
+    while (message && std::isspace(static_cast< unsigned char >(*message)))
+    {
+        ++message;
+    }
+    // Is there a command?
+    if (!message || *message == '\0')
+    {
+        STHROWF("Missing profiler command");
+    }
+    // Find where the command ends and the argument starts
+    CCStr arg = message;
+    while (*arg != '\0' && !std::isspace(static_cast< unsigned char >(*arg)))
+    {
+        ++arg;
+    }
+    const String cmd(message, arg);
+    while (std::isspace(static_cast< unsigned char >(*arg)))
+    {
+        ++arg;
+    }
+    // Execute the command
+    if (cmd == "start")
+    {
+        if (*arg != '\0')
+        {
+            SetRate(std::strtoll(arg, nullptr, 10));
+        }
+        Start();
+        LogInf("Profiler started with %u samples per second", s_Rate);
+    }
+    else if (cmd == "stop")
+    {
+        Stop();
+        LogInf("Profiler stopped with %llu samples", static_cast< unsigned long long >(s_Samples));
+    }
+    else if (cmd == "clear")
+    {
+        Clear();
+    }
+    else if (cmd == "dump")
+    {
+        const SQInteger count = WriteStacks(arg);
+        LogInf("Profiler wrote %lld call stacks to: %s", static_cast< long long >(count), arg);
+    }
+    else
+    {
+        STHROWF("Unknown profiler command: %s", cmd.c_str());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Profiler::Terminate()
+{
+    Stop();
+    Clear();
+    // Release the memory used while sampling
+    Frames().swap(s_Frames);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward a command received from another plug-in to the profiler.
+*/
+void ProfilerCommand(CCStr message)
+{
+    Profiler::Command(message);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate the profiler.
+*/
+void TerminateProfiler()
+{
+    Profiler::Terminate();
+}
+
+// ================================================================================================
+void Register_Profiler(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqProfiler"), Table(vm)
+        .Func(_SC("Start"), &Profiler::Start)
+        .Func(_SC("Stop"), &Profiler::Stop)
+        .Func(_SC("IsRunning"), &Profiler::IsRunning)
+        .Func(_SC("Clear"), &Profiler::Clear)
+        .Func(_SC("GetSamples"), &Profiler::GetSamples)
+        .Func(_SC("GetStacks"), &Profiler::GetStacks)
+        .Func(_SC("GetRate"), &Profiler::GetRate)
+        .Func(_SC("SetRate"), &Profiler::SetRate)
+        .Func(_SC("GetDepth"), &Profiler::GetDepth)
+        .Func(_SC("SetDepth"), &Profiler::SetDepth)
+        .FmtFunc(_SC("Dump"), &Profiler::Dump)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,151 @@
+#ifndef _PROFILER_HPP_
+#define _PROFILER_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+/* ------------------------------------------------------------------------------------------------
+ * Sample the call stack of the scripts at a fixed rate and aggregate the samples for flame graphs.
+*/
+class Profiler
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef std::unordered_map< String, Uint64 >    Stacks; // Number of samples by collapsed stack.
+
+private:
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< SQStackInfos >             Frames; // Frames of the sampled call stack.
+
+    // --------------------------------------------------------------------------------------------
+    static Stacks                   s_Stacks; // The aggregated samples.
+    static Frames                   s_Frames; // Frames of the call stack that is being sampled.
+    static String                   s_Stack; // The collapsed call stack that is being sampled.
+    static Uint64                   s_Samples; // The number of aggregated samples.
+    static Uint32                   s_Rate; // The number of samples requested each second.
+    static Uint32                   s_Depth; // Maximum number of frames recorded for a sample.
+    static std::thread              s_Thread; // The thread that requests the samples.
+    static std::mutex               s_Mutex; // Mutex used to wake the thread when stopping.
+    static std::condition_variable  s_Wake; // Condition used to wake the thread when stopping.
+    static std::atomic< bool >      s_Running; // Whether the samples are being requested.
+
+    /* --------------------------------------------------------------------------------------------
+     * Request samples from the virtual machine until stopped.
+    */
+    static void Timer(HSQUIRRELVM vm, Uint32 rate);
+
+    /* --------------------------------------------------------------------------------------------
+     * Record the call stack of the virtual machine. Called by the virtual machine when requested.
+    */
+    static void Sample(HSQUIRRELVM vm, SQUserPointer up);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the aggregated samples to the specified file.
+    */
+    static SQInteger WriteStacks(CSStr path);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Start sampling with the current rate.
+    */
+    static void Start();
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop sampling. The aggregated samples are kept.
+    */
+    static void Stop();
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the profiler is sampling.
+    */
+    static bool IsRunning()
+    {
+        return s_Running.load();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Discard the aggregated samples.
+    */
+    static void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of aggregated samples.
+    */
+    static SQInteger GetSamples()
+    {
+        return static_cast< SQInteger >(s_Samples);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of distinct call stacks.
+    */
+    static SQInteger GetStacks()
+    {
+        return static_cast< SQInteger >(s_Stacks.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of samples requested each second.
+    */
+    static SQInteger GetRate()
+    {
+        return static_cast< SQInteger >(s_Rate);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the number of samples requested each second. Applies the next time it starts.
+    */
+    static void SetRate(SQInteger rate);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of frames recorded for a sample.
+    */
+    static SQInteger GetDepth()
+    {
+        return static_cast< SQInteger >(s_Depth);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of frames recorded for a sample.
+    */
+    static void SetDepth(SQInteger depth);
+
+    /* --------------------------------------------------------------------------------------------
+     * Write the aggregated samples to a file in the collapsed stack format used by flame graphs.
+     * Returns the number of written call stacks.
+    */
+    static SQInteger Dump(const StackStrF & path)
+    {
+        return WriteStacks(path.mPtr);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Execute a command received from another plug-in. (start [rate], stop, clear, dump <path>)
+    */
+    static void Command(CCStr message);
+
+    /* --------------------------------------------------------------------------------------------
+     * Stop sampling and discard the aggregated samples.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _PROFILER_HPP_
@@ -49,6 +49,13 @@ extern void Register_Log(HSQUIRRELVM vm);
 extern void Register_Core(HSQUIRRELVM vm);
 extern void Register_Command(HSQUIRRELVM vm);
 extern void Register_Routine(HSQUIRRELVM vm);
+extern void Register_Zone(HSQUIRRELVM vm);
+extern void Register_Streamer(HSQUIRRELVM vm);
+extern void Register_Path(HSQUIRRELVM vm);
+extern void Register_Outbox(HSQUIRRELVM vm);
+extern void Register_Collector(HSQUIRRELVM vm);
+extern void Register_Memory(HSQUIRRELVM vm);
+extern void Register_Profiler(HSQUIRRELVM vm);
 extern void RegisterTask(HSQUIRRELVM vm);
 
 // ------------------------------------------------------------------------------------------------
@@ -92,6 +99,13 @@ bool RegisterAPI(HSQUIRRELVM vm)
     Register_Core(vm);
     Register_Command(vm);
     Register_Routine(vm);
+    Register_Zone(vm);
+    Register_Streamer(vm);
+    Register_Path(vm);
+    Register_Outbox(vm);
+    Register_Collector(vm);
+    Register_Memory(vm);
+    Register_Profiler(vm);
     RegisterTask(vm);
 
     Register_Misc(vm);
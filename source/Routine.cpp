@@ -72,6 +72,27 @@ void Routine::Deinitialize()
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+SQInteger Routine::DropSource(CSStr source)
+{
+    SQInteger count = 0;
+    // Look for routines that execute a function from this script
+    for (auto & r : s_Instances)
+    {
+        if (!r.mInst.IsNull() && IsFunctionFrom(r.mFunc.mObj, source))
+        {
+            // Stop processing this slot
+            s_Intervals[&r - s_Instances] = 0;
+            // Release the routine resources
+            r.Terminate();
+            // Count this routine
+            ++count;
+        }
+    }
+    // Return the number of terminated routines
+    return count;
+}
+
 // ------------------------------------------------------------------------------------------------
 SQInteger Routine::Create(HSQUIRRELVM vm)
 {
@@ -315,6 +315,11 @@ public:
     */
     static SQInteger Create(HSQUIRRELVM vm);
 
+    /* --------------------------------------------------------------------------------------------
+     * Terminate all routines with a function that was compiled from the specified script file.
+    */
+    static SQInteger DropSource(CSStr source);
+
 protected:
 
     /* --------------------------------------------------------------------------------------------
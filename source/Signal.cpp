@@ -277,6 +277,32 @@ template < class Slot > struct MatchFunc
     }
 };
 
+/* ------------------------------------------------------------------------------------------------
+ * Helper functor to locate slots with callbacks compiled from a specific script.
+*/
+template < class Slot > struct MatchSource
+{
+    // --------------------------------------------------------------------------------------------
+    CSStr mSource; // The script to search for.
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    MatchSource(CSStr s)
+        : mSource(s)
+    {
+        //...
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Function call operator.
+    */
+    inline bool operator () (const Slot & s) const
+    {
+        return IsFunctionFrom(s.mFuncRef, mSource);
+    }
+};
+
 /* ------------------------------------------------------------------------------------------------
  * See if a certain slot exists using the provided functor.
 */
@@ -685,6 +711,22 @@ void Signal::ClearSlots()
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+Signal::SizeType Signal::EliminateSource(CSStr source)
+{
+    // Make sure that there's at least one slot connected
+    if (m_Used == 0)
+    {
+        return 0;
+    }
+    // Forward the call to the actual function
+    const SizeType count = RemoveIf(MatchSource< Slot >(source), m_Slots, m_Slots + m_Used, m_Scope);
+    // Forget about the removed slots
+    m_Used -= count;
+    // Return the number of removed slots
+    return count;
+}
+
 // ------------------------------------------------------------------------------------------------
 SQInteger Signal::Connect(SignalWrapper & w)
 {
@@ -1624,6 +1666,24 @@ const LightObj & Signal::Fetch(const StackStrF & name)
     return slo;
 }
 
+// ------------------------------------------------------------------------------------------------
+SQInteger Signal::DropSource(CSStr source)
+{
+    SQInteger count = 0;
+    // Clean named signals
+    for (const auto & s : s_Signals)
+    {
+        count += s.second.first->EliminateSource(source);
+    }
+    // Clean anonymous signals (indexes because releasing a slot can destroy other signals)
+    for (FreeSignals::size_type i = 0; i < s_FreeSignals.size(); ++i)
+    {
+        count += s_FreeSignals[i]->EliminateSource(source);
+    }
+    // Return the number of removed slots
+    return count;
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Forward the call to terminate the signals.
 */
@@ -417,6 +417,11 @@ public:
         return (m_Used == 0);
     }
 
+    /* --------------------------------------------------------------------------------------------
+     * Remove all slots with a callback that was compiled from the specified script file.
+    */
+    SizeType EliminateSource(CSStr source);
+
 protected:
 
     /* --------------------------------------------------------------------------------------------
@@ -718,6 +723,11 @@ public:
     */
     static const LightObj & Fetch(const StackStrF & name);
 
+    /* --------------------------------------------------------------------------------------------
+     * Remove the slots of all signals with a callback that was compiled from the specified script.
+    */
+    static SQInteger DropSource(CSStr source);
+
     /* --------------------------------------------------------------------------------------------
      * Emit a signal from the module.
     */
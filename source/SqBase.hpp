@@ -412,6 +412,8 @@ enum EventType
     EVT_SERVEROPTION,
     EVT_SCRIPTRELOAD,
     EVT_SCRIPTLOADED,
+    EVT_SCRIPTRELOADING,
+    EVT_SCRIPTRELOADED,
     EVT_MAX
 };
 
@@ -641,8 +643,29 @@ enum EntityType
 #define SQMOD_MAX_TASKS             1024
 #define SQMOD_MAX_ROUTINES          1024
 #define SQMOD_MAX_CMD_ARGS          12
+#define SQMOD_CMD_HISTOGRAM         20
+#define SQMOD_LOG_RECORD_SIZE       256
+#define SQMOD_LOG_QUEUE_SIZE        4096
 #define SQMOD_PLAYER_MSG_PREFIXES   16
 #define SQMOD_PLAYER_TMP_BUFFER     128
+#define SQMOD_ZONE_CELL_SIZE        64.0f
+#define SQMOD_ZONE_MAX_CELLS        1024
+#define SQMOD_STREAMER_CELL_SIZE    128.0f
+#define SQMOD_STREAMER_IN_RANGE     200.0f
+#define SQMOD_STREAMER_OUT_RANGE    250.0f
+#define SQMOD_STREAMER_CHURN        32
+#define SQMOD_PATH_EASE_STEPS       8
+#define SQMOD_OUTBOX_RATE           2
+#define SQMOD_OUTBOX_BUDGET         64
+#define SQMOD_OUTBOX_LIMIT          256
+#define SQMOD_COLLECTOR_GROWTH      8192
+#define SQMOD_COLLECTOR_INTERVAL    60000
+#define SQMOD_COLLECTOR_BUDGET      2
+#define SQMOD_COLLECTOR_LOW_PLAYERS 4
+#define SQMOD_MEMORY_REPORT_SIZE    10
+#define SQMOD_MEMORY_NAME_DEPTH     2
+#define SQMOD_PROFILER_RATE         100
+#define SQMOD_PROFILER_DEPTH        64
 
 /* ------------------------------------------------------------------------------------------------
  * PLAYER ACTION IDENTIFIERS
@@ -0,0 +1,427 @@
+// ------------------------------------------------------------------------------------------------
+#include "Streamer.hpp"
+#include "Core.hpp"
+#include "Logger.hpp"
+#include "Entity/Object.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+Streamer::Definitions   Streamer::s_Definitions;
+Streamer::Indices       Streamer::s_Free;
+Streamer::Indices       Streamer::s_Live;
+Streamer::Candidates    Streamer::s_Pending;
+Streamer::Grid          Streamer::s_Grid;
+Float32                 Streamer::s_InRange = SQMOD_STREAMER_IN_RANGE;
+Float32                 Streamer::s_OutRange = SQMOD_STREAMER_OUT_RANGE;
+Uint32                  Streamer::s_Churn = SQMOD_STREAMER_CHURN;
+Uint32                  Streamer::s_Frame = 0;
+Uint32                  Streamer::s_Count = 0;
+bool                    Streamer::s_Suspended = false;
+Uint8                   Streamer::s_Processing = 0;
+
+// ------------------------------------------------------------------------------------------------
+Int64 Streamer::CellCoord(Float32 v)
+{
+    return static_cast< Int64 >(std::floor(v / SQMOD_STREAMER_CELL_SIZE));
+}
+
+// ------------------------------------------------------------------------------------------------
+Streamer::Definition & Streamer::GetValid(SQInteger handle)
+{
+    // Is the handle in range and used?
+    if (!IsValid(handle))
+    {
+        STHROWF("Invalid streamed object handle: %lld", static_cast< Int64 >(handle));
+    }
+    // Return the definition
+    return s_Definitions[static_cast< Uint32 >(handle)];
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Streamer::StreamIn(Uint32 index)
+{
+    // The creation events could add definitions and invalidate references
+    const Definition info = s_Definitions[index];
+    // Attempt to create the object
+    try
+    {
+        LightObj & obj = Core::Get().NewObject(info.mModel, info.mWorld,
+                                                info.mPosition.x, info.mPosition.y, info.mPosition.z,
+                                                info.mAlpha, SQMOD_CREATE_AUTOMATIC, NullLightObj());
+        Definition & def = s_Definitions[index];
+        // Obtain the instance that manages the object
+        sq_pushobject(DefaultVM::Get(), obj.mObj);
+        def.mInst = Var< CObject * >(DefaultVM::Get(), -1).value;
+        sq_pop(DefaultVM::Get(), 1);
+        // Was the object destroyed during the creation events?
+        if (!def.mInst || !def.mInst->IsActive())
+        {
+            def.mInst = nullptr;
+            // The object is not live
+            return true;
+        }
+        // Remember the live object
+        def.mID = def.mInst->GetID();
+        def.mObj = obj;
+        // Apply the rotation
+        _Func->RotateObjectTo(def.mID, def.mRotation.x, def.mRotation.y,
+                                def.mRotation.z, def.mRotation.w, 0);
+    }
+    catch (const Sqrat::Exception & e)
+    {
+        LogErr("Unable to stream in object [%u] because: %s", index, e.what());
+        // Stop creating objects for now
+        return false;
+    }
+    // Include it in the list of live definitions
+    s_Live.push_back(index);
+    // Creation succeeded
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::StreamOut(Uint32 index)
+{
+    Definition & def = s_Definitions[index];
+    // Take the live object from the definition
+    LightObj obj(std::move(def.mObj));
+    CObject * inst = def.mInst;
+    const Int32 id = def.mID;
+    // Forget about the live object
+    def.mID = -1;
+    def.mInst = nullptr;
+    // Is the object still managed by the same instance?
+    if (inst->GetID() == id)
+    {
+        Core::Get().DelObject(id, SQMOD_DESTROY_AUTOMATIC, NullLightObj());
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::DropLive(Uint32 index)
+{
+    Indices::iterator itr = std::find(s_Live.begin(), s_Live.end(), index);
+    // Is the definition live?
+    if (itr != s_Live.end())
+    {
+        *itr = s_Live.back();
+        s_Live.pop_back();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+SQInteger Streamer::Add(Int32 model, Int32 world, const Vector3 & pos, const Quaternion & rot, Int32 alpha)
+{
+    Uint32 index;
+    // Can we reuse a slot?
+    if (!s_Free.empty())
+    {
+        index = s_Free.back();
+        s_Free.pop_back();
+    }
+    else
+    {
+        index = static_cast< Uint32 >(s_Definitions.size());
+        s_Definitions.emplace_back();
+    }
+    Definition & def = s_Definitions[index];
+    // Assign the object information
+    def.mPosition = pos;
+    def.mRotation = rot;
+    def.mModel = model;
+    def.mWorld = world;
+    def.mAlpha = alpha;
+    def.mFrame = 0;
+    def.mQueued = 0;
+    def.mUsed = true;
+    // Insert it into the spatial hash
+    s_Grid[CellKey(CellCoord(pos.x), CellCoord(pos.y))].push_back(index);
+    // Count this definition
+    ++s_Count;
+    // Return the handle
+    return static_cast< SQInteger >(index);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::Remove(SQInteger handle)
+{
+    // The frame being processed still refers to this definition
+    if (s_Processing)
+    {
+        STHROWF("Cannot remove streamed objects while the streamer is processing");
+    }
+    const Uint32 index = static_cast< Uint32 >(handle);
+    // Delete the live object, if any
+    if (GetValid(handle).mInst)
+    {
+        DropLive(index);
+        StreamOut(index);
+    }
+    // The deletion events could add definitions and invalidate references
+    Definition & def = GetValid(handle);
+    // Remove it from the spatial hash
+    Grid::iterator cell = s_Grid.find(CellKey(CellCoord(def.mPosition.x), CellCoord(def.mPosition.y)));
+    // The cell should exist
+    if (cell != s_Grid.end())
+    {
+        cell->second.erase(std::remove(cell->second.begin(), cell->second.end(), index),
+                            cell->second.end());
+        // Don't keep empty cells around
+        if (cell->second.empty())
+        {
+            s_Grid.erase(cell);
+        }
+    }
+    // Release the slot
+    def = Definition();
+    s_Free.push_back(index);
+    --s_Count;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::Clear()
+{
+    // The frame being processed still refers to the definitions
+    if (s_Processing)
+    {
+        STHROWF("Cannot clear the streamer while it is processing");
+    }
+    Indices live;
+    // Take the live list in case the deletion events modify it
+    live.swap(s_Live);
+    // Delete the live objects
+    for (auto index : live)
+    {
+        StreamOut(index);
+    }
+    // Release everything else
+    Terminate();
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj & Streamer::GetObject(SQInteger handle)
+{
+    Definition & def = GetValid(handle);
+    // Return the live object, if any
+    return def.mInst ? def.mObj : NullLightObj();
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Streamer::IsLive(SQInteger handle)
+{
+    const Definition & def = GetValid(handle);
+    // See if the object exists and was not deleted by someone else
+    return def.mInst && def.mInst->GetID() == def.mID;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::SetRange(Float32 in, Float32 out)
+{
+    // The stream in range must be valid
+    if (!(in > 0.0f))
+    {
+        STHROWF("Invalid stream in range: %f", in);
+    }
+    // The stream out range must leave some room to avoid thrashing
+    else if (out < in)
+    {
+        STHROWF("Stream out range (%f) is smaller than stream in range (%f)", out, in);
+    }
+    // Apply the specified values
+    s_InRange = in;
+    s_OutRange = out;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::SetChurn(SQInteger churn)
+{
+    // We must be able to make progress
+    if (churn <= 0)
+    {
+        STHROWF("Invalid streamer churn: %lld", static_cast< Int64 >(churn));
+    }
+    // Apply the specified value
+    s_Churn = ConvTo< Uint32 >::From(churn);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::Process()
+{
+    // Is there anything to stream?
+    if (s_Suspended || (s_Count == 0 && s_Live.empty()))
+    {
+        return;
+    }
+    // Prevent the object events from releasing the definitions used by this frame
+    const BitGuardU8 bg(s_Processing, 1);
+    // Move to the next frame
+    ++s_Frame;
+    // Squared ranges to avoid computing the square root
+    const Float32 in = s_InRange * s_InRange, out = s_OutRange * s_OutRange;
+    // Number of cells to scan around each player
+    const Int64 span = static_cast< Int64 >(std::ceil(s_OutRange / SQMOD_STREAMER_CELL_SIZE));
+    // Start with an empty list of candidates
+    s_Pending.clear();
+    // Find the definitions within range of the connected players
+    for (const auto & player : Core::Get().GetPlayers())
+    {
+        if (INVALID_ENTITY(player.mID))
+        {
+            continue;
+        }
+        const Vector3 & pos = player.mLastPosition;
+        const Int32 world = _Func->GetPlayerWorld(player.mID);
+        // Cell where the player is located
+        const Int64 cx = CellCoord(pos.x), cy = CellCoord(pos.y);
+        // Scan the surrounding cells
+        for (Int64 x = cx - span; x <= cx + span; ++x)
+        {
+            for (Int64 y = cy - span; y <= cy + span; ++y)
+            {
+                Grid::const_iterator cell = s_Grid.find(CellKey(x, y));
+                // Is there anything in this cell?
+                if (cell == s_Grid.end())
+                {
+                    continue;
+                }
+                for (auto index : cell->second)
+                {
+                    Definition & def = s_Definitions[index];
+                    // Is the object in the same world?
+                    if (def.mWorld >= 0 && def.mWorld != world)
+                    {
+                        continue;
+                    }
+                    const Float32 dx = def.mPosition.x - pos.x;
+                    const Float32 dy = def.mPosition.y - pos.y;
+                    const Float32 dz = def.mPosition.z - pos.z;
+                    const Float32 dist = (dx * dx) + (dy * dy) + (dz * dz);
+                    // Is the object close enough to be kept?
+                    if (dist > out)
+                    {
+                        continue;
+                    }
+                    def.mFrame = s_Frame;
+                    // Is the object close enough to be created?
+                    if (dist <= in && !def.mInst && def.mQueued != s_Frame)
+                    {
+                        def.mQueued = s_Frame;
+                        s_Pending.emplace_back(index, dist);
+                    }
+                }
+            }
+        }
+    }
+    // Number of objects we are allowed to create or delete this frame
+    Uint32 budget = s_Churn;
+    // Delete the objects that are no longer within range of any player
+    for (Indices::size_type n = 0; n < s_Live.size();)
+    {
+        const Uint32 index = s_Live[n];
+        Definition & def = s_Definitions[index];
+        // Was the object deleted by someone else?
+        if (def.mInst->GetID() != def.mID)
+        {
+            def.mID = -1;
+            def.mInst = nullptr;
+            def.mObj.Release();
+        }
+        // Is the object still needed or did we reach the limit?
+        else if (def.mFrame == s_Frame || budget == 0)
+        {
+            ++n;
+            // Move to the next object
+            continue;
+        }
+        // Remove it from the live list
+        s_Live[n] = s_Live.back();
+        s_Live.pop_back();
+        // Delete the object if it still exists
+        if (s_Definitions[index].mInst)
+        {
+            StreamOut(index);
+            --budget;
+        }
+    }
+    // Is there anything to create and are we allowed to?
+    if (s_Pending.empty() || budget == 0)
+    {
+        return;
+    }
+    // Only sort as many candidates as we can create
+    const Candidates::size_type count = std::min< Candidates::size_type >(budget, s_Pending.size());
+    // Create the objects closest to the players first
+    std::partial_sort(s_Pending.begin(), s_Pending.begin() + count, s_Pending.end());
+    // Create the objects
+    for (Candidates::size_type n = 0; n < count; ++n)
+    {
+        const Definition & def = s_Definitions[s_Pending[n].mIndex];
+        // Was the definition removed or created during the events of a previous object?
+        if (!def.mUsed || def.mInst)
+        {
+            continue;
+        }
+        // Stop if the objects can no longer be created
+        if (!StreamIn(s_Pending[n].mIndex))
+        {
+            break;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Streamer::Terminate()
+{
+    s_Definitions.clear();
+    s_Free.clear();
+    s_Live.clear();
+    s_Pending.clear();
+    s_Grid.clear();
+    s_Count = 0;
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to process the streamer.
+*/
+void ProcessStreamer()
+{
+    Streamer::Process();
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate the streamer.
+*/
+void TerminateStreamer()
+{
+    Streamer::Terminate();
+}
+
+// ================================================================================================
+void Register_Streamer(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(_SC("SqStreamer"), Table(vm)
+        .Func(_SC("Add"), &Streamer::Add)
+        .Func(_SC("Remove"), &Streamer::Remove)
+        .Func(_SC("Clear"), &Streamer::Clear)
+        .Func(_SC("GetObject"), &Streamer::GetObject)
+        .Func(_SC("IsLive"), &Streamer::IsLive)
+        .Func(_SC("IsValid"), &Streamer::IsValid)
+        .Func(_SC("GetCount"), &Streamer::GetCount)
+        .Func(_SC("GetLive"), &Streamer::GetLive)
+        .Func(_SC("GetInRange"), &Streamer::GetInRange)
+        .Func(_SC("GetOutRange"), &Streamer::GetOutRange)
+        .Func(_SC("SetRange"), &Streamer::SetRange)
+        .Func(_SC("GetChurn"), &Streamer::GetChurn)
+        .Func(_SC("SetChurn"), &Streamer::SetChurn)
+        .Func(_SC("GetSuspended"), &Streamer::GetSuspended)
+        .Func(_SC("SetSuspended"), &Streamer::SetSuspended)
+    );
+}
+
+} // Namespace:: SqMod
@@ -0,0 +1,257 @@
+#ifndef _STREAMER_HPP_
+#define _STREAMER_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Base/Vector3.hpp"
+#include "Base/Quaternion.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <vector>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+class CObject;
+
+/* ------------------------------------------------------------------------------------------------
+ * Keep a large set of object definitions and create real objects only near the connected players.
+*/
+class Streamer
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef std::vector< Uint32 >                   Indices; // List of definition indexes.
+    typedef std::unordered_map< Int64, Indices >    Grid; // Definitions bucketed by cell.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure that holds the information needed to create a streamed object.
+    */
+    struct Definition
+    {
+        // ----------------------------------------------------------------------------------------
+        Vector3     mPosition; // The position where the object should be created.
+        Quaternion  mRotation; // The rotation that should be applied after creation.
+        Int32       mModel; // The model of the object.
+        Int32       mWorld; // The world in which the object exists.
+        Int32       mAlpha; // The alpha of the object.
+        Int32       mID; // The identifier of the live object or -1 if not streamed in.
+        CObject *   mInst; // The instance that manages the live object.
+        LightObj    mObj; // The script object of the live object.
+        Uint32      mFrame; // The last frame when the definition was within the stream out range.
+        Uint32      mQueued; // The last frame when the definition was queued for creation.
+        bool        mUsed; // Whether this slot holds a definition.
+
+        /* ----------------------------------------------------------------------------------------
+         * Default constructor.
+        */
+        Definition()
+            : mPosition(), mRotation(), mModel(-1), mWorld(-1), mAlpha(255)
+            , mID(-1), mInst(nullptr), mObj(), mFrame(0), mQueued(0), mUsed(false)
+        {
+            /* ... */
+        }
+    };
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure used to sort the definitions waiting to be streamed in by distance.
+    */
+    struct Candidate
+    {
+        Uint32      mIndex; // The index of the definition.
+        Float32     mDistance; // The squared distance to the closest player.
+
+        /* ----------------------------------------------------------------------------------------
+         * Base constructor.
+        */
+        Candidate(Uint32 index, Float32 distance)
+            : mIndex(index), mDistance(distance)
+        {
+            /* ... */
+        }
+
+        /* ----------------------------------------------------------------------------------------
+         * Less than comparison operator.
+        */
+        bool operator < (const Candidate & o) const
+        {
+            return mDistance < o.mDistance;
+        }
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Definition >   Definitions; // List of object definitions.
+    typedef std::vector< Candidate >    Candidates; // List of definitions waiting to be streamed in.
+
+    // --------------------------------------------------------------------------------------------
+    static Definitions  s_Definitions; // The object definitions. Handles are indexes in this list.
+    static Indices      s_Free; // Definition slots that can be reused.
+    static Indices      s_Live; // Definitions that currently have a live object.
+    static Candidates   s_Pending; // Definitions waiting to be streamed in.
+    static Grid         s_Grid; // Spatial hash of the definitions.
+    static Float32      s_InRange; // Distance at which objects are streamed in.
+    static Float32      s_OutRange; // Distance at which objects are streamed out.
+    static Uint32       s_Churn; // Maximum number of objects to create or delete in a frame.
+    static Uint32       s_Frame; // The number of processed frames.
+    static Uint32       s_Count; // The number of used definition slots.
+    static bool         s_Suspended; // Whether streaming is suspended.
+    static Uint8        s_Processing; // Non-zero while a frame is processed.
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the key of the cell that contains the specified coordinates.
+    */
+    static Int64 CellKey(Int64 x, Int64 y)
+    {
+        return static_cast< Int64 >((static_cast< Uint64 >(x) << 32) | static_cast< Uint32 >(y));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the cell coordinate of the specified world coordinate.
+    */
+    static Int64 CellCoord(Float32 v);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve a used definition from a script handle and throw an error if invalid.
+    */
+    static Definition & GetValid(SQInteger handle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Create the live object of a definition.
+    */
+    static bool StreamIn(Uint32 index);
+
+    /* --------------------------------------------------------------------------------------------
+     * Delete the live object of a definition.
+    */
+    static void StreamOut(Uint32 index);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a definition from the list of live definitions.
+    */
+    static void DropLive(Uint32 index);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Add an object definition and return the handle used to reference it.
+    */
+    static SQInteger Add(Int32 model, Int32 world, const Vector3 & pos, const Quaternion & rot, Int32 alpha);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove an object definition and delete its live object, if any. Not allowed from the object
+     * events of the streamer since the frame that is being processed still uses the definitions.
+    */
+    static void Remove(SQInteger handle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove all object definitions and delete their live objects. Not allowed from the object
+     * events of the streamer.
+    */
+    static void Clear();
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the live object of a definition or null if not streamed in.
+    */
+    static LightObj & GetObject(SQInteger handle);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a definition currently has a live object.
+    */
+    static bool IsLive(SQInteger handle);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether a handle references a valid definition.
+    */
+    static bool IsValid(SQInteger handle)
+    {
+        return (handle >= 0 && static_cast< Uint32 >(handle) < s_Definitions.size() &&
+                s_Definitions[static_cast< Uint32 >(handle)].mUsed);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of object definitions.
+    */
+    static SQInteger GetCount()
+    {
+        return static_cast< SQInteger >(s_Count);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of live objects.
+    */
+    static SQInteger GetLive()
+    {
+        return static_cast< SQInteger >(s_Live.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the distance at which objects are streamed in.
+    */
+    static Float32 GetInRange()
+    {
+        return s_InRange;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the distance at which objects are streamed out.
+    */
+    static Float32 GetOutRange()
+    {
+        return s_OutRange;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the distances at which objects are streamed in and out.
+    */
+    static void SetRange(Float32 in, Float32 out);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum number of objects to create or delete in a frame.
+    */
+    static SQInteger GetChurn()
+    {
+        return static_cast< SQInteger >(s_Churn);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the maximum number of objects to create or delete in a frame.
+    */
+    static void SetChurn(SQInteger churn);
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether streaming is suspended.
+    */
+    static bool GetSuspended()
+    {
+        return s_Suspended;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify whether streaming is suspended.
+    */
+    static void SetSuspended(bool toggle)
+    {
+        s_Suspended = toggle;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Stream objects in and out based on the position of the connected players.
+    */
+    static void Process();
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all definitions without deleting the live objects.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _STREAMER_HPP_
@@ -479,6 +479,26 @@ void Tasks::Cleanup(Int32 id, Int32 type)
     }
 }
 
+// ------------------------------------------------------------------------------------------------
+SQInteger Tasks::DropSource(CSStr source)
+{
+    SQInteger count = 0;
+    // Look for tasks that execute a function from this script
+    for (auto & t : s_Tasks)
+    {
+        if (VALID_ENTITY(t.mEntity) && IsFunctionFrom(t.mFunc.mObj, source))
+        {
+            t.Terminate();
+            // Also disable the timer
+            s_Intervals[&t - s_Tasks] = 0;
+            // Count this task
+            ++count;
+        }
+    }
+    // Return the number of terminated tasks
+    return count;
+}
+
 /* ------------------------------------------------------------------------------------------------
  * Forward the call to process tasks.
 */
@@ -519,4 +539,12 @@ void CleanupTasks(Int32 id, Int32 type)
     Tasks::Cleanup(id, type);
 }
 
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate the tasks that belong to a script file.
+*/
+SQInteger DropTaskSource(CSStr source)
+{
+    return Tasks::DropSource(source);
+}
+
 } // Namespace:: SqMod
@@ -385,6 +385,11 @@ public:
     */
     static void Cleanup(Int32 id, Int32 type);
 
+    /* --------------------------------------------------------------------------------------------
+     * Terminate all tasks with a function that was compiled from the specified script file.
+    */
+    static SQInteger DropSource(CSStr source);
+
     /* --------------------------------------------------------------------------------------------
      * Forwards calls to create tasks.
     */
@@ -0,0 +1,648 @@
+// ------------------------------------------------------------------------------------------------
+#include "Zone.hpp"
+#include "Core.hpp"
+#include "Signal.hpp"
+#include "Entity/Player.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <cmath>
+#include <algorithm>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+SQMODE_DECL_TYPENAME(Typename, _SC("SqZone"))
+
+// ------------------------------------------------------------------------------------------------
+Zone::Zones     Zone::s_Zones;
+Zone::Zones     Zone::s_Large;
+Zone::Grid      Zone::s_Grid;
+Zone::Zones     Zone::s_Inside[SQMOD_PLAYER_POOL];
+Float32         Zone::s_CellSize = SQMOD_ZONE_CELL_SIZE;
+
+// ------------------------------------------------------------------------------------------------
+Zone::Zone(Int32 shape, Int32 world)
+    : m_Shape(shape), m_World(world)
+    , m_Sphere(), m_AABB(), m_Circle(), m_Points()
+    , m_Min(), m_Max(), m_Members()
+    , m_Tag(), m_Data(), m_Self(), m_Events()
+    , m_OnEnter(), m_OnLeave()
+{
+    /* ... */
+}
+
+// ------------------------------------------------------------------------------------------------
+Zone::~Zone()
+{
+    // Active zones keep a reference to themselves so this should not be necessary
+    if (!m_Self.IsNull())
+    {
+        Release();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::ComputeBounds()
+{
+    switch (m_Shape)
+    {
+        case SQMOD_ZONE_SPHERE:
+        {
+            m_Min.SetVector2Ex(m_Sphere.pos.x - m_Sphere.rad, m_Sphere.pos.y - m_Sphere.rad);
+            m_Max.SetVector2Ex(m_Sphere.pos.x + m_Sphere.rad, m_Sphere.pos.y + m_Sphere.rad);
+        } break;
+        case SQMOD_ZONE_AABB:
+        {
+            m_Min.SetVector2Ex(m_AABB.min.x, m_AABB.min.y);
+            m_Max.SetVector2Ex(m_AABB.max.x, m_AABB.max.y);
+        } break;
+        case SQMOD_ZONE_CIRCLE:
+        {
+            m_Min.SetVector2Ex(m_Circle.pos.x - m_Circle.rad, m_Circle.pos.y - m_Circle.rad);
+            m_Max.SetVector2Ex(m_Circle.pos.x + m_Circle.rad, m_Circle.pos.y + m_Circle.rad);
+        } break;
+        case SQMOD_ZONE_POLYGON:
+        {
+            m_Min = m_Points.front();
+            m_Max = m_Points.front();
+            // Grow the bounds to include every vertex
+            for (const auto & p : m_Points)
+            {
+                m_Min.x = std::min(m_Min.x, p.x);
+                m_Min.y = std::min(m_Min.y, p.y);
+                m_Max.x = std::max(m_Max.x, p.x);
+                m_Max.y = std::max(m_Max.y, p.y);
+            }
+        } break;
+        default: STHROWF("Unknown zone shape: %d", m_Shape);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+Int64 Zone::CellKey(Float32 x, Float32 y)
+{
+    const Int64 cx = static_cast< Int64 >(std::floor(x / s_CellSize));
+    const Int64 cy = static_cast< Int64 >(std::floor(y / s_CellSize));
+    // Pack both cell coordinates into a single key
+    return CellKey(cx, cy);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::InsertCells()
+{
+    const Int64 xmin = static_cast< Int64 >(std::floor(m_Min.x / s_CellSize));
+    const Int64 ymin = static_cast< Int64 >(std::floor(m_Min.y / s_CellSize));
+    const Int64 xmax = static_cast< Int64 >(std::floor(m_Max.x / s_CellSize));
+    const Int64 ymax = static_cast< Int64 >(std::floor(m_Max.y / s_CellSize));
+    // Would this zone occupy too many cells?
+    if (((xmax - xmin + 1) * (ymax - ymin + 1)) > SQMOD_ZONE_MAX_CELLS)
+    {
+        s_Large.push_back(this);
+        // Large zones are always tested
+        return;
+    }
+    // Insert the zone into every cell it overlaps
+    for (Int64 x = xmin; x <= xmax; ++x)
+    {
+        for (Int64 y = ymin; y <= ymax; ++y)
+        {
+            s_Grid[CellKey(x, y)].push_back(this);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::RemoveCells()
+{
+    // Is this zone in the list of large zones?
+    Zones::iterator itr = std::find(s_Large.begin(), s_Large.end(), this);
+    // Remove it from there instead
+    if (itr != s_Large.end())
+    {
+        s_Large.erase(itr);
+        // Nothing else to remove
+        return;
+    }
+    const Int64 xmin = static_cast< Int64 >(std::floor(m_Min.x / s_CellSize));
+    const Int64 ymin = static_cast< Int64 >(std::floor(m_Min.y / s_CellSize));
+    const Int64 xmax = static_cast< Int64 >(std::floor(m_Max.x / s_CellSize));
+    const Int64 ymax = static_cast< Int64 >(std::floor(m_Max.y / s_CellSize));
+    // Remove the zone from every cell it overlaps
+    for (Int64 x = xmin; x <= xmax; ++x)
+    {
+        for (Int64 y = ymin; y <= ymax; ++y)
+        {
+            Grid::iterator cell = s_Grid.find(CellKey(x, y));
+            // Was this cell even created?
+            if (cell == s_Grid.end())
+            {
+                continue;
+            }
+            // Remove the zone from the cell
+            cell->second.erase(std::remove(cell->second.begin(), cell->second.end(), this),
+                                cell->second.end());
+            // Don't keep empty cells around
+            if (cell->second.empty())
+            {
+                s_Grid.erase(cell);
+            }
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Release()
+{
+    // Take the self reference so the instance stays alive until the end of this function
+    LightObj self(std::move(m_Self));
+    // Remove the zone from the list of active zones
+    s_Zones.erase(std::remove(s_Zones.begin(), s_Zones.end(), this), s_Zones.end());
+    // Remove the zone from the broad-phase
+    RemoveCells();
+    // Forget about the players inside
+    for (Int32 id = 0; id < SQMOD_PLAYER_POOL; ++id)
+    {
+        if (m_Members.test(id))
+        {
+            s_Inside[id].erase(std::remove(s_Inside[id].begin(), s_Inside[id].end(), this),
+                                s_Inside[id].end());
+        }
+    }
+    m_Members.reset();
+    // Release the script resources
+    ResetSignalPair(m_OnEnter);
+    ResetSignalPair(m_OnLeave);
+    m_Events.Release();
+    m_Data.Release();
+    // The instance may be destroyed when the self reference goes out of scope
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Zone::Activate(DeleteGuard< Zone > & dg)
+{
+    Zone * zone = dg.Get();
+    // Compute the area covered by the zone
+    zone->ComputeBounds();
+    // Create the script object
+    LightObj obj(zone);
+    // The instance is now managed by the script
+    dg.Release();
+    // Keep the zone alive until it is destroyed
+    zone->m_Self = obj;
+    // Create a new table on the stack
+    sq_newtableex(DefaultVM::Get(), 2);
+    // Grab the table object from the stack
+    zone->m_Events = LightObj(-1, DefaultVM::Get());
+    // Pop the table object from the stack
+    sq_pop(DefaultVM::Get(), 1);
+    // Proceed to initializing the events
+    InitSignalPair(zone->m_OnEnter, zone->m_Events, "Enter");
+    InitSignalPair(zone->m_OnLeave, zone->m_Events, "Leave");
+    // Register the zone
+    s_Zones.push_back(zone);
+    zone->InsertCells();
+    // Return the script object
+    return obj;
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Zone::Test(Int32 world, const Vector3 & pos) const
+{
+    // Is the point in the world of this zone?
+    if (m_World >= 0 && world != m_World)
+    {
+        return false;
+    }
+    // Is the point within the two-dimensional bounds?
+    else if (pos.x < m_Min.x || pos.x > m_Max.x || pos.y < m_Min.y || pos.y > m_Max.y)
+    {
+        return false;
+    }
+    // Perform the test specific to the shape
+    switch (m_Shape)
+    {
+        case SQMOD_ZONE_SPHERE:
+        {
+            const Float32 x = pos.x - m_Sphere.pos.x;
+            const Float32 y = pos.y - m_Sphere.pos.y;
+            const Float32 z = pos.z - m_Sphere.pos.z;
+            return ((x * x) + (y * y) + (z * z)) <= (m_Sphere.rad * m_Sphere.rad);
+        }
+        case SQMOD_ZONE_AABB:
+        {
+            return (pos.z >= m_AABB.min.z && pos.z <= m_AABB.max.z);
+        }
+        case SQMOD_ZONE_CIRCLE:
+        {
+            const Float32 x = pos.x - m_Circle.pos.x;
+            const Float32 y = pos.y - m_Circle.pos.y;
+            return ((x * x) + (y * y)) <= (m_Circle.rad * m_Circle.rad);
+        }
+        case SQMOD_ZONE_POLYGON:
+        {
+            bool inside = false;
+            // Cast a ray along the x axis and count the edges it crosses
+            for (Points::size_type i = 0, j = m_Points.size() - 1; i < m_Points.size(); j = i++)
+            {
+                const Vector2 & a = m_Points[i];
+                const Vector2 & b = m_Points[j];
+                // Does this edge cross the ray?
+                if (((a.y > pos.y) != (b.y > pos.y)) &&
+                    (pos.x < (b.x - a.x) * (pos.y - a.y) / (b.y - a.y) + a.x))
+                {
+                    inside = !inside;
+                }
+            }
+            return inside;
+        }
+        default: return false;
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+bool Zone::HasPlayer(CPlayer & player) const
+{
+    // Validate the specified player
+    player.Validate();
+    // Return the requested information
+    return m_Members.test(player.GetID());
+}
+
+// ------------------------------------------------------------------------------------------------
+Array Zone::GetPlayers() const
+{
+    // Allocate an array with an adequate size
+    Array arr(DefaultVM::Get(), m_Members.count());
+    // Index of the currently processed player
+    SQInteger index = 0;
+    // Populate the array with the players inside
+    for (Int32 id = 0; id < SQMOD_PLAYER_POOL; ++id)
+    {
+        if (m_Members.test(id))
+        {
+            arr.SetValue(index++, Core::Get().GetPlayer(id).mObj);
+        }
+    }
+    // Return the resulted array
+    return arr;
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::SetWorld(Int32 world)
+{
+    // Validate the zone
+    Validate();
+    // Apply the specified value
+    m_World = world;
+    // The players inside might have changed
+    Refresh();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Refresh()
+{
+    // Validate the zone
+    Validate();
+    // Process all connected players
+    for (const auto & player : Core::Get().GetPlayers())
+    {
+        if (INVALID_ENTITY(player.mID))
+        {
+            continue;
+        }
+        // Evaluate the membership of this player
+        const bool inside = Test(_Func->GetPlayerWorld(player.mID), player.mLastPosition);
+        // Did anything change?
+        if (inside == m_Members.test(player.mID))
+        {
+            continue;
+        }
+        Transitions transitions;
+        // Update the membership
+        if (inside)
+        {
+            m_Members.set(player.mID);
+            s_Inside[player.mID].push_back(this);
+        }
+        else
+        {
+            m_Members.reset(player.mID);
+            s_Inside[player.mID].erase(std::remove(s_Inside[player.mID].begin(),
+                                        s_Inside[player.mID].end(), this), s_Inside[player.mID].end());
+        }
+        transitions.emplace_back(this, inside);
+        // Emit the change
+        Emit(transitions, player.mID);
+        // The zone could have been destroyed by the emitted signals
+        if (m_Self.IsNull())
+        {
+            break;
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Destroy()
+{
+    // Validate the zone
+    Validate();
+    // Release the zone
+    Release();
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Zone::CreateSphere(Int32 world, const Sphere & sphere)
+{
+    DeleteGuard< Zone > dg(new Zone(SQMOD_ZONE_SPHERE, world));
+    // Assign the shape
+    dg.Get()->m_Sphere = sphere.Abs();
+    // Activate the zone
+    return Activate(dg);
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Zone::CreateAABB(Int32 world, const AABB & box)
+{
+    // Make sure the box is valid
+    if (!box.Defined())
+    {
+        STHROWF("Invalid bounding box for zone");
+    }
+    DeleteGuard< Zone > dg(new Zone(SQMOD_ZONE_AABB, world));
+    // Assign the shape
+    dg.Get()->m_AABB = box;
+    // Activate the zone
+    return Activate(dg);
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Zone::CreateCircle(Int32 world, const Circle & circle)
+{
+    DeleteGuard< Zone > dg(new Zone(SQMOD_ZONE_CIRCLE, world));
+    // Assign the shape
+    dg.Get()->m_Circle = circle.Abs();
+    // Activate the zone
+    return Activate(dg);
+}
+
+// ------------------------------------------------------------------------------------------------
+LightObj Zone::CreatePolygon(Int32 world, Array & points)
+{
+    // Make sure the points are in an array
+    if (points.IsNull() || points.GetType() != OT_ARRAY)
+    {
+        STHROWF("Expected an array of points for polygon zone");
+    }
+    // Attempt to retrieve the number of specified points
+    const Int32 count = ConvTo< Int32 >::From(points.Length());
+    // We need at least a triangle
+    if (count < 3)
+    {
+        STHROWF("Polygon zone requires at least 3 points, %d given", count);
+    }
+    DeleteGuard< Zone > dg(new Zone(SQMOD_ZONE_POLYGON, world));
+    // Allocate space for the vertices
+    dg.Get()->m_Points.resize(count);
+    // Attempt to get all points in one go
+    points.GetArray< Vector2 >(&(dg.Get()->m_Points[0]), count);
+    // Activate the zone
+    return Activate(dg);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::SetCellSize(Float32 size)
+{
+    // Make sure the size is valid
+    if (!(size >= 1.0f))
+    {
+        STHROWF("Invalid zone cell size: %f", size);
+    }
+    // Clear the broad-phase
+    s_Grid.clear();
+    s_Large.clear();
+    // Apply the specified value
+    s_CellSize = size;
+    // Insert the zones back with the new cell size
+    for (auto & zone : s_Zones)
+    {
+        zone->InsertCells();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+const LightObj & Zone::FindByTag(const StackStrF & tag)
+{
+    if (!tag.mPtr)
+    {
+        STHROWF("Invalid zone tag");
+    }
+    // Iterate the zone list
+    for (const auto & zone : s_Zones)
+    {
+        if (zone->m_Tag.compare(tag.mPtr) == 0)
+        {
+            return zone->m_Self; // Return this zone instance
+        }
+    }
+    // Unable to find such zone
+    return NullLightObj();
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Emit(Transitions & transitions, Int32 id)
+{
+    for (auto & t : transitions)
+    {
+        // Was the zone destroyed or did the membership change in the meantime?
+        if (t.mZone->m_Self.IsNull() || t.mZone->m_Members.test(id) != t.mEnter)
+        {
+            continue;
+        }
+        // Now emit the event
+        else if (t.mEnter)
+        {
+            (*t.mZone->m_OnEnter.first)(Core::Get().GetPlayer(id).mObj);
+            Core::Get().EmitZoneEnter(t.mObj, id);
+        }
+        else
+        {
+            (*t.mZone->m_OnLeave.first)(Core::Get().GetPlayer(id).mObj);
+            Core::Get().EmitZoneLeave(t.mObj, id);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Update(Int32 id, const Vector3 & pos)
+{
+    Zones & inside = s_Inside[id];
+    // Is there anything to update?
+    if (s_Zones.empty() && inside.empty())
+    {
+        return;
+    }
+    // Obtain the current world of the player
+    const Int32 world = _Func->GetPlayerWorld(id);
+    // Queued transitions
+    Transitions transitions;
+    // See if the player left any of the zones it was inside
+    for (Zones::size_type n = 0; n < inside.size();)
+    {
+        Zone * zone = inside[n];
+        // Is the player still inside?
+        if (zone->Test(world, pos))
+        {
+            ++n;
+            // Move to the next zone
+            continue;
+        }
+        // Update the membership
+        zone->m_Members.reset(id);
+        inside[n] = inside.back();
+        inside.pop_back();
+        // Queue the transition
+        transitions.emplace_back(zone, false);
+    }
+    // Zones from the cell where the player is located
+    Grid::iterator cell = s_Grid.find(CellKey(pos.x, pos.y));
+    // See if the player entered any of the nearby zones
+    if (cell != s_Grid.end())
+    {
+        for (auto & zone : cell->second)
+        {
+            if (!zone->m_Members.test(id) && zone->Test(world, pos))
+            {
+                zone->m_Members.set(id);
+                inside.push_back(zone);
+                transitions.emplace_back(zone, true);
+            }
+        }
+    }
+    // See if the player entered any of the large zones
+    for (auto & zone : s_Large)
+    {
+        if (!zone->m_Members.test(id) && zone->Test(world, pos))
+        {
+            zone->m_Members.set(id);
+            inside.push_back(zone);
+            transitions.emplace_back(zone, true);
+        }
+    }
+    // Emit the transitions, if any
+    if (!transitions.empty())
+    {
+        Emit(transitions, id);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Leave(Int32 id)
+{
+    Zones & inside = s_Inside[id];
+    // Is the player inside any zone?
+    if (inside.empty())
+    {
+        return;
+    }
+    // Queued transitions
+    Transitions transitions;
+    // Remove the player from all zones
+    for (auto & zone : inside)
+    {
+        zone->m_Members.reset(id);
+        transitions.emplace_back(zone, false);
+    }
+    inside.clear();
+    // Emit the transitions
+    Emit(transitions, id);
+}
+
+// ------------------------------------------------------------------------------------------------
+void Zone::Terminate()
+{
+    // Release the zones from the back to avoid shifting the list
+    while (!s_Zones.empty())
+    {
+        s_Zones.back()->Release();
+    }
+    // Make sure nothing is left behind
+    s_Grid.clear();
+    s_Large.clear();
+    for (auto & inside : s_Inside)
+    {
+        inside.clear();
+    }
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to update the zone membership of a player.
+*/
+void UpdateZones(Int32 id, const Vector3 & pos)
+{
+    Zone::Update(id, pos);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to remove a player from all zones.
+*/
+void LeaveZones(Int32 id)
+{
+    Zone::Leave(id);
+}
+
+/* ------------------------------------------------------------------------------------------------
+ * Forward the call to terminate zones.
+*/
+void TerminateZones()
+{
+    Zone::Terminate();
+}
+
+// ================================================================================================
+void Register_Zone(HSQUIRRELVM vm)
+{
+    RootTable(vm).Bind(Typename::Str,
+        Class< Zone, NoConstructor< Zone > >(vm, Typename::Str)
+        // Meta-methods
+        .SquirrelFunc(_SC("_typename"), &Typename::Fn)
+        .Func(_SC("_tostring"), &Zone::ToString)
+        // Properties
+        .Prop(_SC("On"), &Zone::GetEvents)
+        .Prop(_SC("Tag"), &Zone::GetTag, &Zone::SetTag)
+        .Prop(_SC("Data"), &Zone::GetData, &Zone::SetData)
+        .Prop(_SC("Active"), &Zone::IsActive)
+        .Prop(_SC("Shape"), &Zone::GetShape)
+        .Prop(_SC("World"), &Zone::GetWorld, &Zone::SetWorld)
+        .Prop(_SC("Count"), &Zone::GetCount)
+        .Prop(_SC("Min"), &Zone::GetMin)
+        .Prop(_SC("Max"), &Zone::GetMax)
+        .Prop(_SC("Players"), &Zone::GetPlayers)
+        // Member Methods
+        .FmtFunc(_SC("SetTag"), &Zone::ApplyTag)
+        .Func(_SC("Test"), &Zone::TestPoint)
+        .Func(_SC("TestEx"), &Zone::Test)
+        .Func(_SC("Has"), &Zone::HasPlayer)
+        .Func(_SC("Refresh"), &Zone::Refresh)
+        .Func(_SC("Destroy"), &Zone::Destroy)
+        // Static Functions
+        .StaticFunc(_SC("Sphere"), &Zone::CreateSphere)
+        .StaticFunc(_SC("AABB"), &Zone::CreateAABB)
+        .StaticFunc(_SC("Circle"), &Zone::CreateCircle)
+        .StaticFunc(_SC("Polygon"), &Zone::CreatePolygon)
+        .StaticFunc(_SC("GetActive"), &Zone::GetActive)
+        .StaticFunc(_SC("GetCellSize"), &Zone::GetCellSize)
+        .StaticFunc(_SC("SetCellSize"), &Zone::SetCellSize)
+        .StaticFmtFunc(_SC("FindByTag"), &Zone::FindByTag)
+    );
+
+    ConstTable(vm).Enum(_SC("SqZoneShape"), Enumeration(vm)
+        .Const(_SC("Unknown"),              SQMOD_ZONE_UNKNOWN)
+        .Const(_SC("Sphere"),               SQMOD_ZONE_SPHERE)
+        .Const(_SC("AABB"),                 SQMOD_ZONE_AABB)
+        .Const(_SC("Circle"),               SQMOD_ZONE_CIRCLE)
+        .Const(_SC("Polygon"),              SQMOD_ZONE_POLYGON)
+    );
+}
+
+} // Namespace:: SqMod
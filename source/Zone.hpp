@@ -0,0 +1,398 @@
+#ifndef _ZONE_HPP_
+#define _ZONE_HPP_
+
+// ------------------------------------------------------------------------------------------------
+#include "Base/Shared.hpp"
+#include "Base/AABB.hpp"
+#include "Base/Circle.hpp"
+#include "Base/Sphere.hpp"
+#include "Base/Vector2.hpp"
+#include "Base/Vector3.hpp"
+
+// ------------------------------------------------------------------------------------------------
+#include <bitset>
+#include <vector>
+#include <unordered_map>
+
+// ------------------------------------------------------------------------------------------------
+namespace SqMod {
+
+// ------------------------------------------------------------------------------------------------
+class CPlayer;
+
+/* ------------------------------------------------------------------------------------------------
+ * The type of shape used to describe the area covered by a zone.
+*/
+enum ZoneShape
+{
+    SQMOD_ZONE_UNKNOWN = 0,
+    SQMOD_ZONE_SPHERE,
+    SQMOD_ZONE_AABB,
+    SQMOD_ZONE_CIRCLE,
+    SQMOD_ZONE_POLYGON
+};
+
+/* ------------------------------------------------------------------------------------------------
+ * Area of the world which keeps track of the players inside and signals when they enter or leave.
+ * Circle and polygon zones are two-dimensional and extend infinitely on the z axis.
+*/
+class Zone
+{
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Simplify future changes to a single point of change.
+    */
+    typedef std::vector< Vector2 >                  Points; // Vertices of a polygon zone.
+    typedef std::bitset< SQMOD_PLAYER_POOL >        Members; // Players currently inside a zone.
+    typedef std::vector< Zone * >                   Zones; // List of zone instances.
+    typedef std::unordered_map< Int64, Zones >      Grid; // Zones bucketed by the cells they overlap.
+
+private:
+
+    /* --------------------------------------------------------------------------------------------
+     * Structure used to queue the transitions produced by a membership update.
+    */
+    struct Transition
+    {
+        LightObj    mObj; // Strong reference to the zone so that it survives the emitted signals.
+        Zone *      mZone; // The zone instance that the player entered or left.
+        bool        mEnter; // Whether the player entered or left the zone.
+
+        /* ----------------------------------------------------------------------------------------
+         * Base constructor.
+        */
+        Transition(Zone * zone, bool enter)
+            : mObj(zone->m_Self), mZone(zone), mEnter(enter)
+        {
+            /* ... */
+        }
+    };
+
+    // --------------------------------------------------------------------------------------------
+    typedef std::vector< Transition >               Transitions; // List of queued transitions.
+
+    // --------------------------------------------------------------------------------------------
+    static Zones    s_Zones; // List of all active zones.
+    static Zones    s_Large; // Active zones that cover too many cells to be stored in the grid.
+    static Grid     s_Grid; // Spatial hash used as a broad-phase for the membership tests.
+    static Zones    s_Inside[SQMOD_PLAYER_POOL]; // The zones each player is currently inside.
+    static Float32  s_CellSize; // The size of a grid cell in world units.
+
+    // --------------------------------------------------------------------------------------------
+    Int32       m_Shape; // The type of shape used by this zone.
+    Int32       m_World; // The world in which the zone exists or negative for all worlds.
+    Sphere      m_Sphere; // The area of a sphere zone.
+    AABB        m_AABB; // The area of a box zone.
+    Circle      m_Circle; // The area of a circle zone.
+    Points      m_Points; // The vertices of a polygon zone.
+    Vector2     m_Min; // The minimum point of the two-dimensional bounds of the zone.
+    Vector2     m_Max; // The maximum point of the two-dimensional bounds of the zone.
+    Members     m_Members; // The players currently inside this zone.
+
+    // --------------------------------------------------------------------------------------------
+    String      m_Tag; // User tag associated with this instance.
+    LightObj    m_Data; // User data associated with this instance.
+    LightObj    m_Self; // Strong reference to the script object while the zone is active.
+    LightObj    m_Events; // Table containing the emitted zone events.
+
+    // --------------------------------------------------------------------------------------------
+    SignalPair  m_OnEnter;
+    SignalPair  m_OnLeave;
+
+    /* --------------------------------------------------------------------------------------------
+     * Base constructor.
+    */
+    Zone(Int32 shape, Int32 world);
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy constructor. (disabled)
+    */
+    Zone(const Zone & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move constructor. (disabled)
+    */
+    Zone(Zone && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Copy assignment operator. (disabled)
+    */
+    Zone & operator = (const Zone & o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Move assignment operator. (disabled)
+    */
+    Zone & operator = (Zone && o) = delete;
+
+    /* --------------------------------------------------------------------------------------------
+     * Validate the zone and throw an error if it was destroyed.
+    */
+    void Validate() const
+    {
+        if (m_Self.IsNull())
+        {
+            STHROWF("Invalid zone reference");
+        }
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Compute the two-dimensional bounds of the zone from its shape.
+    */
+    void ComputeBounds();
+
+    /* --------------------------------------------------------------------------------------------
+     * Insert the zone into the spatial hash.
+    */
+    void InsertCells();
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove the zone from the spatial hash.
+    */
+    void RemoveCells();
+
+    /* --------------------------------------------------------------------------------------------
+     * Release the script resources and detach the zone without emitting any signals.
+    */
+    void Release();
+
+    /* --------------------------------------------------------------------------------------------
+     * Take ownership of a newly created zone and make it active.
+    */
+    static LightObj Activate(DeleteGuard< Zone > & dg);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the grid cell key for the specified coordinates.
+    */
+    static Int64 CellKey(Float32 x, Float32 y);
+
+    /* --------------------------------------------------------------------------------------------
+     * Pack the specified cell coordinates into a grid cell key.
+    */
+    static Int64 CellKey(Int64 x, Int64 y)
+    {
+        return static_cast< Int64 >((static_cast< Uint64 >(x) << 32) | static_cast< Uint32 >(y));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Emit the queued transitions for the specified player.
+    */
+    static void Emit(Transitions & transitions, Int32 id);
+
+public:
+
+    /* --------------------------------------------------------------------------------------------
+     * Destructor.
+    */
+    ~Zone();
+
+    /* --------------------------------------------------------------------------------------------
+     * Used by the script engine to convert an instance of this type to a string.
+    */
+    const String & ToString() const
+    {
+        return m_Tag;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user tag.
+    */
+    const String & GetTag() const
+    {
+        return m_Tag;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user tag.
+    */
+    void SetTag(const StackStrF & tag)
+    {
+        m_Tag.assign(tag.mPtr, ClampMin(tag.mLen, 0));
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user tag and return a reference to itself.
+    */
+    Zone & ApplyTag(const StackStrF & tag)
+    {
+        SetTag(tag);
+        return *this;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the associated user data.
+    */
+    LightObj & GetData()
+    {
+        return m_Data;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the associated user data.
+    */
+    void SetData(LightObj & data)
+    {
+        m_Data = data;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the events table of this zone.
+    */
+    LightObj & GetEvents() const
+    {
+        Validate();
+        // Return the associated event table
+        return const_cast< LightObj & >(m_Events);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the zone is still active.
+    */
+    bool IsActive() const
+    {
+        return !m_Self.IsNull();
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the type of shape used by this zone.
+    */
+    Int32 GetShape() const
+    {
+        return m_Shape;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the world in which the zone exists.
+    */
+    Int32 GetWorld() const
+    {
+        return m_World;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the world in which the zone exists and re-evaluate the membership.
+    */
+    void SetWorld(Int32 world);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of players currently inside the zone.
+    */
+    SQInteger GetCount() const
+    {
+        return static_cast< SQInteger >(m_Members.count());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the minimum point of the two-dimensional bounds.
+    */
+    const Vector2 & GetMin() const
+    {
+        return m_Min;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the maximum point of the two-dimensional bounds.
+    */
+    const Vector2 & GetMax() const
+    {
+        return m_Max;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified point in the specified world is inside the zone.
+    */
+    bool Test(Int32 world, const Vector3 & pos) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified point is inside the zone, regardless of the world.
+    */
+    bool TestPoint(const Vector3 & pos) const
+    {
+        return Test(m_World, pos);
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * See whether the specified player is currently considered inside the zone.
+    */
+    bool HasPlayer(CPlayer & player) const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the players currently inside the zone in an array.
+    */
+    Array GetPlayers() const;
+
+    /* --------------------------------------------------------------------------------------------
+     * Re-evaluate the membership of all connected players using their last known position.
+    */
+    void Refresh();
+
+    /* --------------------------------------------------------------------------------------------
+     * Deactivate the zone without emitting leave signals for the players inside.
+    */
+    void Destroy();
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a zone from a sphere.
+    */
+    static LightObj CreateSphere(Int32 world, const Sphere & sphere);
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a zone from an axis aligned bounding box.
+    */
+    static LightObj CreateAABB(Int32 world, const AABB & box);
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a zone from a circle on the x and y axes.
+    */
+    static LightObj CreateCircle(Int32 world, const Circle & circle);
+
+    /* --------------------------------------------------------------------------------------------
+     * Create a zone from an array of Vector2 points which describe a polygon on the x and y axes.
+    */
+    static LightObj CreatePolygon(Int32 world, Array & points);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the number of active zones.
+    */
+    static SQInteger GetActive()
+    {
+        return static_cast< SQInteger >(s_Zones.size());
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the size of a grid cell used by the broad-phase.
+    */
+    static Float32 GetCellSize()
+    {
+        return s_CellSize;
+    }
+
+    /* --------------------------------------------------------------------------------------------
+     * Modify the size of a grid cell used by the broad-phase and rebuild the grid.
+    */
+    static void SetCellSize(Float32 size);
+
+    /* --------------------------------------------------------------------------------------------
+     * Retrieve the first active zone with the specified tag.
+    */
+    static const LightObj & FindByTag(const StackStrF & tag);
+
+    /* --------------------------------------------------------------------------------------------
+     * Update the membership of a player after a change in position or world.
+    */
+    static void Update(Int32 id, const Vector3 & pos);
+
+    /* --------------------------------------------------------------------------------------------
+     * Remove a player from all zones and emit the leave signals.
+    */
+    static void Leave(Int32 id);
+
+    /* --------------------------------------------------------------------------------------------
+     * Release all zones and script resources.
+    */
+    static void Terminate();
+};
+
+} // Namespace:: SqMod
+
+#endif // _ZONE_HPP_